@@ -105,13 +105,22 @@ std::unique_ptr<AbstrCriterial> CriterialFunctionChange::clone() const {
 CriterialGradientNorm::CriterialGradientNorm(const AbstrOptim* opt, double eps)
     : AbstrCriterial(opt), epsilon(eps), first_call(true) {}
 
-bool CriterialGradientNorm::isSatisfied(const std::vector<double>& current_point, double, int) const {
+bool CriterialGradientNorm::isSatisfied(const std::vector<double>& current_point, double current_value, int) const {
     if (!optimizer || !optimizer->getFunc()) {
         return false;
     }
 
-    // Вычисляем градиент численно
-    auto grad = numericalGradient(*(optimizer->getFunc()), current_point);
+    // Точный градиент, если функция его предоставляет, иначе численный
+    const AbstrFunc& func = *(optimizer->getFunc());
+    std::vector<double> grad;
+    try {
+        grad = func.getGradient(current_point);
+    }
+    catch (...) {
+        // Значение в точке уже известно: прямым разностям хватает N вычислений
+        grad = finiteDifferenceGradient(func, current_point, current_value,
+            optimizer->getFiniteDifferenceOptions());
+    }
 
     double norm_sq = 0.0;
     for (double g : grad) {
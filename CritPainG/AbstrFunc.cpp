@@ -1,5 +1,9 @@
 ﻿#include "pch.h"
 #include "AbstrFunc.h"
+#include "FiniteDifference.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <string>
 
@@ -11,23 +15,126 @@
 #define M_E 2.71828182845904523536
 #endif
 
+namespace {
+
+// Глубина вложенных вычислений численного градиента в текущем потоке
+thread_local int numericalGradientDepth = 0;
+
+} // namespace
+
+NumericalGradientScope::NumericalGradientScope() {
+    ++numericalGradientDepth;
+}
+
+NumericalGradientScope::~NumericalGradientScope() {
+    --numericalGradientDepth;
+}
+
+bool insideNumericalGradient() {
+    return numericalGradientDepth > 0;
+}
+
 // Численное вычисление градиента 
 std::vector<double> numericalGradient(const AbstrFunc& func, const std::vector<double>& x, double h) {
-    std::vector<double> grad(x.size());
-    std::vector<double> x_plus = x;
+    FiniteDifferenceOptions options;
+    options.scheme = DifferenceScheme::Central;
+    options.step = h;
+    return finiteDifferenceGradient(func, x, options);
+}
+
+double AbstrFunc::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    grad = getGradient(x);
+    return (*this)(x);
+}
+
+void AbstrFunc::evaluateBatch(const double* points, size_t count, double* values) const {
+    const size_t dim = static_cast<size_t>(getDimension());
+    std::vector<double> x(dim);
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            x[j] = points[j * count + i];
+        }
+        values[i] = (*this)(x);
+    }
+}
+
+void AbstrFunc::gradientBatch(const double* points, size_t count, double* grads) const {
+    const size_t dim = static_cast<size_t>(getDimension());
+    std::vector<double> x(dim);
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            x[j] = points[j * count + i];
+        }
+        std::vector<double> g = getGradient(x);
+        for (size_t j = 0; j < dim; ++j) {
+            grads[j * count + i] = g[j];
+        }
+    }
+}
+
+namespace {
+
+// Аналитический градиент, а если его нет - численный
+std::vector<double> gradientAt(const AbstrFunc& f, const std::vector<double>& x) {
+    try {
+        return f.getGradient(x);
+    }
+    catch (...) {
+        return numericalGradient(f, x);
+    }
+}
+
+void checkSameSize(const std::vector<double>& x, const std::vector<double>& v) {
+    if (x.size() != v.size()) {
+        throw std::invalid_argument("Point and direction must have the same dimension");
+    }
+}
+
+} // namespace
 
+std::vector<double> AbstrFunc::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSameSize(x, v);
+    double xnorm = 0.0, vnorm = 0.0;
     for (size_t i = 0; i < x.size(); ++i) {
-        x_plus[i] = x[i] + h;
-        double f_plus = func(x_plus);
+        xnorm += x[i] * x[i];
+        vnorm += v[i] * v[i];
+    }
+    xnorm = std::sqrt(xnorm);
+    vnorm = std::sqrt(vnorm);
 
-        x_plus[i] = x[i] - h;
-        double f_minus = func(x_plus);
+    std::vector<double> hv(x.size(), 0.0);
+    if (vnorm == 0.0) {
+        return hv;
+    }
 
-        grad[i] = (f_plus - f_minus) / (2.0 * h);
-        x_plus[i] = x[i];
+    // Шаг cbrt(eps) относительно масштаба x, отнесённый к длине v
+    const double h = std::cbrt(std::numeric_limits<double>::epsilon()) * (std::max)(xnorm, 1.0) / vnorm;
+    std::vector<double> xp(x.size()), xm(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        xp[i] = x[i] + h * v[i];
+        xm[i] = x[i] - h * v[i];
     }
+    const std::vector<double> gp = gradientAt(*this, xp);
+    const std::vector<double> gm = gradientAt(*this, xm);
+    for (size_t i = 0; i < x.size(); ++i) {
+        hv[i] = (gp[i] - gm[i]) / (2.0 * h);
+    }
+    return hv;
+}
 
-    return grad;
+double AbstrFunc::coordinateTerm(int, double) const {
+    throw std::logic_error("Function is not separable: " + getName());
+}
+
+double AbstrFunc::updateValue(double fx, const std::vector<double>& x, int i, double newValue) const {
+    if (isSeparable()) {
+        return fx - coordinateTerm(i, x[i]) + coordinateTerm(i, newValue);
+    }
+    std::vector<double> changed = x;
+    changed[i] = newValue;
+    return (*this)(changed);
 }
 
 double QuadraticFunc2D::operator()(const std::vector<double>& x) const {
@@ -57,6 +164,40 @@ int QuadraticFunc2D::getDimension() const {
     return 2;
 }
 
+std::vector<double> QuadraticFunc2D::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    if (x.size() != 2 || v.size() != 2) {
+        throw std::invalid_argument("QuadraticFunc2D requires exactly 2 dimensions");
+    }
+    return { 2.0 * v[0], 2.0 * v[1] };
+}
+
+double QuadraticFunc2D::coordinateTerm(int j, double xj) const {
+    const double d = j == 0 ? xj - 3.0 : xj + 1.0;
+    return d * d;
+}
+
+double QuadraticFunc2D::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    if (x.size() != 2) {
+        throw std::invalid_argument("QuadraticFunc2D requires exactly 2 dimensions");
+    }
+    double dx = x[0] - 3.0;
+    double dy = x[1] + 1.0;
+    grad.resize(2);
+    grad[0] = 2 * dx;
+    grad[1] = 2 * dy;
+    return dx * dx + dy * dy;
+}
+
+void QuadraticFunc2D::evaluateBatch(const double* points, size_t count, double* values) const {
+    static const double center[2] = { 3.0, -1.0 };
+    simd::sumOfSquaresBatch(points, count, 2, center, values);
+}
+
+void QuadraticFunc2D::gradientBatch(const double* points, size_t count, double* grads) const {
+    static const double center[2] = { 3.0, -1.0 };
+    simd::sumOfSquaresGradientBatch(points, count, 2, center, grads);
+}
+
 double SphereFunc2D::operator()(const std::vector<double>& x) const {
     if (x.size() != 2) {
         throw std::invalid_argument("SphereFunc2D requires exactly 2 dimensions");
@@ -79,6 +220,35 @@ int SphereFunc2D::getDimension() const {
     return 2;
 }
 
+std::vector<double> SphereFunc2D::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    if (x.size() != 2 || v.size() != 2) {
+        throw std::invalid_argument("SphereFunc2D requires exactly 2 dimensions");
+    }
+    return { 2.0 * v[0], 2.0 * v[1] };
+}
+
+double SphereFunc2D::coordinateTerm(int, double xj) const {
+    return xj * xj;
+}
+
+double SphereFunc2D::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    if (x.size() != 2) {
+        throw std::invalid_argument("SphereFunc2D requires exactly 2 dimensions");
+    }
+    grad.resize(2);
+    grad[0] = 2.0 * x[0];
+    grad[1] = 2.0 * x[1];
+    return x[0] * x[0] + x[1] * x[1];
+}
+
+void SphereFunc2D::evaluateBatch(const double* points, size_t count, double* values) const {
+    simd::sumOfSquaresBatch(points, count, 2, nullptr, values);
+}
+
+void SphereFunc2D::gradientBatch(const double* points, size_t count, double* grads) const {
+    simd::sumOfSquaresGradientBatch(points, count, 2, nullptr, grads);
+}
+
 double RastriginFunc2D::operator()(const std::vector<double>& x) const {
     if (x.size() != 2) {
         throw std::invalid_argument("RastriginFunc2D requires exactly 2 dimensions");
@@ -103,4 +273,42 @@ std::string RastriginFunc2D::getName() const {
 
 int RastriginFunc2D::getDimension() const {
     return 2;
-}
\ No newline at end of file
+}
+
+std::vector<double> RastriginFunc2D::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    if (x.size() != 2 || v.size() != 2) {
+        throw std::invalid_argument("RastriginFunc2D requires exactly 2 dimensions");
+    }
+    // Гессиан диагональный: 2 + 4pi^2 A cos(2pi x_i)
+    const double k = 4.0 * M_PI * M_PI * A;
+    return {
+        (2.0 + k * cos(2.0 * M_PI * x[0])) * v[0],
+        (2.0 + k * cos(2.0 * M_PI * x[1])) * v[1]
+    };
+}
+
+double RastriginFunc2D::coordinateTerm(int, double xj) const {
+    return A + xj * xj - A * cos(2.0 * M_PI * xj);
+}
+
+double RastriginFunc2D::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    if (x.size() != 2) {
+        throw std::invalid_argument("RastriginFunc2D requires exactly 2 dimensions");
+    }
+    // sin и cos от 2*pi*x считаются одним сведением аргумента
+    double s[2], c[2];
+    simd::sincos2pi(x.data(), 2, s, c);
+
+    grad.resize(2);
+    grad[0] = 2.0 * x[0] + 2.0 * M_PI * A * s[0];
+    grad[1] = 2.0 * x[1] + 2.0 * M_PI * A * s[1];
+    return 2 * A + x[0] * x[0] - A * c[0] + x[1] * x[1] - A * c[1];
+}
+
+void RastriginFunc2D::evaluateBatch(const double* points, size_t count, double* values) const {
+    simd::rastriginBatch(points, count, 2, A, values);
+}
+
+void RastriginFunc2D::gradientBatch(const double* points, size_t count, double* grads) const {
+    simd::rastriginGradientBatch(points, count, 2, A, grads);
+}
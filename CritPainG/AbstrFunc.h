@@ -4,6 +4,7 @@
 #include <vector>
 #include <cmath>
 #include <string>
+#include <cstddef>
 
 class AbstrFunc {
 public:
@@ -12,10 +13,52 @@ public:
     virtual std::vector<double> getGradient(const std::vector<double>& x) const = 0;
     virtual std::string getName() const = 0;
     virtual int getDimension() const = 0;
+
+    //       (     ).
+    //  f(x),    grad.
+    virtual double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const;
+
+    //     count .
+    // points    (SoA): j-  i-    points[j * count + i].
+    //     operator()   .
+    virtual void evaluateBatch(const double* points, size_t count, double* values) const;
+    //   ; grads     SoA,   points.
+    //     getGradient()   .
+    virtual void gradientBatch(const double* points, size_t count, double* grads) const;
+
+    //     H(x) v   .
+    //   -   : (g(x + h v) - g(x - h v)) / 2h.
+    virtual std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const;
+
+    //   : f(x) = sum_j coordinateTerm(j, x_j).
+    virtual bool isSeparable() const { return false; }
+    //   j;    - 
+    virtual double coordinateTerm(int j, double xj) const;
+    // f(x')  x',   x   i,   fx = f(x).
+    //    O(1): fx - term(i, x_i) + term(i, newValue);
+    //     x'.
+    double updateValue(double fx, const std::vector<double>& x, int i, double newValue) const;
+
+    // true,      ,     
+    // (   ,  ProcessFunc   )
+    virtual bool prefersWholeBatch() const { return false; }
 };
 
-//   
-std::vector<double> numericalGradient(const AbstrFunc& func, const std::vector<double>& x, double h = 1e-7);
+//      (. FiniteDifference.h).
+// h -  : h_j = h * max(|x_j|, 1); h == 0 -  cbrt(eps).
+std::vector<double> numericalGradient(const AbstrFunc& func, const std::vector<double>& x, double h = 0.0);
+
+// true,       (  )
+bool insideNumericalGradient();
+
+//           
+class NumericalGradientScope {
+public:
+    NumericalGradientScope();
+    ~NumericalGradientScope();
+    NumericalGradientScope(const NumericalGradientScope&) = delete;
+    NumericalGradientScope& operator=(const NumericalGradientScope&) = delete;
+};
 
 //   R2
 class QuadraticFunc2D : public AbstrFunc {
@@ -24,6 +67,20 @@ public:
     std::vector<double> getGradient(const std::vector<double>& x) const override;
     std::string getName() const override;
     int getDimension() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    bool isSeparable() const override { return true; }
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+    double coordinateTerm(int j, double xj) const override;
+
+    //    FixedOptim.h (T = double  Dual<N>)
+    template <class T>
+    T evaluate(const T* x) const {
+        T dx = x[0] - 3.0;
+        T dy = x[1] + 1.0;
+        return dx * dx + dy * dy;
+    }
 };
 
 //   R3
@@ -33,17 +90,42 @@ public:
     std::vector<double> getGradient(const std::vector<double>& x) const override;
     std::string getName() const override;
     int getDimension() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    bool isSeparable() const override { return true; }
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+    double coordinateTerm(int j, double xj) const override;
+
+    template <class T>
+    T evaluate(const T* x) const {
+        return x[0] * x[0] + x[1] * x[1];
+    }
 };
 
 //   R4
 class RastriginFunc2D : public AbstrFunc {
 private:
     static constexpr double A = 10.0;
+    static constexpr double TWO_PI = 6.28318530717958647693;
 public:
     double operator()(const std::vector<double>& x) const override;
     std::vector<double> getGradient(const std::vector<double>& x) const override;
     std::string getName() const override;
     int getDimension() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    bool isSeparable() const override { return true; }
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+    double coordinateTerm(int j, double xj) const override;
+
+    template <class T>
+    T evaluate(const T* x) const {
+        using std::cos;
+        return 2 * A + x[0] * x[0] - A * cos(TWO_PI * x[0])
+            + x[1] * x[1] - A * cos(TWO_PI * x[1]);
+    }
 };
 
 #endif
\ No newline at end of file
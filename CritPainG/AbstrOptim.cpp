@@ -5,18 +5,63 @@
 #include <limits>
 #include <cmath>
 
-#ifndef MaxI
-#define MaxI 100000
-#endif
+namespace {
+
+// LU-       k x k ( )
+//  ; false -  
+bool luFactor(double* a, size_t k, size_t* pivot) {
+    for (size_t col = 0; col < k; ++col) {
+        size_t best = col;
+        for (size_t row = col + 1; row < k; ++row) {
+            if (std::fabs(a[row * k + col]) > std::fabs(a[best * k + col])) best = row;
+        }
+        pivot[col] = best;
+        if (!(std::fabs(a[best * k + col]) > 0.0)) return false;
+        if (best != col) {
+            for (size_t j = 0; j < k; ++j) std::swap(a[col * k + j], a[best * k + j]);
+        }
+        for (size_t row = col + 1; row < k; ++row) {
+            const double factor = a[row * k + col] / a[col * k + col];
+            a[row * k + col] = factor;
+            for (size_t j = col + 1; j < k; ++j) a[row * k + j] -= factor * a[col * k + j];
+        }
+    }
+    return true;
+}
+
+//  A x = b   luFactor; b   x
+void luSolve(const double* a, size_t k, const size_t* pivot, double* b) {
+    for (size_t i = 0; i < k; ++i) {
+        std::swap(b[i], b[pivot[i]]);
+        for (size_t j = 0; j < i; ++j) b[i] -= a[i * k + j] * b[j];
+    }
+    for (size_t i = k; i-- > 0;) {
+        for (size_t j = i + 1; j < k; ++j) b[i] -= a[i * k + j] * b[j];
+        b[i] /= a[i * k + i];
+    }
+}
+
+}
 
 AbstrOptim::AbstrOptim(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
     const std::vector<double>& x0)
-    : func(f), criterial(std::move(c)), initialPoint(x0) {
+    : func(&counter), counter(f), criterial(std::move(c)), initialPoint(x0) {
     if (!x0.empty()) {
         trajectory.push_back(x0);
     }
 }
 
+AbstrOptim::Result AbstrOptim::optimize() {
+    counter.reset();
+    Result result = run();
+    const EvaluationCounts counts = counter.counts();
+    result.function_evaluations = counts.values;
+    result.gradient_evaluations = counts.gradients;
+    result.fd_evaluations = counts.finiteDifference;
+    result.hessian_vector_products = counts.hessianProducts;
+    return result;
+}
+
 RandomSearchOptim::RandomSearchOptim(const AbstrFunc* f,
     std::unique_ptr<const AbstrCriterial> c,
     const std::vector<double>& x0,
@@ -24,7 +69,7 @@ RandomSearchOptim::RandomSearchOptim(const AbstrFunc* f,
     const std::vector<double>& ub,
     double d,
     unsigned int seed, double p_value, double alpha_value)
-    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub), delta(d), gen(seed), p(p_value), alpha(alpha_value) {
+    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub), delta(d), gen(seed), p(p_value), alpha(alpha_value), local_coordinates(0) {
 
     if (lb.size() != ub.size() || lb.size() != x0.size()) {
         throw std::invalid_argument("Sizes of bounds and initial point must match.");
@@ -52,7 +97,7 @@ RandomSearchOptim::RandomSearchOptim(const AbstrFunc* f,
     }
 }
 
-AbstrOptim::Result RandomSearchOptim::optimize() {
+AbstrOptim::Result RandomSearchOptim::run() {
     trajectory.clear();
 
     std::vector<double> current_point = initialPoint;
@@ -72,44 +117,87 @@ AbstrOptim::Result RandomSearchOptim::optimize() {
     const int max_no_improvement = 50;
     int no_improvement_count = 0;   
 
+    //   :     changed
+    const size_t n = current_point.size();
+    const bool partial = local_coordinates > 0 && local_coordinates < n;
+    const bool incremental = partial && func->isSeparable();
+    std::uniform_int_distribution<size_t> index_dis(0, n > 0 ? n - 1 : 0);
+    std::vector<size_t> changed;
+    //       
+    // n  ,      O(1) 
+    size_t incremental_updates = 0;
+
+    //   candidate_point   current_point
+    std::vector<double> candidate_point = current_point;
+
     while (!criterial->isSatisfied(current_point, current_value, iteration)) {
         if (iteration >= max_fallback_iterations) {
             return { best_point, best_value, iteration,
                      "Fallback: reached maximum iterations", trajectory };
         }
 
-        std::vector<double> candidate_point(current_point.size());
         bool is_local_search = (prob_dis(gen) < p);
         bool improvement = false;
+        bool partial_step = false;
+        double candidate_value = current_value;
 
         if (is_local_search) {
-            std::uniform_real_distribution<double> coord_dis;
-
-            for (size_t i = 0; i < current_point.size(); ++i) {
-                coord_dis.param(std::uniform_real_distribution<double>::param_type(
-                    -current_delta, current_delta
-                ));
-
-                double offset = coord_dis(gen);
-                candidate_point[i] = current_point[i] + offset;
+            std::uniform_real_distribution<double> coord_dis(-current_delta, current_delta);
+
+            if (partial) {
+                partial_step = true;
+                changed.clear();
+                for (size_t c = 0; c < local_coordinates; ++c) {
+                    const size_t i = index_dis(gen);
+                    double value = current_point[i] + coord_dis(gen);
+                    value = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], value));
+                    if (incremental) {
+                        candidate_value = func->updateValue(candidate_value, candidate_point, static_cast<int>(i), value);
+                    }
+                    candidate_point[i] = value;
+                    changed.push_back(i);
+                }
+            }
+            else {
+                for (size_t i = 0; i < n; ++i) {
+                    double offset = coord_dis(gen);
+                    candidate_point[i] = current_point[i] + offset;
 
-                //   D
-                candidate_point[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], candidate_point[i]));
+                    //   D
+                    candidate_point[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], candidate_point[i]));
+                }
             }
         }
         else {
             //  
-            for (size_t i = 0; i < current_point.size(); ++i) {
+            for (size_t i = 0; i < n; ++i) {
                 candidate_point[i] = lower_bounds[i] +
                     global_dis(gen) * (upper_bounds[i] - lower_bounds[i]);
             }
         }
 
-        double candidate_value = (*func)(candidate_point);
+        if (!partial_step || !incremental) {
+            candidate_value = (*func)(candidate_point);
+        }
 
         if (candidate_value < current_value) {
-            current_point = candidate_point;
+            if (partial_step) {
+                for (size_t i : changed) current_point[i] = candidate_point[i];
+            }
+            else {
+                current_point = candidate_point;
+            }
             current_value = candidate_value;
+            if (partial_step && incremental) {
+                incremental_updates += changed.size();
+                if (incremental_updates >= n) {
+                    current_value = (*func)(current_point);
+                    incremental_updates = 0;
+                }
+            }
+            else {
+                incremental_updates = 0;
+            }
             improvement = true;
 
             no_improvement_count = 0; 
@@ -119,12 +207,20 @@ AbstrOptim::Result RandomSearchOptim::optimize() {
                 current_delta *= alpha;
             }
 
-            if (candidate_value < best_value) {
-                best_point = candidate_point;
-                best_value = candidate_value;
+            if (current_value < best_value) {
+                best_point = current_point;
+                best_value = current_value;
             }
         }
         else {
+            //     
+            if (partial_step) {
+                for (size_t i : changed) candidate_point[i] = current_point[i];
+            }
+            else {
+                candidate_point = current_point;
+            }
+
             //   
             no_improvement_count++;
 
@@ -153,111 +249,125 @@ AbstrOptim::Result RandomSearchOptim::optimize() {
     return { best_point, best_value, iteration, "Criterial satisfied", trajectory };
 }
 
-double ConjugateGradientFR::line_search(const std::vector<double>& x, const std::vector<double>& p) const {
-    const double initial_alpha = 1.0;
-    const double reduction_factor = 0.5;
-    const int max_tries = 20;
-
-    double alpha = initial_alpha;
-    double f_current = (*func)(x);
-
-    std::vector<double> new_point(x.size());
-
-    for (int try_count = 0; try_count < max_tries; ++try_count) {
-        //   
-        for (size_t i = 0; i < x.size(); ++i) {
-            new_point[i] = x[i] + alpha * p[i];
-        }
+ConjugateGradientFRConstrained::ConjugateGradientFRConstrained(const AbstrFunc* f,
+    std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, const std::vector<double>& lb,
+    const std::vector<double>& ub, double ls_tolerance,
+    int max_ls_iter, double grad_eps)
+    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub),
+    grad_epsilon(grad_eps),
+    lineSearch(std::make_unique<StrongWolfeLineSearch>(1e-4, 0.1, max_ls_iter, ls_tolerance)) {
 
-        double f_new = (*func)(new_point);
+    if (lb.size() != ub.size() || lb.size() != x0.size()) {
+        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+    }
 
-        //    
-        if (f_new < f_current) {
-            return alpha;
+    for (size_t i = 0; i < lb.size(); ++i) {
+        if (lb[i] > ub[i]) {
+            throw std::invalid_argument("Lower bound must be <= upper bound.");
         }
-
-        //  
-        alpha *= reduction_factor;
     }
+}
 
-    return alpha; //   alpha,     
+void ConjugateGradientFRConstrained::setLineSearch(std::unique_ptr<LineSearch> ls) {
+    if (!ls) {
+        throw std::invalid_argument("Line search must not be null.");
+    }
+    lineSearch = std::move(ls);
 }
 
-ConjugateGradientFR::ConjugateGradientFR(const AbstrFunc* f,
-    std::unique_ptr<const AbstrCriterial> c,
-    const std::vector<double>& x0,
-    double ls_tolerance,
-    int max_ls_iter,
-    double grad_eps)
-    : AbstrOptim(f, std::move(c), x0), line_search_tolerance(ls_tolerance),
-    max_line_search_iter(max_ls_iter), grad_epsilon(grad_eps) {}
+std::vector<double> ConjugateGradientFRConstrained::projectToBounds(const std::vector<double>& x) const {
+    std::vector<double> projected = x;
+    for (size_t i = 0; i < x.size(); ++i) {
+        projected[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], x[i]));
+    }
+    return projected;
+}
 
-AbstrOptim::Result ConjugateGradientFR::optimize() {
+AbstrOptim::Result ConjugateGradientFRConstrained::run() {
     trajectory.clear();
-    std::vector<double> x = initialPoint;
-    double f_val = (*func)(x);
+
+    //      
+    std::vector<double> x = projectToBounds(initialPoint);
     int iteration = 0;
     addPointToTrajectory(x);
-    //   
-    std::vector<double> grad;
-    try {
-        grad = func->getGradient(x);
-    }
-    catch (...) {
-        //     ,  
-        grad = numericalGradient(*func, x);
-    }
 
+    //       
+    std::vector<double> grad;
+    double f_val = evaluateWithGradient(*func, x, grad, fdOptions);
     std::vector<double> p = grad;
-    for (double& val : p) val = -val; 
+    for (double& val : p) val = -val;
+    bool steepest = true;
 
     std::vector<double> best_x = x;
     double best_f_val = f_val;
 
+    double prev_step = 1.0, prev_slope = 0.0;
+
     const int max_fallback_iterations = MaxI;
 
     while (!criterial->isSatisfied(x, f_val, iteration)) {
-       
+        //    
         if (iteration >= max_fallback_iterations) {
+            addPointToTrajectory(best_x);
+
             return { best_x, best_f_val, iteration,
-                     "Fallback: reached maximum iterations", trajectory };
+                     "Reached maximum iterations", trajectory };
         }
 
-
         //   
         double grad_norm_sq = 0.0;
         for (double g : grad) grad_norm_sq += g * g;
         if (std::sqrt(grad_norm_sq) < grad_epsilon) {
-            return { best_x, best_f_val, iteration,
-                     "Gradient norm below threshold", trajectory };
-        }
+            addPointToTrajectory(best_x);
 
-        //  
-        double alpha = line_search(x, p);
+            return { best_x, best_f_val, iteration,
+                         "Gradient norm below threshold", trajectory };
+            }
 
-        //  
-        std::vector<double> x_new = x;
-        for (size_t i = 0; i < x.size(); ++i) {
-            x_new[i] += alpha * p[i];
+        //       
+        VectorLineFunction phi(*func, fdOptions, x, p, &lower_bounds, &upper_bounds);
+        double slope = phi.initialSlope(grad);
+        if (!(slope < 0.0)) {
+            for (size_t i = 0; i < p.size(); ++i) p[i] = -grad[i];
+            slope = phi.initialSlope(grad);
+            steepest = true;
+            if (!(slope < 0.0)) {
+                //    :    
+                addPointToTrajectory(best_x);
+                return { best_x, best_f_val, iteration,
+                         "Projected gradient norm below threshold", trajectory };
+            }
+        }
+        double initial_step = prev_slope < 0.0 ? prev_step * prev_slope / slope : 1.0;
+        if (!(initial_step > 0.0) || !std::isfinite(initial_step)) initial_step = 1.0;
+
+        const LineSearchResult ls = lineSearch->search(phi, f_val, slope, initial_step);
+        if (!ls.accepted) {
+            if (!steepest) {
+                for (size_t i = 0; i < p.size(); ++i) p[i] = -grad[i];
+                steepest = true;
+                prev_slope = 0.0;
+                continue;
+            }
+            addPointToTrajectory(best_x);
+            return { best_x, best_f_val, iteration,
+                     "Line search failed", trajectory };
         }
+        prev_step = ls.step;
+        prev_slope = slope;
+
+        //      
+        std::vector<double> x_new = std::move(phi.point);
+        std::vector<double> grad_new = std::move(phi.gradient);
+        double f_val_new = ls.value;
 
-        double f_val_new = (*func)(x_new);
-        addPointToTrajectory(x_new);
         //   
         if (f_val_new < best_f_val) {
             best_x = x_new;
             best_f_val = f_val_new;
         }
 
-        //   
-        std::vector<double> grad_new;
-        try {
-            grad_new = func->getGradient(x_new);
-        }
-        catch (...) {
-            grad_new = numericalGradient(*func, x_new);
-        }
-
         //   NaN  
         bool grad_has_nan = false;
         for (double g : grad_new) {
@@ -268,11 +378,13 @@ AbstrOptim::Result ConjugateGradientFR::optimize() {
         }
 
         if (grad_has_nan) {
+            addPointToTrajectory(best_x);
+
             return { best_x, best_f_val, iteration,
                      "Gradient contains NaN", trajectory };
         }
 
-        //  beta  Fletcher-Reeves
+        // Fletcher-Reeves beta
         double grad_norm_sq_old = 0.0, grad_norm_sq_new = 0.0;
         for (size_t i = 0; i < grad.size(); ++i) {
             grad_norm_sq_old += grad[i] * grad[i];
@@ -288,173 +400,617 @@ AbstrOptim::Result ConjugateGradientFR::optimize() {
         for (size_t i = 0; i < p.size(); ++i) {
             p[i] = -grad_new[i] + beta * p[i];
         }
-
-        //     
-        x = x_new;
+        steepest = false;
+        x = std::move(x_new);
         f_val = f_val_new;
-        grad = grad_new;
+        grad = std::move(grad_new);
         iteration++;
     }
+    addPointToTrajectory(best_x);
 
     return { best_x, best_f_val, iteration, "Criterial satisfied", trajectory };
 }
 
-
-ConjugateGradientFRConstrained::ConjugateGradientFRConstrained(const AbstrFunc* f,
-    std::unique_ptr<const AbstrCriterial> c,
-    const std::vector<double>& x0, const std::vector<double>& lb,
-    const std::vector<double>& ub, double ls_tolerance,
-    int max_ls_iter, double grad_eps)
-    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub),
-    line_search_tolerance(ls_tolerance), max_line_search_iter(max_ls_iter),
-    grad_epsilon(grad_eps) {
-
-    if (lb.size() != ub.size() || lb.size() != x0.size()) {
-        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+NewtonCG::NewtonCG(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, double grad_eps, int max_cg, double c1)
+    : AbstrOptim(f, std::move(c), x0), grad_epsilon(grad_eps), max_cg_iter(max_cg), armijo_c1(c1) {
+    if (x0.empty()) {
+        throw std::invalid_argument("Initial point must not be empty.");
     }
-
-    for (size_t i = 0; i < lb.size(); ++i) {
-        if (lb[i] > ub[i]) {
-            throw std::invalid_argument("Lower bound must be <= upper bound.");
-        }
+    if (max_cg < 0) {
+        throw std::invalid_argument("Maximum CG iterations must be non-negative.");
+    }
+    if (c1 <= 0.0 || c1 >= 0.5) {
+        throw std::invalid_argument("Armijo constant must be in range (0, 0.5).");
     }
 }
 
-std::vector<double> ConjugateGradientFRConstrained::projectToBounds(const std::vector<double>& x) const {
-    std::vector<double> projected = x;
-    for (size_t i = 0; i < x.size(); ++i) {
-        projected[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], x[i]));
+std::vector<double> NewtonCG::solveNewtonSystem(const std::vector<double>& x, const std::vector<double>& grad, int& cg_iterations) const {
+    const size_t n = x.size();
+    auto dot = [n](const std::vector<double>& a, const std::vector<double>& b) {
+        double s = 0.0;
+        for (size_t i = 0; i < n; ++i) s += a[i] * b[i];
+        return s;
+    };
+
+    const double grad_norm = std::sqrt(dot(grad, grad));
+    const double eta = (std::min)(0.5, std::sqrt(grad_norm));
+    const int limit = max_cg_iter > 0 ? max_cg_iter : static_cast<int>(n);
+
+    // CG  H z = -g  z0 = 0:  r = H z + g
+    std::vector<double> z(n, 0.0);
+    std::vector<double> r = grad;
+    std::vector<double> d(n);
+    for (size_t i = 0; i < n; ++i) d[i] = -r[i];
+    double rr = dot(r, r);
+
+    for (cg_iterations = 0; cg_iterations < limit; ++cg_iterations) {
+        const std::vector<double> hd = func->hessianVectorProduct(x, d);
+        const double curvature = dot(d, hd);
+
+        //  :    - ,
+        //  -     
+        if (curvature <= std::numeric_limits<double>::epsilon() * dot(d, d)) {
+            if (cg_iterations == 0) {
+                return d;
+            }
+            break;
+        }
+
+        const double alpha = rr / curvature;
+        for (size_t i = 0; i < n; ++i) {
+            z[i] += alpha * d[i];
+            r[i] += alpha * hd[i];
+        }
+        const double rr_new = dot(r, r);
+        if (std::sqrt(rr_new) <= eta * grad_norm) {
+            ++cg_iterations;
+            break;
+        }
+
+        const double beta = rr_new / rr;
+        for (size_t i = 0; i < n; ++i) d[i] = -r[i] + beta * d[i];
+        rr = rr_new;
     }
-    return projected;
+    return z;
 }
 
-double ConjugateGradientFRConstrained::line_search(const std::vector<double>& x, const std::vector<double>& p) const {
-    const double initial_alpha = 1.0;
-    const double reduction_factor = 0.5;
-    const int max_tries = 20;
+AbstrOptim::Result NewtonCG::run() {
+    trajectory.clear();
+    std::vector<double> x = initialPoint;
+    int iteration = 0;
+    addPointToTrajectory(x);
+
+    std::vector<double> grad;
+    double f_val = evaluateWithGradient(*func, x, grad, fdOptions);
 
-    double alpha = initial_alpha;
-    double f_current = (*func)(x);
+    const int max_fallback_iterations = MaxI;
+    const int max_backtracks = 50;
+    std::vector<double> x_new(x.size());
 
-    for (int try_count = 0; try_count < max_tries; ++try_count) {
-        //       
-        std::vector<double> new_point = x;
-        for (size_t i = 0; i < x.size(); ++i) {
-            new_point[i] += alpha * p[i];
+    while (!criterial->isSatisfied(x, f_val, iteration)) {
+        if (iteration >= max_fallback_iterations) {
+            return { x, f_val, iteration, "Fallback: reached maximum iterations", trajectory };
         }
-        new_point = projectToBounds(new_point);
 
-        double f_new = (*func)(new_point);
+        double grad_norm_sq = 0.0;
+        bool grad_has_nan = false;
+        for (double g : grad) {
+            grad_norm_sq += g * g;
+            grad_has_nan = grad_has_nan || std::isnan(g);
+        }
+        if (grad_has_nan) {
+            return { x, f_val, iteration, "Gradient contains NaN", trajectory };
+        }
+        if (std::sqrt(grad_norm_sq) < grad_epsilon) {
+            return { x, f_val, iteration, "Gradient norm below threshold", trajectory };
+        }
 
-        //    
-        if (f_new < f_current) {
-            return alpha;
+        int cg_iterations = 0;
+        std::vector<double> p = solveNewtonSystem(x, grad, cg_iterations);
+
+        double slope = 0.0;
+        for (size_t i = 0; i < x.size(); ++i) slope += grad[i] * p[i];
+        if (!(slope < 0.0)) {
+            //  H v    -  
+            for (size_t i = 0; i < x.size(); ++i) p[i] = -grad[i];
+            slope = -grad_norm_sq;
         }
 
-        //  
-        alpha *= reduction_factor;
+        //     ;     
+        double alpha = 1.0;
+        double f_new = f_val;
+        bool accepted = false;
+        for (int k = 0; k < max_backtracks; ++k) {
+            for (size_t i = 0; i < x.size(); ++i) x_new[i] = x[i] + alpha * p[i];
+            f_new = (*func)(x_new);
+            if (f_new <= f_val + armijo_c1 * alpha * slope) {
+                accepted = true;
+                break;
+            }
+            alpha *= 0.5;
+        }
+        if (!accepted) {
+            return { x, f_val, iteration, "Line search failed", trajectory };
+        }
+
+        x = x_new;
+        f_val = f_new;
+        grad = gradientWithKnownValue(*func, x, f_val, fdOptions);
+        addPointToTrajectory(x);
+        iteration++;
     }
 
-    return alpha;
+    return { x, f_val, iteration, "Criterial satisfied", trajectory };
 }
 
-AbstrOptim::Result ConjugateGradientFRConstrained::optimize() {
-    trajectory.clear();
+LBFGS::LBFGS(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, int m, double grad_eps, double c1, double c2)
+    : AbstrOptim(f, std::move(c), x0), history(m), grad_epsilon(grad_eps), wolfe_c1(c1), wolfe_c2(c2) {
+    if (x0.empty()) {
+        throw std::invalid_argument("Initial point must not be empty.");
+    }
+    if (m < 1) {
+        throw std::invalid_argument("History size must be positive.");
+    }
+    if (c1 <= 0.0 || c1 >= c2 || c2 >= 1.0) {
+        throw std::invalid_argument("Wolfe constants must satisfy 0 < c1 < c2 < 1.");
+    }
+}
 
-    //      
-    std::vector<double> x = projectToBounds(initialPoint);
-    double f_val = (*func)(x);
+AbstrOptim::Result LBFGS::run() {
+    trajectory.clear();
+    const size_t n = initialPoint.size();
+    const size_t m = static_cast<size_t>(history);
+    std::vector<double> x = initialPoint;
     int iteration = 0;
     addPointToTrajectory(x);
-    
-    //    
-    std::vector<double> grad = numericalGradient(*func, x);
-    std::vector<double> p = grad;
-    for (double& val : p) val = -val;
 
-    std::vector<double> best_x = x;
-    double best_f_val = f_val;
+    //  :  k   (head + k) % m,    
+    std::vector<double> s_hist(m * n), y_hist(m * n);
+    std::vector<double> rho(m), alpha_hist(m);
+    size_t head = 0, stored = 0;
+
+    std::vector<double> grad(n), grad_new(n), x_new(n), p(n);
+    double f_val = evaluateWithGradient(*func, x, grad, fdOptions);
+
+    auto dot = [n](const double* a, const double* b) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+        return sum;
+    };
 
     const int max_fallback_iterations = MaxI;
+    const int max_line_search_iter = 50;
 
     while (!criterial->isSatisfied(x, f_val, iteration)) {
-        //    
         if (iteration >= max_fallback_iterations) {
-            addPointToTrajectory(best_x);
-
-            return { best_x, best_f_val, iteration,
-                     "Reached maximum iterations", trajectory };
+            return { x, f_val, iteration, "Fallback: reached maximum iterations", trajectory };
         }
 
-        //   
-        double grad_norm_sq = 0.0;
-        for (double g : grad) grad_norm_sq += g * g;
+        const double grad_norm_sq = dot(grad.data(), grad.data());
+        if (std::isnan(grad_norm_sq)) {
+            return { x, f_val, iteration, "Gradient contains NaN", trajectory };
+        }
         if (std::sqrt(grad_norm_sq) < grad_epsilon) {
-            addPointToTrajectory(best_x);
+            return { x, f_val, iteration, "Gradient norm below threshold", trajectory };
+        }
 
-            return { best_x, best_f_val, iteration,
-                         "Gradient norm below threshold", trajectory };
+        //  : p = -H g, H0 = gamma I
+        for (size_t i = 0; i < n; ++i) p[i] = -grad[i];
+        for (size_t k = stored; k-- > 0;) {
+            const size_t row = (head + k) % m;
+            alpha_hist[row] = rho[row] * dot(&s_hist[row * n], p.data());
+            const double* y = &y_hist[row * n];
+            for (size_t i = 0; i < n; ++i) p[i] -= alpha_hist[row] * y[i];
+        }
+        double step = 1.0;
+        if (stored > 0) {
+            const size_t newest = (head + stored - 1) % m;
+            const double* y = &y_hist[newest * n];
+            const double gamma = 1.0 / (rho[newest] * dot(y, y));
+            for (size_t i = 0; i < n; ++i) p[i] *= gamma;
+        }
+        else {
+            //    :      1
+            step = (std::min)(1.0, 1.0 / std::sqrt(grad_norm_sq));
+        }
+        for (size_t k = 0; k < stored; ++k) {
+            const size_t row = (head + k) % m;
+            const double beta = rho[row] * dot(&y_hist[row * n], p.data());
+            const double* s = &s_hist[row * n];
+            for (size_t i = 0; i < n; ++i) p[i] += (alpha_hist[row] - beta) * s[i];
+        }
+
+        double slope = dot(grad.data(), p.data());
+        if (!(slope < 0.0)) {
+            //     -  
+            stored = 0;
+            for (size_t i = 0; i < n; ++i) p[i] = -grad[i];
+            slope = -grad_norm_sq;
+            step = (std::min)(1.0, 1.0 / std::sqrt(grad_norm_sq));
+        }
+
+        //     
+        double lo = 0.0, hi = std::numeric_limits<double>::infinity();
+        double f_new = f_val;
+        bool accepted = false;
+        for (int k = 0; k < max_line_search_iter; ++k) {
+            for (size_t i = 0; i < n; ++i) x_new[i] = x[i] + step * p[i];
+            f_new = evaluateWithGradient(*func, x_new, grad_new, fdOptions);
+            if (!(f_new <= f_val + wolfe_c1 * step * slope)) {
+                hi = step;
             }
+            else if (dot(grad_new.data(), p.data()) < wolfe_c2 * slope) {
+                lo = step;
+            }
+            else {
+                accepted = true;
+                break;
+            }
+            step = std::isinf(hi) ? 2.0 * lo : 0.5 * (lo + hi);
+        }
+        if (!accepted) {
+            return { x, f_val, iteration, "Line search failed", trajectory };
+        }
+
+        //      ,   
+        double sy = 0.0, yy = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double dg = grad_new[i] - grad[i];
+            sy += (x_new[i] - x[i]) * dg;
+            yy += dg * dg;
+        }
+        if (sy > std::numeric_limits<double>::epsilon() * yy) {
+            const size_t row = stored < m ? (head + stored) % m : head;
+            double* s = &s_hist[row * n];
+            double* y = &y_hist[row * n];
+            for (size_t i = 0; i < n; ++i) {
+                s[i] = x_new[i] - x[i];
+                y[i] = grad_new[i] - grad[i];
+            }
+            rho[row] = 1.0 / sy;
+            if (stored < m) ++stored;
+            else head = (head + 1) % m;
+        }
+
+        x.swap(x_new);
+        grad.swap(grad_new);
+        f_val = f_new;
+        addPointToTrajectory(x);
+        iteration++;
+    }
+
+    return { x, f_val, iteration, "Criterial satisfied", trajectory };
+}
+
+LBFGSB::LBFGSB(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, const std::vector<double>& lb,
+    const std::vector<double>& ub, int m, double grad_eps, double c1, double c2)
+    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub),
+    history(m), grad_epsilon(grad_eps), wolfe_c1(c1), wolfe_c2(c2) {
+    if (x0.empty()) {
+        throw std::invalid_argument("Initial point must not be empty.");
+    }
+    if (lb.size() != ub.size() || lb.size() != x0.size()) {
+        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+    }
+    for (size_t i = 0; i < lb.size(); ++i) {
+        if (lb[i] > ub[i]) {
+            throw std::invalid_argument("Lower bound must be <= upper bound.");
+        }
+    }
+    if (m < 1) {
+        throw std::invalid_argument("History size must be positive.");
+    }
+    if (c1 <= 0.0 || c1 >= c2 || c2 >= 1.0) {
+        throw std::invalid_argument("Wolfe constants must satisfy 0 < c1 < c2 < 1.");
+    }
+}
 
-        //  
-        double alpha = line_search(x, p);
+AbstrOptim::Result LBFGSB::run() {
+    trajectory.clear();
+    const size_t n = initialPoint.size();
+    const size_t m = static_cast<size_t>(history);
+    const std::vector<double>& lb = lower_bounds;
+    const std::vector<double>& ub = upper_bounds;
+    auto clamp = [&](size_t i, double v) { return (std::max)(lb[i], (std::min)(ub[i], v)); };
+
+    std::vector<double> x(n);
+    for (size_t i = 0; i < n; ++i) x[i] = clamp(i, initialPoint[i]);
+    int iteration = 0;
+    addPointToTrajectory(x);
 
-        //      
-        std::vector<double> x_new = x;
-        for (size_t i = 0; i < x.size(); ++i) {
-            x_new[i] += alpha * p[i];
+    //  (s, y)   ,  k   (head + k) % m;
+    // sy[a * m + b] = s_a^T y_b, ss[a * m + b] = s_a^T s_b   
+    std::vector<double> s_hist(m * n), y_hist(m * n), sy(m * m), ss(m * m);
+    size_t head = 0, stored = 0;
+    double theta = 1.0;
+
+    //      
+    const size_t m2 = 2 * m;
+    std::vector<double> middle(m2 * m2), reduced(m2 * m2), wzw(m2 * m2);
+    std::vector<size_t> middle_pivot(m2), reduced_pivot(m2);
+    std::vector<double> p(m2), c(m2), w(m2), mp(m2), mc(m2), mw(m2), v(m2);
+    std::vector<double> grad(n), grad_new(n), x_new(n), x_cp(n), d(n), r(n);
+    std::vector<char> is_free(n);
+    std::vector<std::pair<double, size_t>> breakpoints;
+    breakpoints.reserve(n);
+
+    double f_val = evaluateWithGradient(*func, x, grad, fdOptions);
+
+    auto row_of = [&](size_t k) { return (head + k) % m; };
+    //  i  W = [Y, theta S]   
+    auto w_row = [&](size_t i, double* out) {
+        for (size_t k = 0; k < stored; ++k) {
+            const size_t row = row_of(k);
+            out[k] = y_hist[row * n + i];
+            out[stored + k] = theta * s_hist[row * n + i];
         }
-        x_new = projectToBounds(x_new); //    
+    };
+    auto apply_m = [&](const std::vector<double>& in, std::vector<double>& out) {
+        std::copy(in.begin(), in.begin() + 2 * stored, out.begin());
+        luSolve(middle.data(), 2 * stored, middle_pivot.data(), out.data());
+    };
+    auto dot2 = [&](const std::vector<double>& a, const std::vector<double>& b) {
+        double sum = 0.0;
+        for (size_t k = 0; k < 2 * stored; ++k) sum += a[k] * b[k];
+        return sum;
+    };
 
-        double f_val_new = (*func)(x_new);
+    const int max_fallback_iterations = MaxI;
+    const int max_line_search_iter = 50;
 
-        //   
-        if (f_val_new < best_f_val) {
-            best_x = x_new;
-            best_f_val = f_val_new;
+    while (!criterial->isSatisfied(x, f_val, iteration)) {
+        if (iteration >= max_fallback_iterations) {
+            return { x, f_val, iteration, "Fallback: reached maximum iterations", trajectory };
         }
 
-        //   
-        std::vector<double> grad_new = numericalGradient(*func, x_new);
+        double pg_norm_sq = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double pg = clamp(i, x[i] - grad[i]) - x[i];
+            pg_norm_sq += pg * pg;
+        }
+        if (std::isnan(pg_norm_sq)) {
+            return { x, f_val, iteration, "Gradient contains NaN", trajectory };
+        }
+        if (std::sqrt(pg_norm_sq) < grad_epsilon) {
+            return { x, f_val, iteration, "Projected gradient norm below threshold", trajectory };
+        }
 
-        //   NaN  
-        bool grad_has_nan = false;
-        for (double g : grad_new) {
-            if (std::isnan(g)) {
-                grad_has_nan = true;
-                break;
+        // M = K^{-1}, K = [[-D, L^T], [L, theta S^T S]], L -    S^T Y
+        const size_t k2 = 2 * stored;
+        for (size_t a = 0; a < stored; ++a) {
+            const size_t ra = row_of(a);
+            for (size_t b = 0; b < stored; ++b) {
+                const size_t rb = row_of(b);
+                middle[a * k2 + b] = a == b ? -sy[ra * m + ra] : 0.0;
+                middle[a * k2 + stored + b] = b > a ? sy[rb * m + ra] : 0.0;
+                middle[(stored + a) * k2 + b] = a > b ? sy[ra * m + rb] : 0.0;
+                middle[(stored + a) * k2 + stored + b] = theta * ss[ra * m + rb];
             }
         }
+        if (!luFactor(middle.data(), k2, middle_pivot.data())) {
+            stored = 0;
+            theta = 1.0;
+            continue;
+        }
 
-        if (grad_has_nan) {
-            addPointToTrajectory(best_x);
+        //   :  x(t) = P(x - t g)   
+        breakpoints.clear();
+        for (size_t i = 0; i < n; ++i) {
+            double t = std::numeric_limits<double>::infinity();
+            if (grad[i] < 0.0) t = (x[i] - ub[i]) / grad[i];
+            else if (grad[i] > 0.0) t = (x[i] - lb[i]) / grad[i];
+            d[i] = t > 0.0 ? -grad[i] : 0.0;
+            x_cp[i] = x[i];
+            is_free[i] = 1;
+            if (t <= 0.0) is_free[i] = 0;
+            else if (!std::isinf(t)) breakpoints.push_back({ t, i });
+        }
+        std::sort(breakpoints.begin(), breakpoints.end());
 
-            return { best_x, best_f_val, iteration,
-                     "Gradient contains NaN", trajectory };
+        for (size_t k = 0; k < k2; ++k) {
+            p[k] = 0.0;
+            c[k] = 0.0;
+        }
+        double dd = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            if (d[i] == 0.0) continue;
+            dd += d[i] * d[i];
+            for (size_t k = 0; k < stored; ++k) {
+                const size_t row = row_of(k);
+                p[k] += y_hist[row * n + i] * d[i];
+                p[stored + k] += theta * s_hist[row * n + i] * d[i];
+            }
+        }
+        double fp = -dd;
+        apply_m(p, mp);
+        double fpp = theta * dd - dot2(p, mp);
+        const double fpp_min = std::numeric_limits<double>::epsilon() * theta * dd;
+        fpp = (std::max)(fpp, fpp_min);
+        double dt_min = -fp / fpp;
+        double t_old = 0.0;
+
+        for (const auto& breakpoint : breakpoints) {
+            const double dt = breakpoint.first - t_old;
+            if (dt_min < dt) break;
+            const size_t b = breakpoint.second;
+            const double gb = grad[b];
+            x_cp[b] = gb > 0.0 ? lb[b] : ub[b];
+            const double zb = x_cp[b] - x[b];
+            for (size_t k = 0; k < k2; ++k) c[k] += dt * p[k];
+            w_row(b, w.data());
+            apply_m(c, mc);
+            apply_m(p, mp);
+            apply_m(w, mw);
+            fp += dt * fpp + gb * gb + theta * gb * zb - gb * dot2(w, mc);
+            fpp += -theta * gb * gb - 2.0 * gb * dot2(w, mp) - gb * gb * dot2(w, mw);
+            fpp = (std::max)(fpp, fpp_min);
+            for (size_t k = 0; k < k2; ++k) p[k] += gb * w[k];
+            d[b] = 0.0;
+            is_free[b] = 0;
+            dt_min = -fp / fpp;
+            t_old = breakpoint.first;
+        }
+        dt_min = (std::max)(dt_min, 0.0);
+        t_old += dt_min;
+        for (size_t i = 0; i < n; ++i) {
+            if (is_free[i]) x_cp[i] = clamp(i, x[i] + t_old * d[i]);
+        }
+        for (size_t k = 0; k < k2; ++k) c[k] += dt_min * p[k];
+
+        //      ( ):
+        // r = Z^T (g + theta (x_cp - x) - W M c), d_u = -B_z^{-1} r
+        //   --,    
+        apply_m(c, mc);
+        for (size_t k = 0; k < k2; ++k) {
+            v[k] = 0.0;
+            for (size_t j = 0; j < k2; ++j) wzw[k * k2 + j] = 0.0;
+        }
+        size_t free_count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (!is_free[i]) continue;
+            ++free_count;
+            w_row(i, w.data());
+            r[i] = grad[i] + theta * (x_cp[i] - x[i]);
+            for (size_t k = 0; k < k2; ++k) r[i] -= w[k] * mc[k];
+            for (size_t k = 0; k < k2; ++k) {
+                v[k] += w[k] * r[i];
+                for (size_t j = 0; j < k2; ++j) wzw[k * k2 + j] += w[k] * w[j];
+            }
+        }
+        if (free_count > 0) {
+            bool solved = true;
+            if (k2 > 0) {
+                // (I - M W_z^T W_z / theta) u = M W_z^T r
+                for (size_t j = 0; j < k2; ++j) {
+                    for (size_t k = 0; k < k2; ++k) w[k] = wzw[k * k2 + j];
+                    apply_m(w, mw);
+                    for (size_t k = 0; k < k2; ++k) {
+                        reduced[k * k2 + j] = (k == j ? 1.0 : 0.0) - mw[k] / theta;
+                    }
+                }
+                apply_m(v, mw);
+                v = mw;
+                solved = luFactor(reduced.data(), k2, reduced_pivot.data());
+                if (solved) luSolve(reduced.data(), k2, reduced_pivot.data(), v.data());
+            }
+            if (solved) {
+                double alpha = 1.0;
+                for (size_t i = 0; i < n; ++i) {
+                    if (!is_free[i]) continue;
+                    w_row(i, w.data());
+                    double du = -r[i] / theta;
+                    for (size_t k = 0; k < k2; ++k) du -= w[k] * v[k] / (theta * theta);
+                    r[i] = du;
+                    if (du > 0.0) alpha = (std::min)(alpha, (ub[i] - x_cp[i]) / du);
+                    else if (du < 0.0) alpha = (std::min)(alpha, (lb[i] - x_cp[i]) / du);
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    if (is_free[i]) x_cp[i] = clamp(i, x_cp[i] + alpha * r[i]);
+                }
+            }
         }
 
-        // Fletcher-Reeves beta
-        double grad_norm_sq_old = 0.0, grad_norm_sq_new = 0.0;
-        for (size_t i = 0; i < grad.size(); ++i) {
-            grad_norm_sq_old += grad[i] * grad[i];
-            grad_norm_sq_new += grad_new[i] * grad_new[i];
+        //    ;     (
+        // ),      
+        double slope = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            d[i] = x_cp[i] - x[i];
+            slope += grad[i] * d[i];
+        }
+        if (!(slope < 0.0)) {
+            stored = 0;
+            theta = 1.0;
+            slope = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                d[i] = clamp(i, x[i] - grad[i]) - x[i];
+                slope += grad[i] * d[i];
+            }
         }
 
-        double beta = 0.0;
-        if (grad_norm_sq_old > 0) {
-            beta = grad_norm_sq_new / grad_norm_sq_old;
+        //   ;  1       
+        double step = 1.0;
+        if (stored == 0) {
+            double d_norm = 0.0;
+            for (double di : d) d_norm += di * di;
+            step = (std::min)(1.0, 1.0 / std::sqrt(d_norm));
+        }
+        double lo = 0.0, hi = 1.0;
+        bool bracketed = false;
+        double f_new = f_val;
+        bool accepted = false;
+        for (int k = 0; k < max_line_search_iter; ++k) {
+            for (size_t i = 0; i < n; ++i) x_new[i] = clamp(i, x[i] + step * d[i]);
+            f_new = evaluateWithGradient(*func, x_new, grad_new, fdOptions);
+            if (!(f_new <= f_val + wolfe_c1 * step * slope)) {
+                hi = step;
+                bracketed = true;
+            }
+            else {
+                double new_slope = 0.0;
+                for (size_t i = 0; i < n; ++i) new_slope += grad_new[i] * d[i];
+                if (new_slope >= wolfe_c2 * slope || step >= 1.0) {
+                    accepted = true;
+                    break;
+                }
+                lo = step;
+            }
+            step = bracketed ? 0.5 * (lo + hi) : (std::min)(2.0 * lo, hi);
+        }
+        if (!accepted) {
+            //   L-BFGS-B:     
+            if (stored > 0) {
+                stored = 0;
+                theta = 1.0;
+                continue;
+            }
+            return { x, f_val, iteration, "Line search failed", trajectory };
         }
 
-        //  
-        for (size_t i = 0; i < p.size(); ++i) {
-            p[i] = -grad_new[i] + beta * p[i];
+        //      ,   
+        double s_y = 0.0, y_y = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double dg = grad_new[i] - grad[i];
+            s_y += (x_new[i] - x[i]) * dg;
+            y_y += dg * dg;
         }
-        x = x_new;
-        f_val = f_val_new;
-        grad = grad_new;
+        if (s_y > std::numeric_limits<double>::epsilon() * y_y) {
+            const size_t row = stored < m ? row_of(stored) : head;
+            for (size_t i = 0; i < n; ++i) {
+                s_hist[row * n + i] = x_new[i] - x[i];
+                y_hist[row * n + i] = grad_new[i] - grad[i];
+            }
+            if (stored < m) ++stored;
+            else head = (head + 1) % m;
+
+            const double* s_row = &s_hist[row * n];
+            const double* y_row = &y_hist[row * n];
+            for (size_t k = 0; k < stored; ++k) {
+                const size_t other = row_of(k);
+                const double* s_other = &s_hist[other * n];
+                const double* y_other = &y_hist[other * n];
+                double sy_row = 0.0, sy_other = 0.0, ss_pair = 0.0;
+                for (size_t i = 0; i < n; ++i) {
+                    sy_row += s_row[i] * y_other[i];
+                    sy_other += s_other[i] * y_row[i];
+                    ss_pair += s_row[i] * s_other[i];
+                }
+                sy[row * m + other] = sy_row;
+                sy[other * m + row] = sy_other;
+                ss[row * m + other] = ss_pair;
+                ss[other * m + row] = ss_pair;
+            }
+            theta = y_y / s_y;
+        }
+
+        x.swap(x_new);
+        grad.swap(grad_new);
+        f_val = f_new;
+        addPointToTrajectory(x);
         iteration++;
     }
-    addPointToTrajectory(best_x);
 
-    return { best_x, best_f_val, iteration, "Criterial satisfied", trajectory };
-}
\ No newline at end of file
+    return { x, f_val, iteration, "Criterial satisfied", trajectory };
+}
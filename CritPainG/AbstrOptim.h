@@ -3,11 +3,17 @@
 
 #include "AbstrFunc.h"
 #include "AbstrCriterial.h"
+#include "CountingFunc.h"
+#include "FiniteDifference.h"
+#include "LineSearch.h"
 #include <vector>
 #include <memory>
 #include <random>
 #include <deque>
 
+//     ,     
+constexpr int MaxI = 100000;
+
 class AbstrOptim {
 public:
     struct Result {
@@ -16,23 +22,35 @@ public:
         int iterations;
         std::string stop_reason;
         std::deque<std::vector<double>> trajectory;  
+        //   optimize()   CountingFunc
+        long long function_evaluations;  //  fd_evaluations
+        long long gradient_evaluations;
+        long long fd_evaluations;        //    
+        long long hessian_vector_products;
 
-        Result() : value(0.0), iterations(0), stop_reason("") {}
+        Result() : value(0.0), iterations(0), stop_reason(""),
+            function_evaluations(0), gradient_evaluations(0), fd_evaluations(0), hessian_vector_products(0) {}
         Result(const std::vector<double>& p, double v, int iter,
             const std::string& reason, const std::deque<std::vector<double>>& traj)
-            : point(p), value(v), iterations(iter), stop_reason(reason), trajectory(traj) {}
+            : point(p), value(v), iterations(iter), stop_reason(reason), trajectory(traj),
+            function_evaluations(0), gradient_evaluations(0), fd_evaluations(0), hessian_vector_products(0) {}
     };
 protected:
+    //     counter, func   
     const AbstrFunc* func;
+    CountingFunc counter;
     std::unique_ptr<const AbstrCriterial> criterial;
     std::vector<double> initialPoint;
     std::deque<std::vector<double>> trajectory;  
+    //      
+    FiniteDifferenceOptions fdOptions;
 
 public:
     AbstrOptim(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
         const std::vector<double>& x0);
     virtual ~AbstrOptim() = default;
-    virtual Result optimize() = 0;
+    //  ,  run()     
+    Result optimize();
 
     const AbstrCriterial* getCriterial() const { return criterial.get(); }
     const AbstrFunc* getFunc() const { return func; }
@@ -41,6 +59,14 @@ public:
 
     void clearTrajectory() { trajectory.clear(); }  
     void addPointToTrajectory(const std::vector<double>& point) { trajectory.push_back(point); }    
+    EvaluationCounts getEvaluationCounts() const { return counter.counts(); }
+
+    void setFiniteDifferenceOptions(const FiniteDifferenceOptions& options) { fdOptions = options; }
+    const FiniteDifferenceOptions& getFiniteDifferenceOptions() const { return fdOptions; }
+
+protected:
+    //   
+    virtual Result run() = 0;
 };
 
 class RandomSearchOptim : public AbstrOptim {
@@ -51,37 +77,28 @@ private:
     mutable std::mt19937 gen;
     double p;
     double alpha;
+    size_t local_coordinates;  //    ; 0 - 
 public:
     RandomSearchOptim(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
         const std::vector<double>& x0, const std::vector<double>& lb,
         const std::vector<double>& ub, double d, unsigned int seed = std::random_device{}(), double p_value = 0.2, double alpha_value = 0.8);
-    Result optimize() override;
+    //    k    .  
+    //       O(k) (AbstrFunc::updateValue).
+    void setLocalCoordinates(size_t k) { local_coordinates = k; }
+    size_t getLocalCoordinates() const { return local_coordinates; }
+protected:
+    Result run() override;
 };
 
 
-class ConjugateGradientFR : public AbstrOptim {
-private:
-    double line_search_tolerance;
-    int max_line_search_iter;
-    double grad_epsilon;
-    double line_search(const std::vector<double>& x, const std::vector<double>& p) const;
-
-public:
-    ConjugateGradientFR(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
-        const std::vector<double>& x0, double ls_tolerance = 1e-6,
-        int max_ls_iter = 100, double grad_eps = 1e-8);
-    Result optimize() override;
-};
-
 class ConjugateGradientFRConstrained : public AbstrOptim {
 private:
     std::vector<double> lower_bounds;
     std::vector<double> upper_bounds;
-    double line_search_tolerance; //    (1e-6)
-    int max_line_search_iter;
     double grad_epsilon; //    (1e-8)
+    //       
+    std::unique_ptr<LineSearch> lineSearch;
 
-    double line_search(const std::vector<double>& x, const std::vector<double>& p) const;
     std::vector<double> projectToBounds(const std::vector<double>& x) const;
 
 public:
@@ -89,6 +106,85 @@ public:
         const std::vector<double>& x0, const std::vector<double>& lb,
         const std::vector<double>& ub, double ls_tolerance = 1e-6,
         int max_ls_iter = 100, double grad_eps = 1e-8);
-    Result optimize() override;
+
+    void setLineSearch(std::unique_ptr<LineSearch> ls);
+    const LineSearch* getLineSearch() const { return lineSearch.get(); }
+protected:
+    Result run() override;
+};
+
+//    (Newton-CG)  .
+//  -   H p = -g   ,
+//     H v (AbstrFunc::hessianVectorProduct);
+//   .  CG   ||H p + g|| < eta ||g||,
+// eta = min(0.5, sqrt(||g||)) ( ),   
+// .      .
+class NewtonCG : public AbstrOptim {
+private:
+    double grad_epsilon;
+    int max_cg_iter;        // 0 -  
+    double armijo_c1;
+
+    std::vector<double> solveNewtonSystem(const std::vector<double>& x, const std::vector<double>& grad, int& cg_iterations) const;
+
+public:
+    NewtonCG(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, double grad_eps = 1e-8, int max_cg = 0, double c1 = 1e-4);
+
+protected:
+    Result run() override;
+};
+
+//  L-BFGS  :     
+// history  (s = x_{k+1} - x_k, y = g_{k+1} - g_k)  .
+//     ,     run();  
+//  .  -      (c1, c2), 
+//  s'y > 0;      .
+class LBFGS : public AbstrOptim {
+private:
+    int history;
+    double grad_epsilon;
+    double wolfe_c1;
+    double wolfe_c2;
+
+public:
+    LBFGS(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, int m = 10, double grad_eps = 1e-8,
+        double c1 = 1e-4, double c2 = 0.9);
+
+    int getHistorySize() const { return history; }
+
+protected:
+    Result run() override;
+};
+
+// L-BFGS-B (Byrd, Lu, Nocedal, Zhu)  -.
+//  -  L-BFGS- B = theta I - W M W^T  history
+// .  :    (   
+//     )   ,
+//          
+// .    ConjugateGradientFRConstrained,   
+//  ,       .  - 
+//      .  -  
+//  .
+class LBFGSB : public AbstrOptim {
+private:
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    int history;
+    double grad_epsilon;
+    double wolfe_c1;
+    double wolfe_c2;
+
+public:
+    LBFGSB(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, const std::vector<double>& lb,
+        const std::vector<double>& ub, int m = 10, double grad_eps = 1e-8,
+        double c1 = 1e-4, double c2 = 0.9);
+
+    int getHistorySize() const { return history; }
+
+protected:
+    Result run() override;
 };
 #endif
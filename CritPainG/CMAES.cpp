@@ -0,0 +1,380 @@
+﻿#include "pch.h"
+#include "CMAES.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+// Собственные значения и векторы симметричной матрицы a (n x n по строкам)
+// циклическим методом Якоби; a разрушается, столбец k матрицы v - вектор
+// значения d[k]
+void jacobiEigen(std::vector<double>& a, size_t n, std::vector<double>& v, std::vector<double>& d) {
+    std::fill(v.begin(), v.end(), 0.0);
+    for (size_t i = 0; i < n; ++i) v[i * n + i] = 1.0;
+
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double off = 0.0, diag = 0.0;
+        for (size_t p = 0; p < n; ++p) {
+            diag += a[p * n + p] * a[p * n + p];
+            for (size_t q = p + 1; q < n; ++q) off += a[p * n + q] * a[p * n + q];
+        }
+        if (off <= 1e-30 * diag) break;
+
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t q = p + 1; q < n; ++q) {
+                const double apq = a[p * n + q];
+                if (apq == 0.0) continue;
+                const double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                    (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+                for (size_t k = 0; k < n; ++k) {
+                    const double akp = a[k * n + p], akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                double* rp = &a[p * n];
+                double* rq = &a[q * n];
+                for (size_t k = 0; k < n; ++k) {
+                    const double apk = rp[k], aqk = rq[k];
+                    rp[k] = c * apk - s * aqk;
+                    rq[k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    const double vkp = v[k * n + p], vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < n; ++i) d[i] = a[i * n + i];
+}
+
+// NaN сортируется как худшее значение
+bool lessFitness(double a, double b) {
+    if (std::isnan(b)) return !std::isnan(a);
+    return a < b;
+}
+
+} // namespace
+
+struct CMAES::RunOutcome {
+    enum Reason { Converged, CriterialSatisfied, MaxIterations } reason;
+    long long evaluations;
+};
+
+CMAES::CMAES(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, const std::vector<double>& lb,
+    const std::vector<double>& ub, double sigma0, CMAESRestart restart,
+    unsigned int seed, int max_restarts)
+    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub),
+    sigma_fraction(sigma0), restart_strategy(restart), max_restarts(max_restarts),
+    population_size(0), gen(seed), restarts(0), last_population(0) {
+    if (x0.empty()) {
+        throw std::invalid_argument("Initial point must not be empty.");
+    }
+    if (!(sigma0 > 0.0)) {
+        throw std::invalid_argument("Initial step sigma0 must be positive.");
+    }
+    if (max_restarts < 0) {
+        throw std::invalid_argument("Maximum number of restarts must be non-negative.");
+    }
+    if (lb.empty() && ub.empty()) {
+        return;
+    }
+    if (lb.size() != ub.size() || lb.size() != x0.size()) {
+        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+    }
+    for (size_t i = 0; i < lb.size(); ++i) {
+        if (lb[i] > ub[i]) {
+            throw std::invalid_argument("Lower bound must be <= upper bound.");
+        }
+        if (x0[i] < lb[i] || x0[i] > ub[i]) {
+            throw std::invalid_argument("Initial point must be inside the box D.");
+        }
+    }
+}
+
+void CMAES::setPopulationSize(int lambda) {
+    if (lambda != 0 && lambda < 2) {
+        throw std::invalid_argument("Population size must be 0 (default) or at least 2.");
+    }
+    population_size = lambda;
+}
+
+AbstrOptim::Result CMAES::run() {
+    trajectory.clear();
+    restarts = 0;
+    const size_t n = initialPoint.size();
+
+    double scale;
+    if (!lower_bounds.empty()) {
+        double width = 0.0;
+        for (size_t i = 0; i < n; ++i) width += upper_bounds[i] - lower_bounds[i];
+        scale = width / static_cast<double>(n);
+    }
+    else {
+        scale = 0.0;
+        for (double xi : initialPoint) scale = (std::max)(scale, std::fabs(xi));
+        scale = (std::max)(scale, 1.0);
+    }
+    const double sigma0 = sigma_fraction * scale;
+    const int default_lambda = population_size > 0 ? population_size
+        : 4 + static_cast<int>(3.0 * std::log(static_cast<double>(n)));
+
+    std::vector<double> best_point = initialPoint;
+    double best_value = (*func)(initialPoint);
+    addPointToTrajectory(best_point);
+    int iteration = 0;
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto randomStart = [&]() {
+        if (lower_bounds.empty()) return initialPoint;
+        std::vector<double> x(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = lower_bounds[i] + uniform(gen) * (upper_bounds[i] - lower_bounds[i]);
+        }
+        return x;
+    };
+
+    // BIPOP: бюджеты вычислений режимов; следующий запуск - в режиме с меньшим
+    long long large_budget = 0, small_budget = 0;
+    int large_runs = 0;
+    int lambda = default_lambda;
+    double sigma = sigma0;
+    std::vector<double> start = initialPoint;
+    bool large = true;
+
+    for (;;) {
+        last_population = lambda;
+        const RunOutcome outcome = runOnce(start, sigma, lambda, iteration, best_point, best_value);
+        if (outcome.reason == RunOutcome::CriterialSatisfied) {
+            return { best_point, best_value, iteration, "Criterial satisfied", trajectory };
+        }
+        if (outcome.reason == RunOutcome::MaxIterations) {
+            return { best_point, best_value, iteration,
+                     "Fallback: reached maximum iterations", trajectory };
+        }
+        if (restart_strategy == CMAESRestart::None) {
+            return { best_point, best_value, iteration,
+                     "Search distribution converged", trajectory };
+        }
+        (large ? large_budget : small_budget) += outcome.evaluations;
+
+        large = restart_strategy == CMAESRestart::IPOP || large_budget <= small_budget;
+        if (large) {
+            if (large_runs >= max_restarts) {
+                return { best_point, best_value, iteration,
+                         "Restart limit reached", trajectory };
+            }
+            ++large_runs;
+            lambda = default_lambda << large_runs;
+            sigma = sigma0;
+        }
+        else {
+            // Малая популяция и малый шаг: lambda_def (lambda_large / 2 lambda_def)^(u^2), sigma0 10^(-2u)
+            const double u = uniform(gen);
+            const double ratio = 0.5 * static_cast<double>(default_lambda << large_runs) / default_lambda;
+            lambda = (std::max)(default_lambda,
+                static_cast<int>(default_lambda * std::pow(ratio, u * u)));
+            sigma = sigma0 * std::pow(10.0, -2.0 * uniform(gen));
+        }
+        start = randomStart();
+        ++restarts;
+    }
+}
+
+CMAES::RunOutcome CMAES::runOnce(const std::vector<double>& start, double sigma0, int lambda_value,
+    int& iteration, std::vector<double>& best_point, double& best_value) {
+    const size_t n = start.size();
+    const double dn = static_cast<double>(n);
+    const size_t lambda = static_cast<size_t>(lambda_value);
+    const size_t mu = lambda / 2;
+    const long long evaluations_before = counter.counts().values;
+
+    // Веса отбора и параметры адаптации (значения по умолчанию Хансена)
+    std::vector<double> weights(mu);
+    for (size_t k = 0; k < mu; ++k) {
+        weights[k] = std::log(static_cast<double>(mu) + 0.5) - std::log(static_cast<double>(k + 1));
+    }
+    const double weight_sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double weight_sq = 0.0;
+    for (double& w : weights) {
+        w /= weight_sum;
+        weight_sq += w * w;
+    }
+    const double mueff = 1.0 / weight_sq;
+    const double cc = (4.0 + mueff / dn) / (dn + 4.0 + 2.0 * mueff / dn);
+    const double cs = (mueff + 2.0) / (dn + mueff + 5.0);
+    const double c1 = 2.0 / ((dn + 1.3) * (dn + 1.3) + mueff);
+    const double cmu = (std::min)(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((dn + 2.0) * (dn + 2.0) + mueff));
+    const double damps = 1.0 + 2.0 * (std::max)(0.0, std::sqrt((mueff - 1.0) / (dn + 1.0)) - 1.0) + cs;
+    const double chi_n = std::sqrt(dn) * (1.0 - 1.0 / (4.0 * dn) + 1.0 / (21.0 * dn * dn));
+    const int eigen_gap = (std::max)(1, static_cast<int>(1.0 / ((c1 + cmu) * dn * 10.0)));
+
+    std::vector<double> mean = start;
+    double sigma = sigma0;
+    std::vector<double> C(n * n, 0.0), B(n * n, 0.0), work(n * n);
+    std::vector<double> D(n, 1.0), eigenvalues(n);
+    for (size_t i = 0; i < n; ++i) {
+        C[i * n + i] = 1.0;
+        B[i * n + i] = 1.0;
+    }
+    std::vector<double> pc(n, 0.0), ps(n, 0.0);
+
+    // Поколение: Y - шаги (x - m) / sigma по строкам, X - точки в раскладке SoA
+    std::vector<double> Y(lambda * n), X(n * lambda), fitness(lambda);
+    std::vector<double> z(n), yw(n), tmp(n);
+    std::vector<size_t> index(lambda);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    // Лучшие значения последних поколений для остановки по значению
+    const size_t history_length = 10 + static_cast<size_t>(std::ceil(30.0 * dn / lambda));
+    std::vector<double> history;
+    history.reserve(history_length);
+    size_t history_pos = 0;
+    const double tol_fun = 1e-12;
+    const double tol_x = 1e-12 * sigma0;
+    const long long max_generations = 100 + static_cast<long long>(50.0 * (dn + 3.0) * (dn + 3.0) / std::sqrt(static_cast<double>(lambda)));
+
+    for (long long generation = 0; ; ++generation) {
+        if (criterial->isSatisfied(best_point, best_value, iteration)) {
+            return { RunOutcome::CriterialSatisfied, counter.counts().values - evaluations_before };
+        }
+        if (iteration >= MaxI) {
+            return { RunOutcome::MaxIterations, counter.counts().values - evaluations_before };
+        }
+
+        // Выборка: y = B (D z), x = m + sigma y с проекцией на границы
+        for (size_t k = 0; k < lambda; ++k) {
+            for (size_t j = 0; j < n; ++j) z[j] = D[j] * normal(gen);
+            double* y = &Y[k * n];
+            for (size_t i = 0; i < n; ++i) {
+                const double* row = &B[i * n];
+                double s = 0.0;
+                for (size_t j = 0; j < n; ++j) s += row[j] * z[j];
+                double x = mean[i] + sigma * s;
+                if (!lower_bounds.empty()) {
+                    x = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], x));
+                    s = (x - mean[i]) / sigma;
+                }
+                y[i] = s;
+                X[i * lambda + k] = x;
+            }
+        }
+        evaluatePopulation(*func, X.data(), n, lambda, fitness.data(), populationOptions);
+
+        std::iota(index.begin(), index.end(), size_t(0));
+        std::sort(index.begin(), index.end(),
+            [&](size_t a, size_t b) { return lessFitness(fitness[a], fitness[b]); });
+        const double generation_best = fitness[index[0]];
+        if (generation_best < best_value) {
+            best_value = generation_best;
+            for (size_t i = 0; i < n; ++i) best_point[i] = X[i * lambda + index[0]];
+            addPointToTrajectory(best_point);
+        }
+        ++iteration;
+
+        // Среднее
+        std::fill(yw.begin(), yw.end(), 0.0);
+        for (size_t k = 0; k < mu; ++k) {
+            const double* y = &Y[index[k] * n];
+            for (size_t i = 0; i < n; ++i) yw[i] += weights[k] * y[i];
+        }
+        for (size_t i = 0; i < n; ++i) mean[i] += sigma * yw[i];
+
+        // Пути: ps по C^(-1/2) yw = B D^-1 B^T yw, pc по yw
+        std::fill(tmp.begin(), tmp.end(), 0.0);
+        for (size_t i = 0; i < n; ++i) {
+            const double* row = &B[i * n];
+            for (size_t j = 0; j < n; ++j) tmp[j] += row[j] * yw[i];
+        }
+        for (size_t j = 0; j < n; ++j) tmp[j] /= D[j];
+        const double cs_norm = std::sqrt(cs * (2.0 - cs) * mueff);
+        double ps_norm_sq = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double* row = &B[i * n];
+            double s = 0.0;
+            for (size_t j = 0; j < n; ++j) s += row[j] * tmp[j];
+            ps[i] = (1.0 - cs) * ps[i] + cs_norm * s;
+            ps_norm_sq += ps[i] * ps[i];
+        }
+        const double ps_norm = std::sqrt(ps_norm_sq);
+        const double hsig_threshold = (1.4 + 2.0 / (dn + 1.0)) * chi_n *
+            std::sqrt(1.0 - std::pow(1.0 - cs, 2.0 * static_cast<double>(generation + 1)));
+        const double hsig = ps_norm < hsig_threshold ? 1.0 : 0.0;
+        const double cc_norm = std::sqrt(cc * (2.0 - cc) * mueff);
+        for (size_t i = 0; i < n; ++i) pc[i] = (1.0 - cc) * pc[i] + hsig * cc_norm * yw[i];
+
+        // Ковариация: верхний треугольник по строкам, затем отражение
+        const double decay = 1.0 - c1 - cmu + (1.0 - hsig) * c1 * cc * (2.0 - cc);
+        for (size_t i = 0; i < n; ++i) {
+            double* row = &C[i * n];
+            const double pci = c1 * pc[i];
+            for (size_t j = i; j < n; ++j) row[j] = decay * row[j] + pci * pc[j];
+            for (size_t k = 0; k < mu; ++k) {
+                const double* y = &Y[index[k] * n];
+                const double coef = cmu * weights[k] * y[i];
+                for (size_t j = i; j < n; ++j) row[j] += coef * y[j];
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) C[j * n + i] = C[i * n + j];
+        }
+
+        sigma *= std::exp((std::min)(1.0, (cs / damps) * (ps_norm / chi_n - 1.0)));
+
+        bool eigen_updated = false;
+        if ((generation + 1) % eigen_gap == 0) {
+            work = C;
+            jacobiEigen(work, n, B, eigenvalues);
+            for (size_t j = 0; j < n; ++j) D[j] = std::sqrt((std::max)(eigenvalues[j], 1e-300));
+            eigen_updated = true;
+        }
+
+        // Остановка запуска
+        if (history.size() < history_length) {
+            history.push_back(generation_best);
+        }
+        else {
+            history[history_pos] = generation_best;
+            history_pos = (history_pos + 1) % history_length;
+        }
+        const auto range = std::minmax_element(history.begin(), history.end());
+        const double population_range = fitness[index[lambda - 1]] - generation_best;
+        if (history.size() == history_length && *range.second - *range.first < tol_fun &&
+            population_range < tol_fun) {
+            return { RunOutcome::Converged, counter.counts().values - evaluations_before };
+        }
+        bool small_steps = true;
+        for (size_t i = 0; i < n && small_steps; ++i) {
+            small_steps = sigma * std::sqrt(C[i * n + i]) < tol_x && sigma * std::fabs(pc[i]) < tol_x;
+        }
+        if (small_steps) {
+            return { RunOutcome::Converged, counter.counts().values - evaluations_before };
+        }
+        if (eigen_updated) {
+            const auto extremes = std::minmax_element(D.begin(), D.end());
+            if (*extremes.second > 1e7 * *extremes.first) {
+                return { RunOutcome::Converged, counter.counts().values - evaluations_before };
+            }
+            // Шаг 0.1 sigma вдоль главной оси не меняет среднее
+            const size_t axis = static_cast<size_t>(generation / eigen_gap) % n;
+            bool no_effect = true;
+            for (size_t i = 0; i < n && no_effect; ++i) {
+                no_effect = mean[i] + 0.1 * sigma * D[axis] * B[i * n + axis] == mean[i];
+            }
+            if (no_effect) {
+                return { RunOutcome::Converged, counter.counts().values - evaluations_before };
+            }
+        }
+        if (generation + 1 >= max_generations || !std::isfinite(sigma)) {
+            return { RunOutcome::Converged, counter.counts().values - evaluations_before };
+        }
+    }
+}
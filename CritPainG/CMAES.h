@@ -0,0 +1,70 @@
+﻿#ifndef CMAES_H
+#define CMAES_H
+
+#include "AbstrOptim.h"
+#include "Population.h"
+#include <random>
+#include <vector>
+
+// Перезапуски CMA-ES после сходимости распределения
+enum class CMAESRestart {
+    None,   // один запуск
+    IPOP,   // каждый перезапуск с вдвое большей популяцией
+    BIPOP   // чередование больших популяций IPOP и малых со случайными lambda и sigma
+};
+
+// CMA-ES (Хансен): поколение из lambda точек m + sigma B D z, z ~ N(0, I);
+// среднее и ковариация C = B D^2 B^T обновляются по mu лучшим точкам, шаг sigma -
+// по длине пути ps. Итерация - одно поколение.
+//
+// Поколение вычисляется одним пакетом SoA через evaluatePopulation (части
+// пакета - в потоках ThreadPool::shared()). C, B и выборка поколения - плотные
+// матрицы по строкам в одном буфере; обновление ранга mu - сумма обновлений
+// ранга 1 по строкам верхнего треугольника, так что внутренний цикл идёт по
+// памяти подряд. Собственные векторы C (Якоби) пересчитываются не каждое
+// поколение, а раз в 1 / (10 n (c1 + cmu)) поколений.
+//
+// Ограничения - параллелепипед lb, ub: точка вне его заменяется проекцией, и
+// обновление идёт по исправленной точке. Начальный шаг sigma0 - доля средней
+// ширины параллелепипеда (без ограничений - доля max(|x0|, 1)).
+//
+// Запуск заканчивается, когда значения поколений перестали меняться, шаг
+// сократился в 1e12 раз, C выродилась или шаг вдоль оси не меняет среднее.
+// Перезапуски начинают со случайной точки параллелепипеда (без ограничений - с
+// x0) и идут, пока не выполнен критерий или не исчерпано max_restarts
+// перезапусков с большой популяцией.
+class CMAES : public AbstrOptim {
+private:
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    double sigma_fraction;
+    CMAESRestart restart_strategy;
+    int max_restarts;
+    int population_size;  // 0 - 4 + 3 ln n
+    PopulationOptions populationOptions;
+    std::mt19937 gen;
+    int restarts;
+    int last_population;
+
+    struct RunOutcome;
+    RunOutcome runOnce(const std::vector<double>& start, double sigma0, int lambda,
+        int& iteration, std::vector<double>& best_point, double& best_value);
+
+public:
+    CMAES(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, const std::vector<double>& lb,
+        const std::vector<double>& ub, double sigma0 = 0.3,
+        CMAESRestart restart = CMAESRestart::BIPOP, unsigned int seed = std::random_device{}(),
+        int max_restarts = 9);
+
+    void setPopulationSize(int lambda);
+    void setPopulationOptions(const PopulationOptions& options) { populationOptions = options; }
+    // Перезапусков и размер популяции последнего запуска
+    int getRestartCount() const { return restarts; }
+    int getLastPopulationSize() const { return last_population; }
+
+protected:
+    Result run() override;
+};
+
+#endif
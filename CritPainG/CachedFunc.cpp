@@ -0,0 +1,299 @@
+﻿#include "pch.h"
+#include "CachedFunc.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+inline uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+size_t roundUpPow2(size_t v) {
+    size_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+CachedFunc::CachedFunc(const AbstrFunc* f, size_t capacity, int stripeCount, size_t maxBytes)
+    : func(f), dimension(0), bucketsPerStripe(0), stripeCount(0), hitCount(0), missCount(0) {
+    if (!f) {
+        throw std::invalid_argument("CachedFunc requires a function.");
+    }
+    init(capacity, stripeCount, maxBytes);
+}
+
+CachedFunc::CachedFunc(std::unique_ptr<AbstrFunc> f, size_t capacity, int stripeCount, size_t maxBytes)
+    : owned(std::move(f)), func(owned.get()), dimension(0), bucketsPerStripe(0), stripeCount(0),
+    hitCount(0), missCount(0) {
+    if (!func) {
+        throw std::invalid_argument("CachedFunc requires a function.");
+    }
+    init(capacity, stripeCount, maxBytes);
+}
+
+void CachedFunc::init(size_t capacity, int count, size_t maxBytes) {
+    if (capacity == 0 || count <= 0) {
+        throw std::invalid_argument("Cache capacity and stripe count must be positive.");
+    }
+    dimension = func->getDimension();
+
+    // Не больше maxBytes на все слоты, но хотя бы одна корзина
+    const size_t slotBytes = sizeof(Slot) + 2 * sizeof(double) * static_cast<size_t>((std::max)(dimension, 1));
+    const size_t maxSlots = (std::max)(static_cast<size_t>(WAYS), maxBytes / slotBytes);
+    capacity = (std::min)(capacity, maxSlots);
+    stripeCount = static_cast<int>((std::min)(static_cast<size_t>(count), (std::max)(static_cast<size_t>(1), capacity / WAYS)));
+
+    const size_t perStripe = (capacity + stripeCount - 1) / stripeCount;
+    bucketsPerStripe = roundUpPow2((perStripe + WAYS - 1) / WAYS);
+    while (bucketsPerStripe > 1 && static_cast<size_t>(stripeCount) * bucketsPerStripe * WAYS > maxSlots) {
+        bucketsPerStripe >>= 1;
+    }
+    stripes.reset(new Stripe[stripeCount]);
+}
+
+size_t CachedFunc::capacity() const {
+    return static_cast<size_t>(stripeCount) * bucketsPerStripe * WAYS;
+}
+
+void CachedFunc::clear() {
+    for (int s = 0; s < stripeCount; ++s) {
+        std::lock_guard<std::mutex> lock(stripes[s].mutex);
+        for (Slot& slot : stripes[s].slots) {
+            slot.used = false;
+        }
+    }
+    hitCount = 0;
+    missCount = 0;
+}
+
+uint64_t CachedFunc::hashPoint(const double* x) const {
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    for (int j = 0; j < dimension; ++j) {
+        uint64_t bits;
+        std::memcpy(&bits, x + j, sizeof(bits));
+        h = mix(h ^ bits) + 0x9E3779B97F4A7C15ull;
+    }
+    return h;
+}
+
+CachedFunc::Stripe& CachedFunc::stripeFor(uint64_t hash) const {
+    return stripes[static_cast<size_t>(hash % static_cast<uint64_t>(stripeCount))];
+}
+
+size_t CachedFunc::bucketFor(uint64_t hash) const {
+    return static_cast<size_t>(hash >> 32) & (bucketsPerStripe - 1);
+}
+
+int CachedFunc::find(const Stripe& s, uint64_t hash, const double* x) const {
+    if (s.slots.empty()) {
+        return -1;
+    }
+    const size_t first = bucketFor(hash) * WAYS;
+    for (int w = 0; w < WAYS; ++w) {
+        const size_t i = first + w;
+        const Slot& slot = s.slots[i];
+        if (slot.used && slot.hash == hash &&
+            std::memcmp(&s.coords[i * dimension], x, sizeof(double) * dimension) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool CachedFunc::lookup(const double* x, double* value, double* grad) const {
+    const uint64_t hash = hashPoint(x);
+    Stripe& s = stripeFor(hash);
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        const int i = find(s, hash, x);
+        if (i >= 0 && (!value || s.slots[i].hasValue) && (!grad || s.slots[i].hasGradient)) {
+            if (value) {
+                *value = s.slots[i].value;
+            }
+            if (grad) {
+                std::copy(&s.grads[i * dimension], &s.grads[i * dimension] + dimension, grad);
+            }
+            hitCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    missCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void CachedFunc::store(const double* x, const double* value, const double* grad) const {
+    const uint64_t hash = hashPoint(x);
+    Stripe& s = stripeFor(hash);
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    const size_t slotsPerStripe = bucketsPerStripe * WAYS;
+    if (s.slots.empty()) {
+        const Slot empty = { 0, 0.0, false, false, false };
+        s.slots.assign(slotsPerStripe, empty);
+        s.coords.assign(slotsPerStripe * dimension, 0.0);
+    }
+    if (grad && s.grads.empty()) {
+        s.grads.assign(slotsPerStripe * dimension, 0.0);
+    }
+
+    int i = find(s, hash, x);
+    if (i < 0) {
+        // Свободный слот корзины, иначе циклическое вытеснение
+        const size_t first = bucketFor(hash) * WAYS;
+        for (int w = 0; w < WAYS && i < 0; ++w) {
+            if (!s.slots[first + w].used) i = static_cast<int>(first + w);
+        }
+        if (i < 0) {
+            i = static_cast<int>(first + (s.victim++ % WAYS));
+        }
+        Slot& slot = s.slots[i];
+        slot.used = true;
+        slot.hash = hash;
+        slot.hasValue = false;
+        slot.hasGradient = false;
+        std::copy(x, x + dimension, &s.coords[i * dimension]);
+    }
+
+    Slot& slot = s.slots[i];
+    if (value) {
+        slot.value = *value;
+        slot.hasValue = true;
+    }
+    if (grad) {
+        std::copy(grad, grad + dimension, &s.grads[i * dimension]);
+        slot.hasGradient = true;
+    }
+}
+
+double CachedFunc::operator()(const std::vector<double>& x) const {
+    if (static_cast<int>(x.size()) != dimension) {
+        return (*func)(x);  // пусть обёрнутая функция сообщит об ошибке
+    }
+    double value;
+    if (lookup(x.data(), &value, nullptr)) {
+        return value;
+    }
+    value = (*func)(x);
+    store(x.data(), &value, nullptr);
+    return value;
+}
+
+std::vector<double> CachedFunc::getGradient(const std::vector<double>& x) const {
+    if (static_cast<int>(x.size()) != dimension) {
+        return func->getGradient(x);
+    }
+    std::vector<double> grad(dimension);
+    if (lookup(x.data(), nullptr, grad.data())) {
+        return grad;
+    }
+    grad = func->getGradient(x);
+    store(x.data(), nullptr, grad.data());
+    return grad;
+}
+
+double CachedFunc::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    if (static_cast<int>(x.size()) != dimension) {
+        return func->valueAndGradient(x, grad);
+    }
+    grad.resize(dimension);
+    double value;
+    if (lookup(x.data(), &value, grad.data())) {
+        return value;
+    }
+    value = func->valueAndGradient(x, grad);
+    store(x.data(), &value, grad.data());
+    return value;
+}
+
+std::string CachedFunc::getName() const {
+    return func->getName();
+}
+
+int CachedFunc::getDimension() const {
+    return dimension;
+}
+
+bool CachedFunc::isSeparable() const {
+    return func->isSeparable();
+}
+
+double CachedFunc::coordinateTerm(int j, double xj) const {
+    return func->coordinateTerm(j, xj);
+}
+
+bool CachedFunc::prefersWholeBatch() const {
+    return func->prefersWholeBatch();
+}
+
+std::vector<double> CachedFunc::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    return func->hessianVectorProduct(x, v);
+}
+
+void CachedFunc::evaluateBatch(const double* points, size_t count, double* values) const {
+    // Промахи собираются в отдельный пакет SoA и вычисляются одним вызовом
+    std::vector<double> x(dimension);
+    std::vector<size_t> missed;
+    for (size_t i = 0; i < count; ++i) {
+        for (int j = 0; j < dimension; ++j) x[j] = points[j * count + i];
+        if (!lookup(x.data(), &values[i], nullptr)) {
+            missed.push_back(i);
+        }
+    }
+    if (missed.empty()) return;
+
+    const size_t m = missed.size();
+    std::vector<double> missPoints(m * dimension), missValues(m);
+    for (int j = 0; j < dimension; ++j) {
+        for (size_t k = 0; k < m; ++k) {
+            missPoints[j * m + k] = points[j * count + missed[k]];
+        }
+    }
+    func->evaluateBatch(missPoints.data(), m, missValues.data());
+
+    for (size_t k = 0; k < m; ++k) {
+        for (int j = 0; j < dimension; ++j) x[j] = missPoints[j * m + k];
+        values[missed[k]] = missValues[k];
+        store(x.data(), &missValues[k], nullptr);
+    }
+}
+
+void CachedFunc::gradientBatch(const double* points, size_t count, double* grads) const {
+    std::vector<double> x(dimension), g(dimension);
+    std::vector<size_t> missed;
+    for (size_t i = 0; i < count; ++i) {
+        for (int j = 0; j < dimension; ++j) x[j] = points[j * count + i];
+        if (lookup(x.data(), nullptr, g.data())) {
+            for (int j = 0; j < dimension; ++j) grads[j * count + i] = g[j];
+        }
+        else {
+            missed.push_back(i);
+        }
+    }
+    if (missed.empty()) return;
+
+    const size_t m = missed.size();
+    std::vector<double> missPoints(m * dimension), missGrads(m * dimension);
+    for (int j = 0; j < dimension; ++j) {
+        for (size_t k = 0; k < m; ++k) {
+            missPoints[j * m + k] = points[j * count + missed[k]];
+        }
+    }
+    func->gradientBatch(missPoints.data(), m, missGrads.data());
+    for (size_t k = 0; k < m; ++k) {
+        for (int j = 0; j < dimension; ++j) {
+            x[j] = missPoints[j * m + k];
+            g[j] = missGrads[j * m + k];
+            grads[j * count + missed[k]] = g[j];
+        }
+        store(x.data(), nullptr, g.data());
+    }
+}
@@ -0,0 +1,101 @@
+﻿#ifndef CACHEDFUNC_H
+#define CACHEDFUNC_H
+
+#include "AbstrFunc.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Декоратор с ограниченным кэшем точка -> значение (и градиент) для дорогих функций.
+//
+// Ключ - точные биты координат (0.0 и -0.0 - разные точки), совпадение проверяется
+// сравнением всех координат, поэтому кэш никогда не возвращает значение другой точки.
+// Таблица разбита на полосы (stripes) со своим мьютексом; внутри полосы -
+// 4-канальные корзины с циклическим вытеснением. Память полосы выделяется при
+// первой записи в неё (градиенты - при первом градиенте), а число точек
+// уменьшается так, чтобы координаты и градиенты всех слотов занимали не больше
+// maxBytes: при тысячах координат кэш хранит меньше точек, а не гигабайты.
+// Вычисление функции выполняется вне блокировки, поэтому параллельные вызовы
+// могут разделять один CachedFunc.
+//
+// Значение и градиент точки хранятся независимо: getGradient на промахе
+// вызывает только getGradient обёрнутой функции.
+class CachedFunc : public AbstrFunc {
+public:
+    static const int WAYS = 4;
+    static const size_t DEFAULT_MAX_BYTES = 64u << 20;
+
+    // Обёртка без владения; capacity - число хранимых точек (округляется вверх
+    // до степени двойки на полосу, но не выше предела maxBytes)
+    CachedFunc(const AbstrFunc* f, size_t capacity = 65536, int stripeCount = 64,
+        size_t maxBytes = DEFAULT_MAX_BYTES);
+    // Обёртка, владеющая функцией
+    CachedFunc(std::unique_ptr<AbstrFunc> f, size_t capacity = 65536, int stripeCount = 64,
+        size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    double operator()(const std::vector<double>& x) const override;
+    std::vector<double> getGradient(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    int getDimension() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    // Слагаемые сепарабельной функции и произведения гессиана не кэшируются
+    bool isSeparable() const override;
+    double coordinateTerm(int j, double xj) const override;
+    bool prefersWholeBatch() const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+
+    size_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    size_t misses() const { return missCount.load(std::memory_order_relaxed); }
+    size_t capacity() const;
+    void clear();
+
+    const AbstrFunc* inner() const { return func; }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        double value;
+        bool used;
+        bool hasValue;
+        bool hasGradient;
+    };
+
+    // Полоса: корзины по WAYS слотов; координаты и градиенты слота i лежат
+    // в coords/grads начиная с i * dimension (пустые, пока в полосу не писали)
+    struct Stripe {
+        std::mutex mutex;
+        std::vector<Slot> slots;
+        std::vector<double> coords;
+        std::vector<double> grads;
+        unsigned victim = 0;
+    };
+
+    std::unique_ptr<AbstrFunc> owned;
+    const AbstrFunc* func;
+    int dimension;
+    size_t bucketsPerStripe;
+    std::unique_ptr<Stripe[]> stripes;
+    int stripeCount;
+    mutable std::atomic<size_t> hitCount;
+    mutable std::atomic<size_t> missCount;
+
+    void init(size_t capacity, int stripeCount, size_t maxBytes);
+    uint64_t hashPoint(const double* x) const;
+    Stripe& stripeFor(uint64_t hash) const;
+    size_t bucketFor(uint64_t hash) const;
+    int find(const Stripe& s, uint64_t hash, const double* x) const;
+
+    // Поиск того, что запрошено (value и/или grad не nullptr); промах, если
+    // чего-то из запрошенного нет
+    bool lookup(const double* x, double* value, double* grad) const;
+    // Запись значения и/или градиента точки
+    void store(const double* x, const double* value, const double* grad) const;
+};
+
+#endif
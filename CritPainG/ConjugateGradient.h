@@ -0,0 +1,241 @@
+﻿#ifndef CONJUGATEGRADIENT_H
+#define CONJUGATEGRADIENT_H
+
+#include "AbstrOptim.h"
+#include "LineSearch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Нелинейный метод сопряжённых градиентов без ограничений: d = -g + beta d.
+//
+// Формула beta - параметр шаблона, так что выбор варианта не стоит ветвления
+// в цикле. Политика получает скалярные произведения одного прохода:
+// g0, g1 - градиенты до и после шага, d - прежнее направление, y = g1 - g0.
+
+struct ConjugateGradientProducts {
+    double g1g1;  // g1^T g1
+    double g0g0;  // g0^T g0
+    double g1g0;  // g1^T g0
+    double dg1;   // d^T g1
+    double dg0;   // d^T g0
+};
+
+// Флетчер-Ривс: g1^T g1 / g0^T g0
+struct FletcherReevesBeta {
+    static double beta(const ConjugateGradientProducts& s) {
+        return s.g0g0 > 0.0 ? s.g1g1 / s.g0g0 : 0.0;
+    }
+    static const char* name() { return "Fletcher-Reeves"; }
+};
+
+// Полак-Рибьер+: max(0, g1^T y / g0^T g0); отрицательное значение - сброс
+struct PolakRibierePlusBeta {
+    static double beta(const ConjugateGradientProducts& s) {
+        return s.g0g0 > 0.0 ? (std::max)(0.0, (s.g1g1 - s.g1g0) / s.g0g0) : 0.0;
+    }
+    static const char* name() { return "Polak-Ribiere+"; }
+};
+
+// Хестенс-Штифель: g1^T y / d^T y
+struct HestenesStiefelBeta {
+    static double beta(const ConjugateGradientProducts& s) {
+        const double dy = s.dg1 - s.dg0;
+        return dy != 0.0 ? (s.g1g1 - s.g1g0) / dy : 0.0;
+    }
+    static const char* name() { return "Hestenes-Stiefel"; }
+};
+
+// Дай-Юань: g1^T g1 / d^T y; спуск при слабых условиях Вулфа
+struct DaiYuanBeta {
+    static double beta(const ConjugateGradientProducts& s) {
+        const double dy = s.dg1 - s.dg0;
+        return dy != 0.0 ? s.g1g1 / dy : 0.0;
+    }
+    static const char* name() { return "Dai-Yuan"; }
+};
+
+// Гибрид Дай-Юаня: max(0, min(HS, DY))
+struct HybridHSDYBeta {
+    static double beta(const ConjugateGradientProducts& s) {
+        return (std::max)(0.0, (std::min)(HestenesStiefelBeta::beta(s), DaiYuanBeta::beta(s)));
+    }
+    static const char* name() { return "Hybrid HS-DY"; }
+};
+
+// Гибрид Гильберта-Нокедаля: PR, ограниченный по модулю FR
+struct HybridFRPRBeta {
+    static double beta(const ConjugateGradientProducts& s) {
+        const double fr = FletcherReevesBeta::beta(s);
+        const double pr = s.g0g0 > 0.0 ? (s.g1g1 - s.g1g0) / s.g0g0 : 0.0;
+        return (std::max)(-fr, (std::min)(pr, fr));
+    }
+    static const char* name() { return "Hybrid FR-PR"; }
+};
+
+// Шаг - стратегия LineSearch, по умолчанию сильные условия Вулфа с c2 = 0.1
+// (ls_tolerance и max_ls_iter передаются ей). Направление сбрасывается на
+// антиградиент:
+//  - по Пауэллу, если |g1^T g0| >= powell_threshold * g1^T g1 (по умолчанию
+//    0.2, 0 - отключено): соседние градиенты перестали быть ортогональными;
+//  - каждые restart_interval итераций (по умолчанию -1 - никогда, 0 -
+//    размерность задачи); на плохо обусловленных квадратичных функциях такой
+//    сброс теряет накопленную сопряжённость, тест Пауэлла - нет;
+//  - если новое направление не является направлением спуска;
+//  - если линейный поиск не нашёл шаг.
+// Без сбросов Флетчер-Ривс «заклинивает» на невыпуклых функциях (Растригин):
+// шаги становятся крошечными, а направление не обновляется.
+template <class Beta>
+class ConjugateGradient : public AbstrOptim {
+private:
+    double grad_epsilon;
+    std::unique_ptr<LineSearch> lineSearch;
+    int restart_interval;
+    double powell_threshold;
+    int restarts;
+
+public:
+    ConjugateGradient(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, double ls_tolerance = 1e-6,
+        int max_ls_iter = 100, double grad_eps = 1e-8)
+        : AbstrOptim(f, std::move(c), x0), grad_epsilon(grad_eps),
+        lineSearch(std::make_unique<StrongWolfeLineSearch>(1e-4, 0.1, max_ls_iter, ls_tolerance)),
+        restart_interval(-1), powell_threshold(0.2), restarts(0) {}
+
+    void setLineSearch(std::unique_ptr<LineSearch> ls) {
+        if (!ls) {
+            throw std::invalid_argument("Line search must not be null.");
+        }
+        lineSearch = std::move(ls);
+    }
+    const LineSearch* getLineSearch() const { return lineSearch.get(); }
+
+    void setRestartInterval(int interval) {
+        if (interval < -1) {
+            throw std::invalid_argument("Restart interval must be -1, 0 or positive.");
+        }
+        restart_interval = interval;
+    }
+    void setPowellThreshold(double threshold) {
+        if (threshold < 0.0) {
+            throw std::invalid_argument("Powell restart threshold must be non-negative.");
+        }
+        powell_threshold = threshold;
+    }
+    // Сбросы направления за последний запуск
+    int getRestartCount() const { return restarts; }
+    static const char* betaName() { return Beta::name(); }
+
+protected:
+    Result run() override {
+        trajectory.clear();
+        restarts = 0;
+        const size_t n = initialPoint.size();
+        const int interval = restart_interval == 0 ? static_cast<int>(n) : restart_interval;
+
+        std::vector<double> x = initialPoint;
+        int iteration = 0;
+        addPointToTrajectory(x);
+        std::vector<double> grad;
+        double f_val = evaluateWithGradient(*func, x, grad, fdOptions);
+
+        std::vector<double> p(n);
+        for (size_t i = 0; i < n; ++i) p[i] = -grad[i];
+        bool steepest = true;
+        int since_restart = 0;
+
+        std::vector<double> best_x = x;
+        double best_f_val = f_val;
+
+        // Начальный шаг: alpha_{k-1} * phi'_{k-1}(0) / phi'_k(0)
+        double prev_step = 1.0, prev_slope = 0.0;
+
+        const int max_fallback_iterations = MaxI;
+
+        while (!criterial->isSatisfied(x, f_val, iteration)) {
+            if (iteration >= max_fallback_iterations) {
+                return { best_x, best_f_val, iteration,
+                         "Fallback: reached maximum iterations", trajectory };
+            }
+
+            double grad_norm_sq = 0.0;
+            for (double g : grad) grad_norm_sq += g * g;
+            if (std::sqrt(grad_norm_sq) < grad_epsilon) {
+                return { best_x, best_f_val, iteration,
+                         "Gradient norm below threshold", trajectory };
+            }
+
+            VectorLineFunction phi(*func, fdOptions, x, p);
+            double slope = phi.initialSlope(grad);
+            double initial_step = prev_slope < 0.0 ? prev_step * prev_slope / slope : 1.0;
+            if (!(initial_step > 0.0) || !std::isfinite(initial_step)) initial_step = 1.0;
+
+            const LineSearchResult ls = lineSearch->search(phi, f_val, slope, initial_step);
+            if (!ls.accepted) {
+                if (!steepest) {
+                    for (size_t i = 0; i < n; ++i) p[i] = -grad[i];
+                    steepest = true;
+                    since_restart = 0;
+                    prev_slope = 0.0;
+                    ++restarts;
+                    continue;
+                }
+                return { best_x, best_f_val, iteration,
+                         "Line search failed", trajectory };
+            }
+            prev_step = ls.step;
+            prev_slope = slope;
+
+            std::vector<double> x_new = std::move(phi.point);
+            std::vector<double> grad_new = std::move(phi.gradient);
+            const double f_val_new = ls.value;
+            addPointToTrajectory(x_new);
+            if (f_val_new < best_f_val) {
+                best_x = x_new;
+                best_f_val = f_val_new;
+            }
+
+            // Все произведения для beta и проверок сброса - за один проход
+            ConjugateGradientProducts s = { 0.0, grad_norm_sq, 0.0, 0.0, slope };
+            for (size_t i = 0; i < n; ++i) {
+                s.g1g1 += grad_new[i] * grad_new[i];
+                s.g1g0 += grad_new[i] * grad[i];
+                s.dg1 += p[i] * grad_new[i];
+            }
+            if (std::isnan(s.g1g1)) {
+                return { best_x, best_f_val, iteration,
+                         "Gradient contains NaN", trajectory };
+            }
+
+            ++since_restart;
+            bool restart = (interval > 0 && since_restart >= interval) ||
+                (powell_threshold > 0.0 && std::fabs(s.g1g0) >= powell_threshold * s.g1g1);
+            const double beta = restart ? 0.0 : Beta::beta(s);
+
+            // d^T g1 для нового направления: -g1^T g1 + beta d^T g1
+            const double new_slope = -s.g1g1 + beta * s.dg1;
+            if (!restart && !(new_slope < 0.0)) restart = true;
+            if (restart) {
+                for (size_t i = 0; i < n; ++i) p[i] = -grad_new[i];
+                since_restart = 0;
+                ++restarts;
+            }
+            else {
+                for (size_t i = 0; i < n; ++i) p[i] = -grad_new[i] + beta * p[i];
+            }
+            steepest = restart;
+
+            x = std::move(x_new);
+            f_val = f_val_new;
+            grad = std::move(grad_new);
+            iteration++;
+        }
+
+        return { best_x, best_f_val, iteration, "Criterial satisfied", trajectory };
+    }
+};
+
+// Исторический вариант метода
+using ConjugateGradientFR = ConjugateGradient<FletcherReevesBeta>;
+
+#endif
@@ -3,10 +3,236 @@
 #include <limits>
 #include <cmath>
 #include <random>
+#include <stdexcept>
 
-#ifndef MaxI
-#define MaxI 100000
-#endif
+namespace {
+
+std::unique_ptr<LineSearch> makeLineSearch(LineSearchKind kind) {
+    switch (kind) {
+    case LineSearchKind::Armijo: return std::make_unique<ArmijoLineSearch>();
+    case LineSearchKind::ExactQuadratic: return std::make_unique<ExactQuadraticLineSearch>();
+    default: return std::make_unique<StrongWolfeLineSearch>();
+    }
+}
+
+template <class Beta>
+std::unique_ptr<AbstrOptim> makeNonlinearCG(const OptimizationConfig& config, const std::vector<double>& x0) {
+    auto optimizer = std::make_unique<ConjugateGradient<Beta>>(config.function.get(),
+        config.criterial->clone(),
+        x0,
+        1e-6, 100, config.grad_epsilon);
+    if (config.line_search != LineSearchKind::StrongWolfe) {
+        optimizer->setLineSearch(makeLineSearch(config.line_search));
+    }
+    return optimizer;
+}
+
+std::unique_ptr<AbstrOptim> makeNonlinearCG(const OptimizationConfig& config, const std::vector<double>& x0) {
+    switch (config.cg_beta) {
+    case ConjugateGradientBeta::FletcherReeves: return makeNonlinearCG<FletcherReevesBeta>(config, x0);
+    case ConjugateGradientBeta::HestenesStiefel: return makeNonlinearCG<HestenesStiefelBeta>(config, x0);
+    case ConjugateGradientBeta::DaiYuan: return makeNonlinearCG<DaiYuanBeta>(config, x0);
+    case ConjugateGradientBeta::HybridHSDY: return makeNonlinearCG<HybridHSDYBeta>(config, x0);
+    case ConjugateGradientBeta::HybridFRPR: return makeNonlinearCG<HybridFRPRBeta>(config, x0);
+    default: return makeNonlinearCG<PolakRibierePlusBeta>(config, x0);
+    }
+}
+
+// Sphere 3D из меню считается через FixedOptim.h: точка на стеке, градиент
+// прямым дифференцированием. Обёрнутые функции (кэш) идут общим путём
+const SphereFunc3D* fixedSphere3D(const OptimizationConfig& config) {
+    return dynamic_cast<const SphereFunc3D*>(config.function.get());
+}
+
+// Оптимизатор выбранного метода из точки x0; seed - для стохастических методов.
+// Только читает config, поэтому годится как фабрика мультистарта
+std::unique_ptr<AbstrOptim> createOptimizer(const OptimizationConfig& config,
+    const std::vector<double>& x0, unsigned int seed) {
+    switch (config.method) {
+    case OptimizationMethod::RandomSearch: {
+        const SphereFunc3D* sphere = fixedSphere3D(config);
+        if (sphere && config.random_search_coordinates == 0) {
+            return std::make_unique<RandomSearchOptimFixed<3, SphereFunc3D>>(sphere,
+                config.criterial->clone(),
+                x0,
+                config.lower_bounds,
+                config.upper_bounds,
+                config.delta,
+                seed,
+                config.random_search_p,
+                config.random_search_alpha);
+        }
+        auto optimizer = std::make_unique<RandomSearchOptim>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lower_bounds,
+            config.upper_bounds,
+            config.delta,
+            seed,
+            config.random_search_p,
+            config.random_search_alpha);
+        optimizer->setLocalCoordinates(config.random_search_coordinates);
+        return optimizer;
+    }
+    case OptimizationMethod::ConjugateGradient: {
+        // Фиксированная версия умеет только сильные условия Вулфа
+        const SphereFunc3D* sphere = fixedSphere3D(config);
+        if (sphere && config.line_search == LineSearchKind::StrongWolfe) {
+            return std::make_unique<ConjugateGradientFRConstrainedFixed<3, SphereFunc3D>>(sphere,
+                config.criterial->clone(),
+                x0,
+                config.lower_bounds,
+                config.upper_bounds,
+                config.grad_epsilon);
+        }
+        auto optimizer = std::make_unique<ConjugateGradientFRConstrained>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lower_bounds,
+            config.upper_bounds,
+            1e-6, 100, config.grad_epsilon);
+        if (config.line_search != LineSearchKind::StrongWolfe) {
+            optimizer->setLineSearch(makeLineSearch(config.line_search));
+        }
+        return optimizer;
+    }
+    case OptimizationMethod::NewtonCG:
+        return std::make_unique<NewtonCG>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.grad_epsilon);
+    case OptimizationMethod::LBFGS:
+        return std::make_unique<LBFGS>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lbfgs_history,
+            config.grad_epsilon);
+    case OptimizationMethod::LBFGSB:
+        return std::make_unique<LBFGSB>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lower_bounds,
+            config.upper_bounds,
+            config.lbfgs_history,
+            config.grad_epsilon);
+    case OptimizationMethod::NonlinearCG:
+        return makeNonlinearCG(config, x0);
+    case OptimizationMethod::NelderMead:
+        return std::make_unique<NelderMead>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lower_bounds,
+            config.upper_bounds,
+            config.simplex_step);
+    case OptimizationMethod::CMAES:
+        return std::make_unique<CMAES>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lower_bounds,
+            config.upper_bounds,
+            config.cmaes_sigma,
+            config.cmaes_restart,
+            seed);
+    case OptimizationMethod::DifferentialEvolution:
+        return std::make_unique<DifferentialEvolution>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lower_bounds,
+            config.upper_bounds,
+            config.de_strategy,
+            config.de_population,
+            0.5, 0.9,
+            seed);
+    case OptimizationMethod::ParticleSwarm:
+        return std::make_unique<ParticleSwarm>(config.function.get(),
+            config.criterial->clone(),
+            x0,
+            config.lower_bounds,
+            config.upper_bounds,
+            config.swarm_size,
+            0.7298, 1.49618, 1.49618,
+            seed);
+    }
+    throw std::invalid_argument("Unknown optimization method.");
+}
+
+template <class Beta>
+void printNonlinearCGSetup(const AbstrOptim& optimizer) {
+    const auto& cg = static_cast<const ConjugateGradient<Beta>&>(optimizer);
+    std::cout << "Beta: " << cg.betaName()
+        << ", line search: " << cg.getLineSearch()->getName() << std::endl;
+}
+
+template <class Beta>
+void printNonlinearCGStatistics(const AbstrOptim& optimizer) {
+    std::cout << "Direction restarts: "
+        << static_cast<const ConjugateGradient<Beta>&>(optimizer).getRestartCount() << std::endl;
+}
+
+// Настройки, которые выбрал сам оптимизатор (поиск на прямой, уровень SIMD)
+void printSetup(const AbstrOptim& optimizer, const OptimizationConfig& config) {
+    switch (config.method) {
+    case OptimizationMethod::ConjugateGradient:
+        if (const auto* cg = dynamic_cast<const ConjugateGradientFRConstrained*>(&optimizer)) {
+            std::cout << "Line search: " << cg->getLineSearch()->getName() << std::endl;
+        }
+        else {
+            std::cout << "Line search: Strong Wolfe (fixed dimension " << config.function->getDimension() << ")" << std::endl;
+        }
+        break;
+    case OptimizationMethod::ParticleSwarm:
+        std::cout << "Swarm update: " << simd::levelName(simd::activeLevel()) << std::endl;
+        break;
+    case OptimizationMethod::NonlinearCG:
+        switch (config.cg_beta) {
+        case ConjugateGradientBeta::FletcherReeves: printNonlinearCGSetup<FletcherReevesBeta>(optimizer); break;
+        case ConjugateGradientBeta::PolakRibierePlus: printNonlinearCGSetup<PolakRibierePlusBeta>(optimizer); break;
+        case ConjugateGradientBeta::HestenesStiefel: printNonlinearCGSetup<HestenesStiefelBeta>(optimizer); break;
+        case ConjugateGradientBeta::DaiYuan: printNonlinearCGSetup<DaiYuanBeta>(optimizer); break;
+        case ConjugateGradientBeta::HybridHSDY: printNonlinearCGSetup<HybridHSDYBeta>(optimizer); break;
+        case ConjugateGradientBeta::HybridFRPR: printNonlinearCGSetup<HybridFRPRBeta>(optimizer); break;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Счётчики метода после запуска
+void printStatistics(const AbstrOptim& optimizer, const OptimizationConfig& config) {
+    switch (config.method) {
+    case OptimizationMethod::NelderMead:
+        std::cout << "Simplex shrinks: " << static_cast<const NelderMead&>(optimizer).getShrinkCount() << std::endl;
+        break;
+    case OptimizationMethod::CMAES: {
+        const auto& cmaes = static_cast<const CMAES&>(optimizer);
+        std::cout << "Restarts: " << cmaes.getRestartCount()
+            << ", last population: " << cmaes.getLastPopulationSize() << std::endl;
+        break;
+    }
+    case OptimizationMethod::DifferentialEvolution:
+        if (config.de_strategy == DEStrategy::JADE) {
+            const auto& de = static_cast<const DifferentialEvolution&>(optimizer);
+            std::cout << "Adapted F: " << de.getMeanF()
+                << ", CR: " << de.getMeanCR() << std::endl;
+        }
+        break;
+    case OptimizationMethod::NonlinearCG:
+        switch (config.cg_beta) {
+        case ConjugateGradientBeta::FletcherReeves: printNonlinearCGStatistics<FletcherReevesBeta>(optimizer); break;
+        case ConjugateGradientBeta::PolakRibierePlus: printNonlinearCGStatistics<PolakRibierePlusBeta>(optimizer); break;
+        case ConjugateGradientBeta::HestenesStiefel: printNonlinearCGStatistics<HestenesStiefelBeta>(optimizer); break;
+        case ConjugateGradientBeta::DaiYuan: printNonlinearCGStatistics<DaiYuanBeta>(optimizer); break;
+        case ConjugateGradientBeta::HybridHSDY: printNonlinearCGStatistics<HybridHSDYBeta>(optimizer); break;
+        case ConjugateGradientBeta::HybridFRPR: printNonlinearCGStatistics<HybridFRPRBeta>(optimizer); break;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace
 
 void ConsoleMenu::run() {
     while (true) {
@@ -51,7 +277,10 @@ void ConsoleMenu::selectFunction(OptimizationConfig& config) {
     std::cout << "1. Quadratic 2D" << std::endl;
     std::cout << "2. Sphere 3D" << std::endl;
     std::cout << "3. Rastrigin 4D" << std::endl;
-    std::cout << "Select function (1-3): ";
+    std::cout << "4. N-dimensional test function" << std::endl;
+    std::cout << "5. Plugin library (.dll / .so)" << std::endl;
+    std::cout << "6. External process pool" << std::endl;
+    std::cout << "Select function (1-6): ";
 
     int choice;
     std::cin >> choice;
@@ -60,6 +289,9 @@ void ConsoleMenu::selectFunction(OptimizationConfig& config) {
     case 1: config.function = std::make_unique<QuadraticFunc2D>(); break;
     case 2: config.function = std::make_unique<SphereFunc3D>(); break;
     case 3: config.function = std::make_unique<RastriginFunc4D>(); break;
+    case 4: config.function = selectFunctionND(); break;
+    case 5: config.function = selectPluginFunction(); break;
+    case 6: config.function = selectProcessFunction(); break;
     default:
         config.function = std::make_unique<QuadraticFunc2D>();
         std::cout << "Invalid selection, using Quadratic 2D." << std::endl;
@@ -70,6 +302,95 @@ void ConsoleMenu::selectFunction(OptimizationConfig& config) {
     config.dimension = config.function->getDimension();
 }
 
+std::unique_ptr<AbstrFunc> ConsoleMenu::selectPluginFunction() {
+    std::cout << "Enter plugin library path: ";
+    std::string path;
+    std::cin >> path;
+
+    try {
+        std::unique_ptr<PluginFunc> plugin = std::make_unique<PluginFunc>(path);
+        if (!plugin->hasGradient()) {
+            std::cout << "Plugin has no gradient: numerical gradient will be used." << std::endl;
+        }
+        return offerCache(std::move(plugin));
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        std::cout << "Using Quadratic 2D." << std::endl;
+        return std::make_unique<QuadraticFunc2D>();
+    }
+}
+
+std::unique_ptr<AbstrFunc> ConsoleMenu::selectProcessFunction() {
+    ProcessPoolOptions options;
+    std::cout << "Enter number of processes (0 - one per core): ";
+    std::cin >> options.workers;
+    std::cout << "Enter worker command line: ";
+    std::string command;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::getline(std::cin, command);
+
+    try {
+        std::unique_ptr<ProcessFunc> process = std::make_unique<ProcessFunc>(command, options);
+        std::cout << "Started " << process->workerCount() << " processes, numerical gradient will be used." << std::endl;
+        return offerCache(std::move(process));
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        std::cout << "Using Quadratic 2D." << std::endl;
+        return std::make_unique<QuadraticFunc2D>();
+    }
+}
+
+std::unique_ptr<AbstrFunc> ConsoleMenu::offerCache(std::unique_ptr<AbstrFunc> function) {
+    std::cout << "Cache evaluated points (skips repeated evaluations)? (y/n): ";
+    char answer;
+    std::cin >> answer;
+    if (answer != 'y' && answer != 'Y') {
+        return function;
+    }
+    auto cached = std::make_unique<CachedFunc>(std::move(function));
+    std::cout << "Cache holds up to " << cached->capacity() << " points." << std::endl;
+    return cached;
+}
+
+std::unique_ptr<AbstrFunc> ConsoleMenu::selectFunctionND() {
+    std::cout << "1. Sphere" << std::endl;
+    std::cout << "2. Rastrigin" << std::endl;
+    std::cout << "3. Rosenbrock" << std::endl;
+    std::cout << "4. Ackley" << std::endl;
+    std::cout << "5. Griewank" << std::endl;
+    std::cout << "6. Schwefel" << std::endl;
+    std::cout << "7. Levy" << std::endl;
+    std::cout << "8. Styblinski-Tang" << std::endl;
+    std::cout << "Select function (1-8): ";
+
+    int choice;
+    std::cin >> choice;
+
+    std::cout << "Enter dimension: ";
+    int dim;
+    std::cin >> dim;
+    if (dim < 2) {
+        dim = 2;
+        std::cout << "Dimension must be at least 2, using 2." << std::endl;
+    }
+
+    switch (choice) {
+    case 1: return std::make_unique<SphereFuncND>(dim);
+    case 2: return std::make_unique<RastriginFuncND>(dim);
+    case 3: return std::make_unique<RosenbrockFuncND>(dim);
+    case 4: return std::make_unique<AckleyFuncND>(dim);
+    case 5: return std::make_unique<GriewankFuncND>(dim);
+    case 6: return std::make_unique<SchwefelFuncND>(dim);
+    case 7: return std::make_unique<LevyFuncND>(dim);
+    case 8: return std::make_unique<StyblinskiTangFuncND>(dim);
+    default:
+        std::cout << "Invalid selection, using Sphere." << std::endl;
+        return std::make_unique<SphereFuncND>(dim);
+    }
+}
+
 void ConsoleMenu::selectDomain(OptimizationConfig& config) {
     std::cout << "\n=== Select Domain Type ===" << std::endl;
     std::cout << "1. Easy - Small domain [-5, 5]^n" << std::endl;
@@ -135,20 +456,20 @@ void ConsoleMenu::selectCriterial(OptimizationConfig& config) {
     std::cout << "3. Function Change < 1e-6" << std::endl;
     std::cout << "4. Point Change < 1e-6" << std::endl;
 
-    // Gradient Norm только для Conjugate Gradient
-    if (!config.use_random_search) {
+    // Gradient Norm только для градиентных методов
+    if (!isDerivativeFree(config.method)) {
         std::cout << "5. Gradient Norm < 1e-6" << std::endl;
     }
 
-    std::cout << "Select criterial (1-" << (config.use_random_search ? "4" : "5") << "): ";
+    std::cout << "Select criterial (1-" << (isDerivativeFree(config.method) ? "4" : "5") << "): ";
 
     int choice;
     std::cin >> choice;
 
     // Для Random Search ограничиваем выбор
-    if (config.use_random_search && choice == 5) {
+    if (isDerivativeFree(config.method) && choice == 5) {
         choice = 2; // По умолчанию Max Iterations (1000)
-        std::cout << "Gradient Norm not available for Random Search. Using Max Iterations (1000)." << std::endl;
+        std::cout << "Gradient Norm not available for " << methodName(config.method) << ". Using Max Iterations (1000)." << std::endl;
     }
 
     switch (choice) {
@@ -169,7 +490,7 @@ void ConsoleMenu::selectCriterial(OptimizationConfig& config) {
         config.max_iterations = MaxI;
         break;
     case 5:
-        if (!config.use_random_search) {
+        if (!isDerivativeFree(config.method)) {
             config.criterial = std::make_unique<CriterialGradientNorm>(nullptr, 1e-6);
             config.max_iterations = MaxI;
         }
@@ -275,14 +596,33 @@ void ConsoleMenu::selectMethod(OptimizationConfig& config) {
     std::cout << "\n=== Select Optimization Method ===" << std::endl;
     std::cout << "1. Random Search" << std::endl;
     std::cout << "2. Conjugate Gradient (Fletcher-Reeves)" << std::endl;
-    std::cout << "Select method (1-2): ";
+    std::cout << "3. Newton-CG (unconstrained)" << std::endl;
+    std::cout << "4. L-BFGS (unconstrained)" << std::endl;
+    std::cout << "5. L-BFGS-B (bound-constrained)" << std::endl;
+    std::cout << "6. Nonlinear CG (unconstrained, choice of beta)" << std::endl;
+    std::cout << "7. Nelder-Mead (derivative-free, bound-constrained)" << std::endl;
+    std::cout << "8. CMA-ES (derivative-free, bound-constrained, restarts)" << std::endl;
+    std::cout << "9. Differential Evolution (derivative-free, bound-constrained)" << std::endl;
+    std::cout << "10. Particle Swarm (derivative-free, bound-constrained)" << std::endl;
+    std::cout << "Select method (1-10): ";
 
     int choice;
     std::cin >> choice;
 
-    config.use_random_search = (choice == 1);
+    switch (choice) {
+    case 1: config.method = OptimizationMethod::RandomSearch; break;
+    case 3: config.method = OptimizationMethod::NewtonCG; break;
+    case 4: config.method = OptimizationMethod::LBFGS; break;
+    case 5: config.method = OptimizationMethod::LBFGSB; break;
+    case 6: config.method = OptimizationMethod::NonlinearCG; break;
+    case 7: config.method = OptimizationMethod::NelderMead; break;
+    case 8: config.method = OptimizationMethod::CMAES; break;
+    case 9: config.method = OptimizationMethod::DifferentialEvolution; break;
+    case 10: config.method = OptimizationMethod::ParticleSwarm; break;
+    default: config.method = OptimizationMethod::ConjugateGradient; break;
+    }
 
-    if (config.use_random_search) {
+    if (config.method == OptimizationMethod::RandomSearch) {
         std::cout << "Enter delta for random search (default 0.8): ";
         std::cin >> config.delta;
         if (config.delta <= 0) {
@@ -316,6 +656,70 @@ void ConsoleMenu::selectMethod(OptimizationConfig& config) {
             std::cout << "Invalid alpha. Using default 0.8." << std::endl;
         }
 
+        std::cout << "Enter number of coordinates changed per local step (0 = all): ";
+        long long coordinates = 0;
+        std::cin >> coordinates;
+        if (coordinates < 0) {
+            coordinates = 0;
+            std::cout << "Invalid number. Changing all coordinates." << std::endl;
+        }
+        config.random_search_coordinates = static_cast<size_t>(coordinates);
+        if (config.random_search_coordinates > 0 && config.function->isSeparable()) {
+            std::cout << "Function is separable: candidates are re-evaluated incrementally." << std::endl;
+        }
+
+    }
+    else if (config.method == OptimizationMethod::NelderMead) {
+        std::cout << "Enter initial simplex step as a fraction of the domain width (default 0.1): ";
+        std::cin >> config.simplex_step;
+        if (!(config.simplex_step > 0.0) || config.simplex_step > 1.0) {
+            config.simplex_step = 0.1;
+            std::cout << "Invalid step, using 0.1." << std::endl;
+        }
+    }
+    else if (config.method == OptimizationMethod::CMAES) {
+        std::cout << "Enter initial sigma as a fraction of the domain width (default 0.3): ";
+        std::cin >> config.cmaes_sigma;
+        if (!(config.cmaes_sigma > 0.0) || config.cmaes_sigma > 1.0) {
+            config.cmaes_sigma = 0.3;
+            std::cout << "Invalid sigma, using 0.3." << std::endl;
+        }
+        std::cout << "Restarts: 1 - none, 2 - IPOP, 3 - BIPOP (default 3): ";
+        int kind = 3;
+        std::cin >> kind;
+        switch (kind) {
+        case 1: config.cmaes_restart = CMAESRestart::None; break;
+        case 2: config.cmaes_restart = CMAESRestart::IPOP; break;
+        default: config.cmaes_restart = CMAESRestart::BIPOP; break;
+        }
+    }
+    else if (config.method == OptimizationMethod::DifferentialEvolution) {
+        std::cout << "Strategy: 1 - rand/1/bin, 2 - current-to-best/1/bin, 3 - JADE (default 3): ";
+        int kind = 3;
+        std::cin >> kind;
+        switch (kind) {
+        case 1: config.de_strategy = DEStrategy::Rand1; break;
+        case 2: config.de_strategy = DEStrategy::CurrentToBest1; break;
+        default: config.de_strategy = DEStrategy::JADE; break;
+        }
+        std::cout << "Enter population size (0 = 10 * dimension): ";
+        long long population = 0;
+        std::cin >> population;
+        if (population != 0 && population < 4) {
+            population = 0;
+            std::cout << "Invalid population size, using default." << std::endl;
+        }
+        config.de_population = static_cast<size_t>(population);
+    }
+    else if (config.method == OptimizationMethod::ParticleSwarm) {
+        std::cout << "Enter swarm size (default 40): ";
+        long long swarm = 40;
+        std::cin >> swarm;
+        if (swarm < 2) {
+            swarm = 40;
+            std::cout << "Invalid swarm size, using 40." << std::endl;
+        }
+        config.swarm_size = static_cast<size_t>(swarm);
     }
     else {
         std::cout << "Enter gradient epsilon (default 1e-8): ";
@@ -324,59 +728,112 @@ void ConsoleMenu::selectMethod(OptimizationConfig& config) {
             config.grad_epsilon = 1e-8;
             std::cout << "Invalid epsilon, using 1e-8." << std::endl;
         }
+        if (config.method == OptimizationMethod::NonlinearCG) {
+            std::cout << "Beta: 1 - Fletcher-Reeves, 2 - Polak-Ribiere+, 3 - Hestenes-Stiefel, "
+                << "4 - Dai-Yuan, 5 - hybrid HS-DY, 6 - hybrid FR-PR (default 2): ";
+            int beta = 2;
+            std::cin >> beta;
+            switch (beta) {
+            case 1: config.cg_beta = ConjugateGradientBeta::FletcherReeves; break;
+            case 3: config.cg_beta = ConjugateGradientBeta::HestenesStiefel; break;
+            case 4: config.cg_beta = ConjugateGradientBeta::DaiYuan; break;
+            case 5: config.cg_beta = ConjugateGradientBeta::HybridHSDY; break;
+            case 6: config.cg_beta = ConjugateGradientBeta::HybridFRPR; break;
+            default: config.cg_beta = ConjugateGradientBeta::PolakRibierePlus; break;
+            }
+        }
+        if (config.method == OptimizationMethod::ConjugateGradient ||
+            config.method == OptimizationMethod::NonlinearCG) {
+            std::cout << "Line search: 1 - strong Wolfe, 2 - Armijo backtracking, 3 - exact quadratic step (default 1): ";
+            int kind = 1;
+            std::cin >> kind;
+            switch (kind) {
+            case 2: config.line_search = LineSearchKind::Armijo; break;
+            case 3: config.line_search = LineSearchKind::ExactQuadratic; break;
+            default: config.line_search = LineSearchKind::StrongWolfe; break;
+            }
+        }
+        if (config.method == OptimizationMethod::LBFGS || config.method == OptimizationMethod::LBFGSB) {
+            std::cout << "Enter L-BFGS history size (default 10): ";
+            std::cin >> config.lbfgs_history;
+            if (config.lbfgs_history < 1) {
+                config.lbfgs_history = 10;
+                std::cout << "Invalid history size, using 10." << std::endl;
+            }
+        }
     }
 
-    std::cout << "Selected: " << (config.use_random_search ? "Random Search" : "Conjugate Gradient") << std::endl;
+    std::cout << "Enter number of starts (1 - single run from the initial point, default 1): ";
+    long long starts = 1;
+    std::cin >> starts;
+    if (starts < 1) {
+        starts = 1;
+        std::cout << "Invalid number of starts, using 1." << std::endl;
+    }
+    config.starts = static_cast<size_t>(starts);
+
+    std::cout << "Selected: " << methodName(config.method) << std::endl;
 }
 
 void ConsoleMenu::runOptimization(const OptimizationConfig& config) {
     std::cout << "\n=== Running Optimization ===" << std::endl;
     std::cout << "Function: " << config.function->getName() << std::endl;
     std::cout << "Dimension: " << config.dimension << "D" << std::endl;
-    std::cout << "Method: " << (config.use_random_search ? "Random Search" : "Conjugate Gradient") << std::endl;
+    std::cout << "Method: " << methodName(config.method) << std::endl;
 
-    if (config.use_random_search) {
+    if (config.method == OptimizationMethod::RandomSearch) {
         std::cout << "Random Search parameters:" << std::endl;
         std::cout << "  - Delta: " << config.delta << std::endl;
         std::cout << "  - Probability: " << config.random_search_p
             << " (" << (config.random_search_p * 100) << "% local search)" << std::endl;
         std::cout << "  - Alpha: " << config.random_search_alpha
             << " (delta multiplier)" << std::endl;
+        if (config.random_search_coordinates > 0) {
+            std::cout << "  - Coordinates per local step: " << config.random_search_coordinates << std::endl;
+        }
     }
 
     std::cout << "Stop criterial: " << config.criterial->getName() << std::endl;
     std::cout << "Initial point: ";
     printPoint(config.initial_point);
     std::cout << std::endl;
-    std::cout << "Initial value: " << (*config.function)(config.initial_point) << std::endl;
+    const double initialValue = (*config.function)(config.initial_point);
+    std::cout << "Initial value: " << initialValue << std::endl;
     std::cout << "Optimizing..." << std::endl;
 
     try {
-        AbstrOptim::Result result;
+        const unsigned int seed = std::random_device{}();
+        std::unique_ptr<AbstrOptim> optimizer = createOptimizer(config, config.initial_point, seed);
+        printSetup(*optimizer, config);
 
-        if (config.use_random_search) {
-            RandomSearchOptim optimizer(config.function.get(),
-                config.criterial->clone(),
-                config.initial_point,
-                config.lower_bounds,
-                config.upper_bounds,
-                config.delta,
-                std::random_device{}(),  // seed
-                config.random_search_p,
-                config.random_search_alpha);
-            result = optimizer.optimize();
+        AbstrOptim::Result result;
+        if (config.starts <= 1) {
+            result = optimizer->optimize();
+            printStatistics(*optimizer, config);
         }
         else {
-            ConjugateGradientFRConstrained optimizer(config.function.get(),
-                config.criterial->clone(),
-                config.initial_point,
-                config.lower_bounds,
-                config.upper_bounds,
-                1e-6, 100, config.grad_epsilon);
-            result = optimizer.optimize();
+            // Первый запуск - из выбранной точки, остальные - из случайных точек области
+            optimizer.reset();
+            std::cout << "Multi-start: " << config.starts << " runs on "
+                << ThreadPool::shared().size() << " threads" << std::endl;
+            const std::vector<std::vector<double>> starts = multiStartPoints(config.initial_point,
+                config.lower_bounds, config.upper_bounds, config.starts, seed);
+            MultiStartResult multi = runMultiStart(
+                [&config, seed](const std::vector<double>& x0, size_t run) {
+                    return createOptimizer(config, x0, seed + static_cast<unsigned int>(run));
+                },
+                starts);
+            for (size_t run = 0; run < multi.runs.size(); ++run) {
+                const AbstrOptim::Result& r = multi.runs[run];
+                std::cout << (run == multi.bestRun ? " * " : "   ") << "run " << (run + 1)
+                    << ": value " << r.value << ", iterations " << r.iterations
+                    << ", evaluations " << r.function_evaluations
+                    << " (" << r.stop_reason << ")" << std::endl;
+            }
+            result = multi.best;
         }
 
-        showResults(result, config);
+        showResults(result, config, initialValue);
 
     }
     catch (const std::exception& e) {
@@ -384,11 +841,11 @@ void ConsoleMenu::runOptimization(const OptimizationConfig& config) {
     }
 }
 
-void ConsoleMenu::showResults(const AbstrOptim::Result& result, const OptimizationConfig& config) {
+void ConsoleMenu::showResults(const AbstrOptim::Result& result, const OptimizationConfig& config, double initialValue) {
     std::cout << "\n=== Optimization Results ===" << std::endl;
-    std::cout << "Method: " << (config.use_random_search ? "Random Search" : "Conjugate Gradient") << std::endl;
+    std::cout << "Method: " << methodName(config.method) << std::endl;
 
-    if (config.use_random_search) {
+    if (config.method == OptimizationMethod::RandomSearch) {
         std::cout << "Parameters: delta =" << config.delta
             << ", p=" << config.random_search_p << ", alpha=" << config.random_search_alpha << std::endl;
     }
@@ -399,7 +856,41 @@ void ConsoleMenu::showResults(const AbstrOptim::Result& result, const Optimizati
     std::cout << std::endl;
     std::cout << "Function value at minimum: " << result.value << std::endl;
     std::cout << "Number of iterations: " << result.iterations << std::endl;
-    std::cout << "Improvement: " << ((*config.function)(config.initial_point) - result.value) << std::endl;
+    std::cout << "Function evaluations: " << result.function_evaluations;
+    if (result.fd_evaluations > 0) {
+        std::cout << " (finite differences: " << result.fd_evaluations << ")";
+    }
+    std::cout << std::endl;
+    std::cout << "Gradient evaluations: " << result.gradient_evaluations << std::endl;
+    if (result.hessian_vector_products > 0) {
+        std::cout << "Hessian-vector products: " << result.hessian_vector_products << std::endl;
+    }
+    std::cout << "Improvement: " << (initialValue - result.value) << std::endl;
+    if (const CachedFunc* cached = dynamic_cast<const CachedFunc*>(config.function.get())) {
+        std::cout << "Cache: " << cached->hits() << " hits, " << cached->misses() << " misses" << std::endl;
+    }
+}
+
+const char* ConsoleMenu::methodName(OptimizationMethod method) {
+    switch (method) {
+    case OptimizationMethod::RandomSearch: return "Random Search";
+    case OptimizationMethod::ConjugateGradient: return "Conjugate Gradient";
+    case OptimizationMethod::NewtonCG: return "Newton-CG";
+    case OptimizationMethod::LBFGS: return "L-BFGS";
+    case OptimizationMethod::LBFGSB: return "L-BFGS-B";
+    case OptimizationMethod::NonlinearCG: return "Nonlinear CG";
+    case OptimizationMethod::NelderMead: return "Nelder-Mead";
+    case OptimizationMethod::CMAES: return "CMA-ES";
+    case OptimizationMethod::DifferentialEvolution: return "Differential Evolution";
+    case OptimizationMethod::ParticleSwarm: return "Particle Swarm";
+    }
+    return "Unknown";
+}
+
+bool ConsoleMenu::isDerivativeFree(OptimizationMethod method) {
+    return method == OptimizationMethod::RandomSearch || method == OptimizationMethod::NelderMead ||
+        method == OptimizationMethod::CMAES || method == OptimizationMethod::DifferentialEvolution ||
+        method == OptimizationMethod::ParticleSwarm;
 }
 
 void ConsoleMenu::printPoint(const std::vector<double>& point) {
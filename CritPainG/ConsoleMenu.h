@@ -2,12 +2,51 @@
 #define CONSOLEMENU_H
 
 #include "AbstrFunc.h"
+#include "TestFunctions.h"
 #include "AbstrCriterial.h"
 #include "AbstrOptim.h"
+#include "ConjugateGradient.h"
+#include "FixedOptim.h"
+#include "NelderMead.h"
+#include "CMAES.h"
+#include "DifferentialEvolution.h"
+#include "ParticleSwarm.h"
+#include "MultiStart.h"
+#include "PluginFunc.h"
+#include "ProcessFunc.h"
+#include "CachedFunc.h"
 #include <memory>
 #include <vector>
 #include <random>
 
+enum class OptimizationMethod {
+    RandomSearch,
+    ConjugateGradient,
+    NewtonCG,
+    LBFGS,
+    LBFGSB,
+    NonlinearCG,
+    NelderMead,
+    CMAES,
+    DifferentialEvolution,
+    ParticleSwarm
+};
+
+enum class LineSearchKind {
+    StrongWolfe,
+    Armijo,
+    ExactQuadratic
+};
+
+enum class ConjugateGradientBeta {
+    FletcherReeves,
+    PolakRibierePlus,
+    HestenesStiefel,
+    DaiYuan,
+    HybridHSDY,
+    HybridFRPR
+};
+
 struct OptimizationConfig {
     std::unique_ptr<AbstrFunc> function;
     std::vector<double> lower_bounds;
@@ -18,8 +57,19 @@ struct OptimizationConfig {
     double grad_epsilon = 1e-8;
     double random_search_p = 0.2;
     double random_search_alpha = 0.8;
+    size_t random_search_coordinates = 0;  // координат в локальном шаге; 0 - все
     int dimension = 2;
-    bool use_random_search = true;
+    OptimizationMethod method = OptimizationMethod::RandomSearch;
+    int lbfgs_history = 10;
+    LineSearchKind line_search = LineSearchKind::StrongWolfe;  // для сопряжённых градиентов
+    ConjugateGradientBeta cg_beta = ConjugateGradientBeta::PolakRibierePlus;
+    double simplex_step = 0.1;  // ребро начального симплекса Нелдера-Мида, доля ширины области
+    double cmaes_sigma = 0.3;   // начальный шаг CMA-ES, доля ширины области
+    CMAESRestart cmaes_restart = CMAESRestart::BIPOP;
+    DEStrategy de_strategy = DEStrategy::JADE;
+    size_t de_population = 0;   // 0 - 10 * размерность
+    size_t swarm_size = 40;
+    size_t starts = 1;          // запусков из разных начальных точек (мультистарт)
     int max_iterations = 1000;
 };
 
@@ -31,13 +81,21 @@ private:
     void showMainMenu();
     void runOptimizationMenu();
     void selectFunction(OptimizationConfig& config);
+    std::unique_ptr<AbstrFunc> selectFunctionND();
+    std::unique_ptr<AbstrFunc> selectPluginFunction();
+    std::unique_ptr<AbstrFunc> selectProcessFunction();
+    // Для дорогих функций (библиотека, процессы): обернуть в CachedFunc по выбору пользователя
+    std::unique_ptr<AbstrFunc> offerCache(std::unique_ptr<AbstrFunc> function);
     void selectDomain(OptimizationConfig& config);
     void selectCriterial(OptimizationConfig& config);
     void selectInitialPoint(OptimizationConfig& config);
     void selectMethod(OptimizationConfig& config);
     void runOptimization(const OptimizationConfig& config);
-    void showResults(const AbstrOptim::Result& result, const OptimizationConfig& config);
+    void showResults(const AbstrOptim::Result& result, const OptimizationConfig& config, double initialValue);
     void printPoint(const std::vector<double>& point);
+    static const char* methodName(OptimizationMethod method);
+    // Методы без градиента: критерий по норме градиента для них не предлагается
+    static bool isDerivativeFree(OptimizationMethod method);
     bool isPointInDomain(const std::vector<double>& point,
         const std::vector<double>& lower_bounds,
         const std::vector<double>& upper_bounds) const;
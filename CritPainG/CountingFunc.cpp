@@ -0,0 +1,218 @@
+﻿#include "pch.h"
+#include "CountingFunc.h"
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+// ---------------------------------------------------------------------------
+// CountingFunc
+// ---------------------------------------------------------------------------
+
+CountingFunc::CountingFunc(const AbstrFunc* f)
+    : func(f), valueCount(0), gradientCount(0), finiteDifferenceCount(0), batchCount(0), hessianCount(0) {
+    if (!f) {
+        throw std::invalid_argument("CountingFunc requires a function.");
+    }
+}
+
+double CountingFunc::operator()(const std::vector<double>& x) const {
+    valueCount.fetch_add(1, std::memory_order_relaxed);
+    if (insideNumericalGradient()) {
+        finiteDifferenceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return (*func)(x);
+}
+
+std::vector<double> CountingFunc::getGradient(const std::vector<double>& x) const {
+    // Считается после вызова: функции без аналитического градиента бросают исключение
+    std::vector<double> grad = func->getGradient(x);
+    gradientCount.fetch_add(1, std::memory_order_relaxed);
+    return grad;
+}
+
+std::string CountingFunc::getName() const {
+    return func->getName();
+}
+
+int CountingFunc::getDimension() const {
+    return func->getDimension();
+}
+
+double CountingFunc::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    double value = func->valueAndGradient(x, grad);
+    valueCount.fetch_add(1, std::memory_order_relaxed);
+    gradientCount.fetch_add(1, std::memory_order_relaxed);
+    return value;
+}
+
+void CountingFunc::evaluateBatch(const double* points, size_t count, double* values) const {
+    valueCount.fetch_add(static_cast<long long>(count), std::memory_order_relaxed);
+    if (insideNumericalGradient()) {
+        finiteDifferenceCount.fetch_add(static_cast<long long>(count), std::memory_order_relaxed);
+    }
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+    func->evaluateBatch(points, count, values);
+}
+
+void CountingFunc::gradientBatch(const double* points, size_t count, double* grads) const {
+    gradientCount.fetch_add(static_cast<long long>(count), std::memory_order_relaxed);
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+    func->gradientBatch(points, count, grads);
+}
+
+bool CountingFunc::isSeparable() const {
+    return func->isSeparable();
+}
+
+double CountingFunc::coordinateTerm(int j, double xj) const {
+    return func->coordinateTerm(j, xj);
+}
+
+bool CountingFunc::prefersWholeBatch() const {
+    return func->prefersWholeBatch();
+}
+
+std::vector<double> CountingFunc::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    std::vector<double> hv = func->hessianVectorProduct(x, v);
+    hessianCount.fetch_add(1, std::memory_order_relaxed);
+    return hv;
+}
+
+EvaluationCounts CountingFunc::counts() const {
+    EvaluationCounts c;
+    c.values = valueCount.load(std::memory_order_relaxed);
+    c.gradients = gradientCount.load(std::memory_order_relaxed);
+    c.finiteDifference = finiteDifferenceCount.load(std::memory_order_relaxed);
+    c.batchCalls = batchCount.load(std::memory_order_relaxed);
+    c.hessianProducts = hessianCount.load(std::memory_order_relaxed);
+    return c;
+}
+
+void CountingFunc::reset() {
+    valueCount = 0;
+    gradientCount = 0;
+    finiteDifferenceCount = 0;
+    batchCount = 0;
+    hessianCount = 0;
+}
+
+void CountingFunc::record(long long values, long long gradients) const {
+    valueCount.fetch_add(values, std::memory_order_relaxed);
+    gradientCount.fetch_add(gradients, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------
+// ProfiledFunc
+// ---------------------------------------------------------------------------
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+long long elapsedNanoseconds(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+} // namespace
+
+ProfiledFunc::ProfiledFunc(const AbstrFunc* f) : CountingFunc(f), totalTime(0) {
+    for (auto& b : buckets) b = 0;
+}
+
+void ProfiledFunc::addSample(long long nanoseconds) const {
+    int k = 0;
+    while (k + 1 < BUCKETS && (nanoseconds >> (k + 1)) > 0) ++k;
+    buckets[k].fetch_add(1, std::memory_order_relaxed);
+    totalTime.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+double ProfiledFunc::operator()(const std::vector<double>& x) const {
+    const Clock::time_point start = Clock::now();
+    double value = CountingFunc::operator()(x);
+    addSample(elapsedNanoseconds(start));
+    return value;
+}
+
+std::vector<double> ProfiledFunc::getGradient(const std::vector<double>& x) const {
+    const Clock::time_point start = Clock::now();
+    std::vector<double> grad = CountingFunc::getGradient(x);
+    addSample(elapsedNanoseconds(start));
+    return grad;
+}
+
+double ProfiledFunc::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    const Clock::time_point start = Clock::now();
+    double value = CountingFunc::valueAndGradient(x, grad);
+    addSample(elapsedNanoseconds(start));
+    return value;
+}
+
+void ProfiledFunc::evaluateBatch(const double* points, size_t count, double* values) const {
+    const Clock::time_point start = Clock::now();
+    CountingFunc::evaluateBatch(points, count, values);
+    addSample(elapsedNanoseconds(start));
+}
+
+void ProfiledFunc::gradientBatch(const double* points, size_t count, double* grads) const {
+    const Clock::time_point start = Clock::now();
+    CountingFunc::gradientBatch(points, count, grads);
+    addSample(elapsedNanoseconds(start));
+}
+
+std::vector<double> ProfiledFunc::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    const Clock::time_point start = Clock::now();
+    std::vector<double> hv = CountingFunc::hessianVectorProduct(x, v);
+    addSample(elapsedNanoseconds(start));
+    return hv;
+}
+
+std::vector<long long> ProfiledFunc::histogram() const {
+    std::vector<long long> h(BUCKETS);
+    for (int k = 0; k < BUCKETS; ++k) h[k] = buckets[k].load(std::memory_order_relaxed);
+    return h;
+}
+
+double ProfiledFunc::quantileNanoseconds(double q) const {
+    const std::vector<long long> h = histogram();
+    long long total = 0;
+    for (long long c : h) total += c;
+    if (total == 0) return 0.0;
+
+    const double target = q * static_cast<double>(total);
+    long long seen = 0;
+    for (int k = 0; k < BUCKETS; ++k) {
+        seen += h[k];
+        if (static_cast<double>(seen) >= target) {
+            return static_cast<double>(2LL << k);
+        }
+    }
+    return static_cast<double>(2LL << (BUCKETS - 1));
+}
+
+std::string ProfiledFunc::report() const {
+    const EvaluationCounts c = counts();
+    const std::vector<long long> h = histogram();
+    long long calls = 0;
+    for (long long n : h) calls += n;
+
+    std::ostringstream out;
+    out << "Values: " << c.values << " (finite differences: " << c.finiteDifference << ")"
+        << ", gradients: " << c.gradients << ", Hessian products: " << c.hessianProducts
+        << ", batch calls: " << c.batchCalls << "\n";
+    if (calls > 0) {
+        out << "Mean call: " << static_cast<double>(totalNanoseconds()) / calls << " ns"
+            << ", p50 < " << quantileNanoseconds(0.5) << " ns"
+            << ", p99 < " << quantileNanoseconds(0.99) << " ns\n";
+        for (int k = 0; k < BUCKETS; ++k) {
+            if (h[k] == 0) continue;
+            out << "  [" << (1LL << k) << ", " << (2LL << k) << ") ns: " << h[k] << "\n";
+        }
+    }
+    return out.str();
+}
+
+void ProfiledFunc::resetProfile() {
+    reset();
+    for (auto& b : buckets) b = 0;
+    totalTime = 0;
+}
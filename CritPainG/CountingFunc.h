@@ -0,0 +1,87 @@
+﻿#ifndef COUNTINGFUNC_H
+#define COUNTINGFUNC_H
+
+#include "AbstrFunc.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Счётчики вычислений функции
+struct EvaluationCounts {
+    long long values = 0;           // значения (точка пакета считается отдельно)
+    long long gradients = 0;        // градиенты (getGradient, valueAndGradient, пакеты)
+    long long finiteDifference = 0; // значения для численного градиента (FiniteDifference.h)
+    long long batchCalls = 0;       // вызовы evaluateBatch / gradientBatch
+    long long hessianProducts = 0;  // вызовы hessianVectorProduct
+};
+
+// Декоратор, считающий вызовы обёрнутой функции. Счётчики атомарные, поэтому
+// один CountingFunc можно использовать из нескольких потоков.
+// Каждый AbstrOptim оборачивает свою функцию в CountingFunc и переносит
+// счётчики в Result.
+class CountingFunc : public AbstrFunc {
+public:
+    explicit CountingFunc(const AbstrFunc* f);
+
+    double operator()(const std::vector<double>& x) const override;
+    std::vector<double> getGradient(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    int getDimension() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    // Слагаемые сепарабельной функции не считаются вычислениями значения
+    bool isSeparable() const override;
+    double coordinateTerm(int j, double xj) const override;
+    bool prefersWholeBatch() const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+
+    EvaluationCounts counts() const;
+    void reset();
+    // Учёт вычислений, сделанных в обход декоратора (например, FixedOptim.h)
+    void record(long long values, long long gradients) const;
+
+    const AbstrFunc* inner() const { return func; }
+
+protected:
+    const AbstrFunc* func;
+
+private:
+    mutable std::atomic<long long> valueCount;
+    mutable std::atomic<long long> gradientCount;
+    mutable std::atomic<long long> finiteDifferenceCount;
+    mutable std::atomic<long long> batchCount;
+    mutable std::atomic<long long> hessianCount;
+};
+
+// CountingFunc с гистограммой времени вызовов.
+// Корзина k содержит вызовы длительностью [2^k, 2^(k+1)) наносекунд.
+class ProfiledFunc : public CountingFunc {
+public:
+    static const int BUCKETS = 40;
+
+    explicit ProfiledFunc(const AbstrFunc* f);
+
+    double operator()(const std::vector<double>& x) const override;
+    std::vector<double> getGradient(const std::vector<double>& x) const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+
+    std::vector<long long> histogram() const;
+    long long totalNanoseconds() const { return totalTime.load(std::memory_order_relaxed); }
+    // Верхняя граница корзины, в которую попадает доля q вызовов (q в [0, 1])
+    double quantileNanoseconds(double q) const;
+    std::string report() const;
+    void resetProfile();
+
+private:
+    mutable std::atomic<long long> buckets[BUCKETS];
+    mutable std::atomic<long long> totalTime;
+
+    void addSample(long long nanoseconds) const;
+};
+
+#endif
@@ -3,11 +3,19 @@
 
 #include "CritPainGDoc.h"
 #include "OptimizationVisualizerDlg.h"
+#include "FixedOptim.h"
+#include "ExprFunc.h"
+#include "PluginFunc.h"
+#include "CachedFunc.h"
 
 #include <propkey.h>
 #include <sstream>
 #include <iomanip>
 #include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 
 #ifdef _DEBUG
 #define new DEBUG_NEW
@@ -22,6 +30,45 @@ BEGIN_MESSAGE_MAP(CCritPainGDoc, CDocument)
 	ON_COMMAND(ID_START, &CCritPainGDoc::OnOptimizationStart)
 END_MESSAGE_MAP()
 
+namespace
+{
+	// Оптимизатор для встроенной 2D-функции: точки на стеке, функция вызывается напрямую
+	template <class Func>
+	std::unique_ptr<AbstrOptim> MakeFixed2DOptimizer(const Func* func, int typeOpt,
+		std::unique_ptr<AbstrCriterial> criterial, const std::vector<double>& x0,
+		const std::vector<double>& lb, const std::vector<double>& ub,
+		double delta, double p, double alpha, double eps)
+	{
+		if (typeOpt == 0)
+		{
+			return std::make_unique<ConjugateGradientFRConstrainedFixed<2, Func>>(
+				func, std::move(criterial), x0, lb, ub, eps);
+		}
+		return std::make_unique<RandomSearchOptimFixed<2, Func>>(
+			func, std::move(criterial), x0, lb, ub, delta, std::random_device{}(), p, alpha);
+	}
+
+	// Формат файла. Старые файлы (версия 0) начинаются сразу с m_xMin; новые -
+	// с метки на её месте (NaN с этими битами, границей области он быть не может)
+	// и номера версии
+	const std::uint64_t FORMAT_MARKER = 0x7FF8435047464D54ULL;
+	const int FORMAT_VERSION = 2;  // 1 - формула пользовательской функции, 2 - путь к библиотеке
+
+	double FormatMarker()
+	{
+		double marker;
+		std::memcpy(&marker, &FORMAT_MARKER, sizeof(marker));
+		return marker;
+	}
+
+	bool IsFormatMarker(double value)
+	{
+		std::uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits == FORMAT_MARKER;
+	}
+}
+
 // CCritPainGDoc construction/destruction
 constexpr int CCritPainGDoc::DEFAULT_MAX_ITERATIONS;
 constexpr double CCritPainGDoc::DEFAULT_FUNC_CHANGE_EPS;
@@ -33,9 +80,12 @@ CCritPainGDoc::CCritPainGDoc() noexcept
 	, m_typeOpt(0)
 	, m_delta(0.5), m_p(0.2), m_alpha(0.8), m_epsilon(1e-6)
 	, m_selectedFunction(0)
+	, m_formula("(x-3)^2 + sin(y)*y")
 	, m_selectedCriterial(0)  // По умолчанию: 1000 итераций
 	, m_finalValue(0.0)
 	, m_iterations(0)
+	, m_functionEvaluations(0)
+	, m_gradientEvaluations(0)
 	, m_hasFunction(false)
 	, m_hasTrajectory(false)
 {
@@ -78,6 +128,8 @@ BOOL CCritPainGDoc::OnNewDocument()
 	m_finalPoint = m_initialPoint;
 	m_finalValue = 0.0;
 	m_iterations = 0;
+	m_functionEvaluations = 0;
+	m_gradientEvaluations = 0;
 	m_stopReason = "";
 	m_hasTrajectory = false;
 
@@ -102,11 +154,15 @@ void CCritPainGDoc::Serialize(CArchive& ar)
 {
 	if (ar.IsStoring())
 	{
+		ar << FormatMarker() << FORMAT_VERSION;
+
 		// Сохраняем параметры
 		ar << m_xMin << m_xMax << m_yMin << m_yMax;
 		ar << m_typeOpt;
 		ar << m_delta << m_p << m_alpha << m_epsilon;
 		ar << m_selectedCriterial << m_selectedFunction;
+		ar << CString(m_formula.c_str());
+		ar << CString(m_pluginPath.c_str());
 
 		// Сохраняем начальную точку
 		ar << static_cast<int>(m_initialPoint.size());
@@ -124,11 +180,34 @@ void CCritPainGDoc::Serialize(CArchive& ar)
 	}
 	else
 	{
+		// Версия формата; в старом файле прочитанное число - уже m_xMin
+		int version = 0;
+		ar >> m_xMin;
+		if (IsFormatMarker(m_xMin))
+		{
+			ar >> version;
+			if (version < 1 || version > FORMAT_VERSION)
+				AfxThrowArchiveException(CArchiveException::badSchema);
+			ar >> m_xMin;
+		}
+
 		// Загружаем параметры
-		ar >> m_xMin >> m_xMax >> m_yMin >> m_yMax;
+		ar >> m_xMax >> m_yMin >> m_yMax;
 		ar >> m_typeOpt;
 		ar >> m_delta >> m_p >> m_alpha >> m_epsilon;
 		ar >> m_selectedCriterial >> m_selectedFunction;
+		if (version >= 1)
+		{
+			CString formula;
+			ar >> formula;
+			m_formula = std::string(CT2A(formula));
+		}
+		if (version >= 2)
+		{
+			CString pluginPath;
+			ar >> pluginPath;
+			m_pluginPath = std::string(CT2A(pluginPath));
+		}
 
 		// Загружаем начальную точку
 		int size;
@@ -176,51 +255,40 @@ void CCritPainGDoc::Create2DFunction(int funcIndex)
 	case 0: // Quadratic 2D
 		m_currentFunc = std::make_unique<QuadraticFunc2D>();
 		break;
-	case 1: // Sphere 2D - нужно создать адаптер для 2D
-		// Временно используем сферу с двумя измерениями
-		// Создаем простую сферу для 2D
-		class SphereFunc2D : public AbstrFunc {
-		public:
-			double operator()(const std::vector<double>& x) const override {
-				if (x.size() != 2) throw std::invalid_argument("Need 2D point");
-				return x[0] * x[0] + x[1] * x[1];
-			}
-			std::vector<double> getGradient(const std::vector<double>& x) const override {
-				if (x.size() != 2) throw std::invalid_argument("Need 2D point");
-				return { 2 * x[0], 2 * x[1] };
-			}
-			std::string getName() const override { return "Sphere 2D: f(x,y)=x^2+y^2"; }
-			int getDimension() const override { return 2; }
-		};
+	case 1: // Sphere 2D
 		m_currentFunc = std::make_unique<SphereFunc2D>();
 		break;
-	case 2: // Rastrigin 2D - нужно создать адаптер для 2D
-		// Временно используем Rastrigin для 2D
-		class RastriginFunc2D : public AbstrFunc {
-		public:
-			double operator()(const std::vector<double>& x) const override {
-				if (x.size() != 2) throw std::invalid_argument("Need 2D point");
-				const double A = 10.0;
-				const double PI = 3.14159265358979323846;
-				return 2 * A + x[0] * x[0] - A * cos(2 * PI * x[0])
-					+ x[1] * x[1] - A * cos(2 * PI * x[1]);
-			}
-			std::vector<double> getGradient(const std::vector<double>& x) const override {
-				if (x.size() != 2) throw std::invalid_argument("Need 2D point");
-				const double A = 10.0;
-				const double PI = 3.14159265358979323846;
-				return {
-					2 * x[0] + 2 * PI * A * sin(2 * PI * x[0]),
-					2 * x[1] + 2 * PI * A * sin(2 * PI * x[1])
-				};
-			}
-			std::string getName() const override {
-				return "Rastrigin 2D: f(x,y)=20+x^2+y^2-10(cos(2*pi*x)+cos(2*pi*y))";
-			}
-			int getDimension() const override { return 2; }
-		};
+	case 2: // Rastrigin 2D
 		m_currentFunc = std::make_unique<RastriginFunc2D>();
 		break;
+	case 3: // Пользовательская формула
+		try
+		{
+			m_currentFunc = std::make_unique<ExprFunc>(m_formula, 2);
+		}
+		catch (const std::exception&)
+		{
+			// Некорректная формула - функция по умолчанию
+			m_selectedFunction = 0;
+			m_currentFunc = std::make_unique<QuadraticFunc2D>();
+		}
+		break;
+	case 4: // Функция из библиотеки (CritPainGPlugin.h)
+		try
+		{
+			auto plugin = std::make_unique<PluginFunc>(m_pluginPath);
+			if (plugin->getDimension() != 2)
+				throw std::runtime_error("Plugin function must be two-dimensional");
+			// Библиотечная функция может быть дорогой: повторные точки берутся из кэша
+			m_currentFunc = std::make_unique<CachedFunc>(std::move(plugin));
+		}
+		catch (const std::exception&)
+		{
+			// Библиотека не загрузилась или не двумерная - функция по умолчанию
+			m_selectedFunction = 0;
+			m_currentFunc = std::make_unique<QuadraticFunc2D>();
+		}
+		break;
 	default:
 		m_currentFunc = std::make_unique<QuadraticFunc2D>();
 		break;
@@ -261,6 +329,30 @@ void CCritPainGDoc::SetupOptimizer()
 	std::vector<double> lower_bounds = { m_xMin, m_yMin };
 	std::vector<double> upper_bounds = { m_xMax, m_yMax };
 
+	// Встроенные функции идут по пути с фиксированной размерностью
+	if (m_typeOpt == 0 || m_typeOpt == 1)
+	{
+		const AbstrFunc* func = m_currentFunc.get();
+		if (auto quadratic = dynamic_cast<const QuadraticFunc2D*>(func))
+		{
+			m_optimizer = MakeFixed2DOptimizer(quadratic, m_typeOpt, std::move(criterial),
+				m_initialPoint, lower_bounds, upper_bounds, m_delta, m_p, m_alpha, m_epsilon);
+			return;
+		}
+		if (auto sphere = dynamic_cast<const SphereFunc2D*>(func))
+		{
+			m_optimizer = MakeFixed2DOptimizer(sphere, m_typeOpt, std::move(criterial),
+				m_initialPoint, lower_bounds, upper_bounds, m_delta, m_p, m_alpha, m_epsilon);
+			return;
+		}
+		if (auto rastrigin = dynamic_cast<const RastriginFunc2D*>(func))
+		{
+			m_optimizer = MakeFixed2DOptimizer(rastrigin, m_typeOpt, std::move(criterial),
+				m_initialPoint, lower_bounds, upper_bounds, m_delta, m_p, m_alpha, m_epsilon);
+			return;
+		}
+	}
+
 	// Создаем оптимизатор
 	if (m_typeOpt == 0) // Градиенты с ограничениями
 	{
@@ -289,11 +381,24 @@ void CCritPainGDoc::SetupOptimizer()
 			m_alpha
 			);
 	}
+	else if (m_typeOpt == 2) // L-BFGS-B
+	{
+		m_optimizer = std::make_unique<LBFGSB>(
+			m_currentFunc.get(),
+			std::move(criterial),
+			m_initialPoint,
+			lower_bounds,
+			upper_bounds,
+			10,       // history
+			m_epsilon // grad_epsilon
+			);
+	}
 }
 
 void CCritPainGDoc::SetOptimizationParams(double x1, double x2, double y1, double y2,
 	int typeOpt, double delta, double p, double alpha,
-	double eps, int criterialType, int funcIndex)  // Изменен параметр!
+	double eps, int criterialType, int funcIndex, const std::string& formula,
+	const std::string& pluginPath)
 {
 	// Устанавливаем границы области
 	m_xMin = (std::min)(x1, x2);
@@ -313,6 +418,8 @@ void CCritPainGDoc::SetOptimizationParams(double x1, double x2, double y1, doubl
 
 	// Устанавливаем выбранную функцию
 	m_selectedFunction = funcIndex;  
+	m_formula = formula;
+	m_pluginPath = pluginPath;
 	Create2DFunction(funcIndex);     
 
 	// Сбрасываем траекторию
@@ -334,7 +441,8 @@ void CCritPainGDoc::SetOptimizationParams(double x1, double x2, double y1, doubl
 
 void CCritPainGDoc::GetOptimizationParams(double& x1, double& x2, double& y1, double& y2,
 	int& typeOpt, double& delta, double& p, double& alpha,
-	double& eps, int& criterialType, int& funcIndex) const  // Изменен параметр!
+	double& eps, int& criterialType, int& funcIndex, std::string& formula,
+	std::string& pluginPath) const
 {
 	x1 = m_xMin;
 	x2 = m_xMax;
@@ -347,6 +455,8 @@ void CCritPainGDoc::GetOptimizationParams(double& x1, double& x2, double& y1, do
 	eps = m_epsilon;
 	criterialType = m_selectedCriterial;  // Тип критерия
 	funcIndex = m_selectedFunction;
+	formula = m_formula;
+	pluginPath = m_pluginPath;
 }
 
 void CCritPainGDoc::OnSettings()
@@ -363,6 +473,8 @@ void CCritPainGDoc::OnSettings()
 	dlg.m_TypeOpt = GetTypeOpt();
 	dlg.m_CriterialType = GetSelectedCriterial();
 	dlg.m_SelectedFunction = GetSelectedFunction();
+	dlg.m_Formula = CString(m_formula.c_str());
+	dlg.m_PluginPath = CString(m_pluginPath.c_str());
 
 	// Пропускаем сложные параметры для теста
 	dlg.m_DELTA = GetDelta();
@@ -384,7 +496,9 @@ void CCritPainGDoc::OnSettings()
 			dlg.m_ALPA,  // alpha
 			dlg.m_EPS,   // epsilon
 			dlg.m_CriterialType, // criterialType 
-			dlg.m_SelectedFunction // funcIndex
+			dlg.m_SelectedFunction, // funcIndex
+			std::string(CT2A(dlg.m_Formula)), // formula
+			std::string(CT2A(dlg.m_PluginPath)) // pluginPath
 		);
 
 		UpdateAllViews(NULL);
@@ -444,6 +558,8 @@ bool CCritPainGDoc::StartOptimization()
 		// Отладочный вывод
 		TRACE(_T("Optimization completed:\n"));
 		TRACE(_T("  Iterations: %d\n"), result.iterations);
+		TRACE(_T("  Evaluations: f %lld (fd %lld), grad %lld\n"),
+			result.function_evaluations, result.fd_evaluations, result.gradient_evaluations);
 		TRACE(_T("  Trajectory points: %d\n"), (int)result.trajectory.size());
 		TRACE(_T("  Stop reason: %s\n"), CString(result.stop_reason.c_str()));
 
@@ -451,6 +567,8 @@ bool CCritPainGDoc::StartOptimization()
 		m_finalPoint = result.point;
 		m_finalValue = result.value;
 		m_iterations = result.iterations;
+		m_functionEvaluations = result.function_evaluations;
+		m_gradientEvaluations = result.gradient_evaluations;
 		m_stopReason = result.stop_reason;
 		m_trajectory = result.trajectory;
 		m_hasTrajectory = !m_trajectory.empty();
@@ -492,6 +610,17 @@ double CCritPainGDoc::CalculateFunctionValue(double x, double y) const
 	return (*m_currentFunc)({ x, y });
 }
 
+void CCritPainGDoc::CalculateFunctionValues(const double* points, size_t count, double* values) const
+{
+	if (!m_currentFunc)
+	{
+		std::fill(values, values + count, 0.0);
+		return;
+	}
+
+	m_currentFunc->evaluateBatch(points, count, values);
+}
+
 // Обработчики команд
 void CCritPainGDoc::OnOptimizationStart()
 {
@@ -501,8 +630,10 @@ void CCritPainGDoc::OnOptimizationStart()
 
 		
 		CString message;
-		message.Format(_T("Оптимизация завершена!\n\nИтераций: %d\nФинальная точка: (%.4f, %.4f)\nЗначение функции: %.6f\nПричина остановки: %s"),
+		message.Format(_T("Оптимизация завершена!\n\nИтераций: %d\nВычислений функции: %lld\nВычислений градиента: %lld\nФинальная точка: (%.4f, %.4f)\nЗначение функции: %.6f\nПричина остановки: %s"),
 			m_iterations,
+			m_functionEvaluations,
+			m_gradientEvaluations,
 			m_finalPoint[0],
 			m_finalPoint[1],
 			m_finalValue,
@@ -521,11 +652,13 @@ void CCritPainGDoc::Dump(CDumpContext& dc) const
 {
 	dc << "Optimization Document\n";
 	dc << "Bounds: [" << m_xMin << ", " << m_xMax << "] x [" << m_yMin << ", " << m_yMax << "]\n";
-	dc << "Method: " << (m_typeOpt == 0 ? "Constrained Gradients" : "Random Search") << "\n";
+	dc << "Method: " << (m_typeOpt == 0 ? "Constrained Gradients" : m_typeOpt == 1 ? "Random Search" : "L-BFGS-B") << "\n";
 	dc << "Initial point: (" << m_initialPoint[0] << ", " << m_initialPoint[1] << ")\n";
 	dc << "Final point: (" << m_finalPoint[0] << ", " << m_finalPoint[1] << ")\n";
 	dc << "Final value: " << m_finalValue << "\n";
 	dc << "Iterations: " << m_iterations << "\n";
+	dc << "Function evaluations: " << (LONGLONG)m_functionEvaluations << "\n";
+	dc << "Gradient evaluations: " << (LONGLONG)m_gradientEvaluations << "\n";
 	dc << "Trajectory points: " << m_trajectory.size() << "\n";
 
 	CDocument::Dump(dc);
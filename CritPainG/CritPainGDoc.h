@@ -47,6 +47,8 @@ private:
 	std::vector<double> m_finalPoint;
 	double m_finalValue;
 	int m_iterations;
+	long long m_functionEvaluations;
+	long long m_gradientEvaluations;
 	static constexpr int DEFAULT_MAX_ITERATIONS = 10000;
 	static constexpr double DEFAULT_FUNC_CHANGE_EPS = 1e-6;
 	static constexpr double DEFAULT_POINT_CHANGE_EPS = 1e-6;
@@ -54,10 +56,12 @@ private:
 
 	// Параметры оптимизации
 	double m_xMin, m_xMax, m_yMin, m_yMax;
-	int m_typeOpt;           // 0 - градиенты с ограничениями, 1 - случайный поиск
+	int m_typeOpt;           // 0 - градиенты с ограничениями, 1 - случайный поиск, 2 - L-BFGS-B
 	double m_delta, m_p, m_alpha, m_epsilon;
 	int m_selectedCriterial;
 	int m_selectedFunction;
+	std::string m_formula;   // Формула для пользовательской функции (m_selectedFunction == 3)
+	std::string m_pluginPath;  // Библиотека с функцией (m_selectedFunction == 4)
 
 	// Состояние
 	bool m_hasFunction;
@@ -71,17 +75,21 @@ public:
 	// Методы для работы с данными
 	void SetOptimizationParams(double x1, double x2, double y1, double y2,
 		int typeOpt, double delta, double p, double alpha,
-		double eps, int maxit, int funcIndex);
+		double eps, int maxit, int funcIndex, const std::string& formula,
+		const std::string& pluginPath);
 	virtual BOOL SaveModified() override { return TRUE; }
 	int GetSelectedCriterial() const { return m_selectedCriterial; }
 	int GetSelectedFunction() const { return m_selectedFunction; }
+	const std::string& GetFormula() const { return m_formula; }
+	const std::string& GetPluginPath() const { return m_pluginPath; }
 
 	int GetDefaultMaxIterations() const { return DEFAULT_MAX_ITERATIONS; }
 	void SetSelectedCriterial(int value) { m_selectedCriterial = value; }
 	// Получение параметров для передачи в диалог
 	void GetOptimizationParams(double& x1, double& x2, double& y1, double& y2,
 		int& typeOpt, double& delta, double& p, double& alpha,
-		double& eps, int& maxit, int& funcIndex) const;
+		double& eps, int& maxit, int& funcIndex, std::string& formula,
+		std::string& pluginPath) const;
 
 	void SetInitialPoint(double x, double y);
 	bool StartOptimization();
@@ -92,6 +100,8 @@ public:
 	const std::vector<double>& GetFinalPoint() const { return m_finalPoint; }
 	double GetFinalValue() const { return m_finalValue; }
 	int GetIterations() const { return m_iterations; }
+	long long GetFunctionEvaluations() const { return m_functionEvaluations; }
+	long long GetGradientEvaluations() const { return m_gradientEvaluations; }
 	std::string GetStopReason() const { return m_stopReason; }
 	
 	double GetDelta() const { return m_delta; }
@@ -116,6 +126,8 @@ public:
 	bool HasTrajectory() const { return m_hasTrajectory; }
 
 	double CalculateFunctionValue(double x, double y) const;
+	// Пакетное вычисление: points = [x0..xn-1, y0..yn-1]
+	void CalculateFunctionValues(const double* points, size_t count, double* values) const;
 
 	afx_msg void OnSettings();
 	afx_msg void OnOptimizationStart();
@@ -0,0 +1,74 @@
+﻿#ifndef CRITPAINGPLUGIN_H
+#define CRITPAINGPLUGIN_H
+
+/*
+ * C ABI подключаемых целевых функций (.dll / .so), см. PluginFunc.h.
+ *
+ * Библиотека экспортирует одну функцию critpain_plugin(), возвращающую
+ * указатель на статическую таблицу CritPainPlugin. Пример:
+ *
+ *     #include "CritPainGPlugin.h"
+ *
+ *     static double eval(const double* x) { return x[0] * x[0] + 10.0 * x[1] * x[1]; }
+ *
+ *     static void evalBatch(const double* points, size_t count, double* values) {
+ *         const double* x = points;
+ *         const double* y = points + count;
+ *         for (size_t i = 0; i < count; ++i) values[i] = x[i] * x[i] + 10.0 * y[i] * y[i];
+ *     }
+ *
+ *     CRITPAIN_PLUGIN_EXPORT const CritPainPlugin* critpain_plugin(void) {
+ *         static const CritPainPlugin plugin = {
+ *             CRITPAIN_PLUGIN_ABI_VERSION, 2, "Ellipse: x^2 + 10y^2",
+ *             eval, evalBatch, NULL, NULL
+ *         };
+ *         return &plugin;
+ *     }
+ *
+ * Функции вызываются из нескольких потоков одновременно и не должны
+ * сохранять состояние между вызовами. Исключения C++ через границу не проходят.
+ */
+
+#include <stddef.h>
+
+#define CRITPAIN_PLUGIN_ABI_VERSION 1
+#define CRITPAIN_PLUGIN_ENTRY "critpain_plugin"
+
+#if defined(_WIN32)
+#define CRITPAIN_PLUGIN_EXPORT_ATTR __declspec(dllexport)
+#else
+#define CRITPAIN_PLUGIN_EXPORT_ATTR __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+#define CRITPAIN_PLUGIN_EXPORT extern "C" CRITPAIN_PLUGIN_EXPORT_ATTR
+#else
+#define CRITPAIN_PLUGIN_EXPORT CRITPAIN_PLUGIN_EXPORT_ATTR
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct CritPainPlugin {
+    int abiVersion;     /* CRITPAIN_PLUGIN_ABI_VERSION */
+    int dimension;      /* > 0 */
+    const char* name;
+
+    /* Значение в точке x[0..dimension) - обязательно */
+    double (*evaluate)(const double* x);
+    /* Пакет SoA: j-я координата i-й точки в points[j * count + i] - обязательно */
+    void (*evaluateBatch)(const double* points, size_t count, double* values);
+    /* Градиент в grad[0..dimension); NULL - градиента нет (будет численный) */
+    void (*gradient)(const double* x, double* grad);
+    /* Пакет градиентов в раскладке SoA; NULL - по точкам через gradient */
+    void (*gradientBatch)(const double* points, size_t count, double* grads);
+} CritPainPlugin;
+
+typedef const CritPainPlugin* (*CritPainPluginEntry)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
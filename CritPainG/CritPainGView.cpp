@@ -13,6 +13,9 @@
 #include "CritPainGDoc.h"
 #include "CritPainGView.h"
 
+#include <vector>
+#include <algorithm>
+
 #ifdef _DEBUG
 #define new DEBUG_NEW
 #endif
@@ -112,11 +115,14 @@ void CCritPainGView::OnDraw(CDC* pDC)
         info.Format(_T("Начальная точка: (%.3f, %.3f)\n")
             _T("Финальная точка: (%.3f, %.3f)\n")
             _T("Значение функции: %.6f\n")
-            _T("Итераций: %d"),
+            _T("Итераций: %d\n")
+            _T("Вычислений f / grad: %lld / %lld"),
             initialPoint[0], initialPoint[1],  // Начальная точка
             finalPoint[0], finalPoint[1],      // Финальная точка
             pDoc->GetFinalValue(),
-            pDoc->GetIterations());
+            pDoc->GetIterations(),
+            pDoc->GetFunctionEvaluations(),
+            pDoc->GetGradientEvaluations());
     }
     else
     {
@@ -172,19 +178,33 @@ void CCritPainGView::DrawFunctionMap(CDC& dc, const CRect& rect)
     double fMin = DBL_MAX;
     double fMax = -DBL_MAX;
 
-    // Быстрый проход для определения диапазона
+    // Быстрый проход для определения диапазона (одним пакетом)
+    const int SAMPLE_X = (GRID_X + 9) / 10;
+    const int SAMPLE_Y = (GRID_Y + 9) / 10;
+    const size_t sampleCount = static_cast<size_t>(SAMPLE_X) * SAMPLE_Y;
+    std::vector<double> points(2 * sampleCount);
+    std::vector<double> values(sampleCount);
+
+    size_t k = 0;
     for (int i = 0; i < GRID_X; i += 10)
     {
         double x = xMin + (xMax - xMin) * i / (GRID_X - 1);
         for (int j = 0; j < GRID_Y; j += 10)
         {
             double y = yMin + (yMax - yMin) * j / (GRID_Y - 1);
-            double val = pDoc->CalculateFunctionValue(x, y);
-            fMin = min(fMin, val);
-            fMax = max(fMax, val);
+            points[k] = x;
+            points[sampleCount + k] = y;
+            ++k;
         }
     }
 
+    pDoc->CalculateFunctionValues(points.data(), sampleCount, values.data());
+    for (double val : values)
+    {
+        fMin = min(fMin, val);
+        fMax = max(fMax, val);
+    }
+
     // Если все значения одинаковые
     if (fabs(fMax - fMin) < 1e-10)
     {
@@ -192,19 +212,28 @@ void CCritPainGView::DrawFunctionMap(CDC& dc, const CRect& rect)
         fMax += 1.0;
     }
 
-    // Рисуем каждый пиксель
-    for (int sx = 0; sx < rect.Width(); sx++)
+    // Рисуем построчно: вся строка пикселей вычисляется одним пакетом
+    const int width = rect.Width();
+    const size_t rowCount = static_cast<size_t>(width);
+    points.resize(2 * rowCount);
+    values.resize(rowCount);
+
+    for (int sx = 0; sx < width; sx++)
     {
-        double x = xMin + (xMax - xMin) * sx / rect.Width();
+        points[sx] = xMin + (xMax - xMin) * sx / width;
+    }
 
-        for (int sy = 0; sy < rect.Height(); sy++)
-        {
-            double y = yMax - (yMax - yMin) * sy / rect.Height();
+    for (int sy = 0; sy < rect.Height(); sy++)
+    {
+        double y = yMax - (yMax - yMin) * sy / rect.Height();
+        std::fill(points.begin() + rowCount, points.end(), y);
 
-            double val = pDoc->CalculateFunctionValue(x, y);
+        pDoc->CalculateFunctionValues(points.data(), rowCount, values.data());
 
+        for (int sx = 0; sx < width; sx++)
+        {
             // Нормализуем значение
-            double t = (val - fMin) / (fMax - fMin);
+            double t = (values[sx] - fMin) / (fMax - fMin);
             t = max(0.0, min(1.0, t));
 
             // Градиент: от синего (мин) к красному (макс)
@@ -0,0 +1,229 @@
+﻿#include "pch.h"
+#include "DifferentialEvolution.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+// Сравнения значений, в которых NaN хуже любого числа
+bool better(double a, double b) {
+    return !std::isnan(a) && (std::isnan(b) || a < b);
+}
+
+// Пробный вектор заменяет родителя при не худшем значении
+bool notWorse(double trial, double target) {
+    return !std::isnan(trial) && (std::isnan(target) || trial <= target);
+}
+
+} // namespace
+
+DifferentialEvolution::DifferentialEvolution(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, const std::vector<double>& lb,
+    const std::vector<double>& ub, DEStrategy strategy, size_t population,
+    double F, double CR, unsigned int seed)
+    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub),
+    population_size(population), strategy(strategy), F(F), CR(CR), f_tolerance(1e-12),
+    gen(seed), mu_F(F), mu_CR(CR) {
+    if (x0.empty()) {
+        throw std::invalid_argument("Initial point must not be empty.");
+    }
+    if (population != 0 && population < 4) {
+        throw std::invalid_argument("Population size must be 0 (default) or at least 4.");
+    }
+    if (!(F > 0.0) || F > 2.0) {
+        throw std::invalid_argument("Differential weight F must be in (0, 2].");
+    }
+    if (!(CR >= 0.0 && CR <= 1.0)) {
+        throw std::invalid_argument("Crossover probability CR must be in [0, 1].");
+    }
+    if (lb.size() != ub.size() || lb.size() != x0.size()) {
+        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+    }
+    for (size_t i = 0; i < lb.size(); ++i) {
+        if (lb[i] > ub[i]) {
+            throw std::invalid_argument("Lower bound must be <= upper bound.");
+        }
+        if (x0[i] < lb[i] || x0[i] > ub[i]) {
+            throw std::invalid_argument("Initial point must be inside the box D.");
+        }
+    }
+}
+
+void DifferentialEvolution::setTolerance(double f_tol) {
+    if (f_tol < 0.0) {
+        throw std::invalid_argument("Population tolerance must be non-negative.");
+    }
+    f_tolerance = f_tol;
+}
+
+AbstrOptim::Result DifferentialEvolution::run() {
+    trajectory.clear();
+    const size_t n = initialPoint.size();
+    const size_t np = population_size > 0 ? population_size : (std::max)(static_cast<size_t>(20), 10 * n);
+    const bool jade = strategy == DEStrategy::JADE;
+    mu_F = F;
+    mu_CR = CR;
+
+    // Популяция, пробные векторы и архив JADE в раскладке SoA: координата j особи i - [j * np + i]
+    std::vector<double> pop(n * np), trial(n * np), archive(jade ? n * np : 0);
+    std::vector<double> fit(np), trial_fit(np);
+    size_t archive_size = 0;
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<size_t> pick(0, np - 1);
+    std::uniform_int_distribution<size_t> pick_coordinate(0, n - 1);
+    std::normal_distribution<double> normal(0.0, 0.1);
+
+    for (size_t j = 0; j < n; ++j) {
+        double* row = &pop[j * np];
+        row[0] = initialPoint[j];
+        for (size_t i = 1; i < np; ++i) {
+            row[i] = lower_bounds[j] + uniform(gen) * (upper_bounds[j] - lower_bounds[j]);
+        }
+    }
+    evaluatePopulation(*func, pop.data(), n, np, fit.data(), populationOptions);
+
+    auto bestIndex = [&]() {
+        size_t b = 0;
+        for (size_t i = 1; i < np; ++i) {
+            if (better(fit[i], fit[b])) b = i;
+        }
+        return b;
+    };
+    size_t best = bestIndex();
+    std::vector<double> best_point(n);
+    for (size_t j = 0; j < n; ++j) best_point[j] = pop[j * np + best];
+    double best_value = fit[best];
+    addPointToTrajectory(best_point);
+
+    // Параметры и индексы особей поколения
+    std::vector<double> Fi(np), CRi(np);
+    std::vector<size_t> r1(np), r2(np), r3(np), jrand(np);
+    std::vector<size_t> order(np);
+    std::vector<char> replaced(np);
+    std::vector<double> success_F, success_CR;
+    // Доля лучших особей для x_pbest и скорость адаптации JADE
+    const size_t p_count = (std::max)(static_cast<size_t>(2), static_cast<size_t>(0.05 * np + 0.5));
+    const double adaptation = 0.1;
+    const double pi = 3.14159265358979323846;
+
+    int iteration = 0;
+    const int max_fallback_iterations = MaxI;
+
+    while (!criterial->isSatisfied(best_point, best_value, iteration)) {
+        if (iteration >= max_fallback_iterations) {
+            return { best_point, best_value, iteration,
+                     "Fallback: reached maximum iterations", trajectory };
+        }
+        const auto range = std::minmax_element(fit.begin(), fit.end());
+        if (*range.second - *range.first <= f_tolerance) {
+            return { best_point, best_value, iteration,
+                     "Population converged", trajectory };
+        }
+
+        if (jade) {
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::nth_element(order.begin(), order.begin() + (p_count - 1), order.end(),
+                [&](size_t a, size_t b) { return better(fit[a], fit[b]); });
+        }
+
+        // Индексы и параметры: r1, r2, r3 различны и не равны i; в JADE r1 - одна
+        // из лучших особей (может совпасть с i), r3 - из популяции и архива
+        for (size_t i = 0; i < np; ++i) {
+            if (jade) {
+                r1[i] = order[static_cast<size_t>(uniform(gen) * p_count) % p_count];
+                do { r2[i] = pick(gen); } while (r2[i] == i);
+                const size_t pool = np + archive_size;
+                do { r3[i] = static_cast<size_t>(uniform(gen) * pool) % pool; } while (r3[i] == i || r3[i] == r2[i]);
+                double f;
+                do { f = mu_F + 0.1 * std::tan(pi * (uniform(gen) - 0.5)); } while (!(f > 0.0));
+                Fi[i] = (std::min)(f, 1.0);
+                CRi[i] = (std::max)(0.0, (std::min)(1.0, mu_CR + normal(gen)));
+            }
+            else {
+                do { r1[i] = pick(gen); } while (r1[i] == i);
+                do { r2[i] = pick(gen); } while (r2[i] == i || r2[i] == r1[i]);
+                do { r3[i] = pick(gen); } while (r3[i] == i || r3[i] == r1[i] || r3[i] == r2[i]);
+                Fi[i] = F;
+                CRi[i] = CR;
+            }
+            jrand[i] = pick_coordinate(gen);
+        }
+
+        // Мутация и биномиальное скрещивание по строкам координат
+        for (size_t j = 0; j < n; ++j) {
+            const double* x = &pop[j * np];
+            const double* a = jade ? &archive[j * np] : nullptr;
+            double* t = &trial[j * np];
+            const double lo = lower_bounds[j], hi = upper_bounds[j];
+            for (size_t i = 0; i < np; ++i) {
+                if (uniform(gen) >= CRi[i] && j != jrand[i]) {
+                    t[i] = x[i];
+                    continue;
+                }
+                double v;
+                switch (strategy) {
+                case DEStrategy::Rand1:
+                    v = x[r1[i]] + Fi[i] * (x[r2[i]] - x[r3[i]]);
+                    break;
+                case DEStrategy::CurrentToBest1:
+                    v = x[i] + Fi[i] * (x[best] - x[i]) + Fi[i] * (x[r1[i]] - x[r2[i]]);
+                    break;
+                default: {
+                    const double xr3 = r3[i] < np ? x[r3[i]] : a[r3[i] - np];
+                    v = x[i] + Fi[i] * (x[r1[i]] - x[i]) + Fi[i] * (x[r2[i]] - xr3);
+                    break;
+                }
+                }
+                t[i] = (std::max)(lo, (std::min)(hi, v));
+            }
+        }
+
+        evaluatePopulation(*func, trial.data(), n, np, trial_fit.data(), populationOptions);
+
+        // Отбор; вытесненные родители JADE уходят в архив
+        success_F.clear();
+        success_CR.clear();
+        for (size_t i = 0; i < np; ++i) {
+            replaced[i] = notWorse(trial_fit[i], fit[i]);
+            if (!replaced[i]) continue;
+            if (jade && better(trial_fit[i], fit[i])) {
+                success_F.push_back(Fi[i]);
+                success_CR.push_back(CRi[i]);
+                const size_t slot = archive_size < np ? archive_size++ : pick(gen);
+                for (size_t j = 0; j < n; ++j) archive[j * np + slot] = pop[j * np + i];
+            }
+            fit[i] = trial_fit[i];
+        }
+        for (size_t j = 0; j < n; ++j) {
+            double* x = &pop[j * np];
+            const double* t = &trial[j * np];
+            for (size_t i = 0; i < np; ++i) {
+                if (replaced[i]) x[i] = t[i];
+            }
+        }
+
+        if (jade && !success_F.empty()) {
+            double sum_F = 0.0, sum_F2 = 0.0;
+            for (double f : success_F) {
+                sum_F += f;
+                sum_F2 += f * f;
+            }
+            const double mean_CR = std::accumulate(success_CR.begin(), success_CR.end(), 0.0) / success_CR.size();
+            mu_F = (1.0 - adaptation) * mu_F + adaptation * sum_F2 / sum_F;
+            mu_CR = (1.0 - adaptation) * mu_CR + adaptation * mean_CR;
+        }
+
+        best = bestIndex();
+        if (better(fit[best], best_value)) {
+            for (size_t j = 0; j < n; ++j) best_point[j] = pop[j * np + best];
+            best_value = fit[best];
+            addPointToTrajectory(best_point);
+        }
+        iteration++;
+    }
+
+    return { best_point, best_value, iteration, "Criterial satisfied", trajectory };
+}
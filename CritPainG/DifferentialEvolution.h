@@ -0,0 +1,68 @@
+﻿#ifndef DIFFERENTIALEVOLUTION_H
+#define DIFFERENTIALEVOLUTION_H
+
+#include "AbstrOptim.h"
+#include "Population.h"
+#include <random>
+#include <vector>
+
+// Схема мутации дифференциальной эволюции; скрещивание везде биномиальное
+enum class DEStrategy {
+    Rand1,          // v = x_r1 + F (x_r2 - x_r3)
+    CurrentToBest1, // v = x_i + F (x_best - x_i) + F (x_r1 - x_r2)
+    JADE            // current-to-pbest/1 с архивом и адаптацией F, CR (Чжан-Сандерсон)
+};
+
+// Дифференциальная эволюция в параллелепипеде lb, ub.
+//
+// Популяция и пробные векторы хранятся по координатам (SoA): j-я координата
+// i-й особи - в pop[j * NP + i], как в пакетах evaluateBatch. Мутация и
+// скрещивание идут координата за координатой по всей популяции, так что
+// внутренний цикл читает и пишет строку подряд, а пробные векторы поколения
+// целиком уходят в evaluatePopulation (части пакета - в потоках
+// ThreadPool::shared()). Случайные числа берутся в вызывающем потоке до
+// вычисления, поэтому результат при заданном seed не зависит от числа потоков.
+//
+// Координата мутанта вне параллелепипеда обрезается по границе, как у
+// RandomSearchOptim. Итерация - одно поколение; первая особь - x0, остальные
+// равномерно распределены в параллелепипеде.
+//
+// JADE: F_i ~ Cauchy(mu_F, 0.1), CR_i ~ N(mu_CR, 0.1); mu_F сдвигается к
+// среднему Лемера, mu_CR - к среднему арифметическому удачных значений; x_pbest -
+// одна из 5% лучших особей, x_r2 берётся из популяции и архива вытесненных
+// родителей.
+class DifferentialEvolution : public AbstrOptim {
+private:
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    size_t population_size;  // 0 - 10 n, но не меньше 20
+    DEStrategy strategy;
+    double F;
+    double CR;
+    double f_tolerance;
+    PopulationOptions populationOptions;
+    std::mt19937 gen;
+    double mu_F;
+    double mu_CR;
+
+public:
+    // F и CR - постоянные параметры для Rand1 и CurrentToBest1, начальные
+    // mu_F и mu_CR для JADE
+    DifferentialEvolution(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, const std::vector<double>& lb,
+        const std::vector<double>& ub, DEStrategy strategy = DEStrategy::JADE,
+        size_t population = 0, double F = 0.5, double CR = 0.9,
+        unsigned int seed = std::random_device{}());
+
+    // Остановка, когда разброс значений в популяции не больше f_tol
+    void setTolerance(double f_tol);
+    void setPopulationOptions(const PopulationOptions& options) { populationOptions = options; }
+    // Параметры JADE после последнего запуска
+    double getMeanF() const { return mu_F; }
+    double getMeanCR() const { return mu_CR; }
+
+protected:
+    Result run() override;
+};
+
+#endif
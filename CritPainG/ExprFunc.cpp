@@ -0,0 +1,684 @@
+﻿#include "pch.h"
+#include "ExprFunc.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#ifndef M_E
+#define M_E 2.71828182845904523536
+#endif
+
+namespace expr {
+
+namespace {
+
+const double INV_TWO_PI = 1.0 / (2.0 * M_PI);
+
+uint64_t bitsOf(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+bool isUnary(Op op) {
+    return op >= Op::Neg;
+}
+
+bool isBinary(Op op) {
+    return op >= Op::Add && op <= Op::Pow;
+}
+
+double apply(Op op, double a, double b) {
+    switch (op) {
+    case Op::Add: return a + b;
+    case Op::Sub: return a - b;
+    case Op::Mul: return a * b;
+    case Op::Div: return a / b;
+    case Op::Pow: return std::pow(a, b);
+    case Op::Neg: return -a;
+    case Op::Sin: return std::sin(a);
+    case Op::Cos: return std::cos(a);
+    case Op::Tan: return std::tan(a);
+    case Op::Exp: return std::exp(a);
+    case Op::Log: return std::log(a);
+    case Op::Sqrt: return std::sqrt(a);
+    case Op::Abs: return std::fabs(a);
+    case Op::Atan: return std::atan(a);
+    case Op::Tanh: return std::tanh(a);
+    case Op::Sign: return static_cast<double>((a > 0.0) - (a < 0.0));
+    default: return 0.0;
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Graph
+// ---------------------------------------------------------------------------
+
+size_t Graph::KeyHash::operator()(const Key& k) const {
+    uint64_t h = static_cast<uint64_t>(k.op);
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(static_cast<uint32_t>(k.a));
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(static_cast<uint32_t>(k.b));
+    h = h * 0x9E3779B97F4A7C15ull + k.bits;
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+int Graph::insert(const Node& n, uint64_t bits) {
+    Key key = { n.op, n.a, n.b, bits };
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        return it->second;
+    }
+    const int id = static_cast<int>(nodes.size());
+    nodes.push_back(n);
+    lookup.emplace(key, id);
+    return id;
+}
+
+bool Graph::isConstant(int id, double v) const {
+    return nodes[id].op == Op::Const && nodes[id].value == v;
+}
+
+int Graph::constant(double v) {
+    // -0.0 и 0.0 различаются по битам и остаются разными узлами
+    Node n = { Op::Const, -1, -1, -1, v };
+    return insert(n, bitsOf(v));
+}
+
+int Graph::variable(int index) {
+    Node n = { Op::Var, -1, -1, index, 0.0 };
+    return insert(n, static_cast<uint64_t>(index));
+}
+
+int Graph::unary(Op op, int a) {
+    const Node& na = nodes[a];
+    if (na.op == Op::Const) {
+        return constant(apply(op, na.value, 0.0));
+    }
+    if (op == Op::Neg && na.op == Op::Neg) {
+        return na.a;
+    }
+    Node n = { op, a, -1, -1, 0.0 };
+    return insert(n, 0);
+}
+
+int Graph::binary(Op op, int a, int b) {
+    if (nodes[a].op == Op::Const && nodes[b].op == Op::Const) {
+        return constant(apply(op, nodes[a].value, nodes[b].value));
+    }
+
+    switch (op) {
+    case Op::Add:
+        if (isConstant(a, 0.0)) return b;
+        if (isConstant(b, 0.0)) return a;
+        if (nodes[b].op == Op::Neg) return binary(Op::Sub, a, nodes[b].a);
+        if (a == b) return binary(Op::Mul, constant(2.0), a);
+        break;
+    case Op::Sub:
+        if (isConstant(b, 0.0)) return a;
+        if (isConstant(a, 0.0)) return unary(Op::Neg, b);
+        if (a == b) return constant(0.0);
+        if (nodes[b].op == Op::Neg) return binary(Op::Add, a, nodes[b].a);
+        break;
+    case Op::Mul:
+        if (isConstant(a, 0.0) || isConstant(b, 0.0)) return constant(0.0);
+        if (isConstant(a, 1.0)) return b;
+        if (isConstant(b, 1.0)) return a;
+        if (isConstant(a, -1.0)) return unary(Op::Neg, b);
+        if (isConstant(b, -1.0)) return unary(Op::Neg, a);
+        break;
+    case Op::Div:
+        if (isConstant(b, 1.0)) return a;
+        if (isConstant(a, 0.0)) return constant(0.0);
+        break;
+    case Op::Pow:
+        if (isConstant(b, 1.0)) return a;
+        if (isConstant(b, 0.0)) return constant(1.0);
+        if (isConstant(b, 2.0)) return binary(Op::Mul, a, a);
+        if (isConstant(b, 0.5)) return unary(Op::Sqrt, a);
+        break;
+    default:
+        break;
+    }
+
+    // Коммутативные операции приводятся к одному порядку операндов,
+    // чтобы x*y и y*x стали одним узлом
+    if ((op == Op::Add || op == Op::Mul) && a > b) {
+        std::swap(a, b);
+    }
+    Node n = { op, a, b, -1, 0.0 };
+    return insert(n, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Разбор
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class Parser {
+public:
+    Parser(const std::string& s, Graph& g) : text(s), pos(0), graph(g), maxVariable(-1) {}
+
+    int parseAll() {
+        int root = parseExpression();
+        skipSpaces();
+        if (pos != text.size()) {
+            fail("unexpected character '" + std::string(1, text[pos]) + "'");
+        }
+        return root;
+    }
+
+    int variableCount() const { return maxVariable + 1; }
+
+private:
+    const std::string& text;
+    size_t pos;
+    Graph& graph;
+    int maxVariable;
+
+    void fail(const std::string& message) const {
+        throw std::invalid_argument("Expression error at position " + std::to_string(pos + 1) + ": " + message);
+    }
+
+    void skipSpaces() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+    }
+
+    bool accept(char c) {
+        skipSpaces();
+        if (pos < text.size() && text[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!accept(c)) {
+            fail(std::string("expected '") + c + "'");
+        }
+    }
+
+    // expression := term (('+' | '-') term)*
+    int parseExpression() {
+        int left = parseTerm();
+        while (true) {
+            if (accept('+')) left = graph.binary(Op::Add, left, parseTerm());
+            else if (accept('-')) left = graph.binary(Op::Sub, left, parseTerm());
+            else return left;
+        }
+    }
+
+    // term := unary (('*' | '/') unary)*
+    int parseTerm() {
+        int left = parseUnary();
+        while (true) {
+            if (accept('*')) left = graph.binary(Op::Mul, left, parseUnary());
+            else if (accept('/')) left = graph.binary(Op::Div, left, parseUnary());
+            else return left;
+        }
+    }
+
+    // unary := ('-' | '+') unary | power
+    int parseUnary() {
+        if (accept('-')) return graph.unary(Op::Neg, parseUnary());
+        if (accept('+')) return parseUnary();
+        return parsePower();
+    }
+
+    // power := primary ('^' unary)?   (правоассоциативно: 2^-x^2 = 2^(-(x^2)))
+    int parsePower() {
+        int base = parsePrimary();
+        if (accept('^')) {
+            return graph.binary(Op::Pow, base, parseUnary());
+        }
+        return base;
+    }
+
+    int parsePrimary() {
+        skipSpaces();
+        if (pos >= text.size()) {
+            fail("unexpected end of expression");
+        }
+
+        const char c = text[pos];
+        if (c == '(') {
+            ++pos;
+            int inner = parseExpression();
+            expect(')');
+            return inner;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            const char* begin = text.c_str() + pos;
+            char* end = nullptr;
+            double v = std::strtod(begin, &end);
+            if (end == begin) {
+                fail("invalid number");
+            }
+            pos += static_cast<size_t>(end - begin);
+            return graph.constant(v);
+        }
+        if (std::isalpha(static_cast<unsigned char>(c))) {
+            const size_t start = pos;
+            while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_')) ++pos;
+            const std::string name = text.substr(start, pos - start);
+
+            if (accept('(')) {
+                Op op = functionOp(name, start);
+                int arg = parseExpression();
+                expect(')');
+                return graph.unary(op, arg);
+            }
+            if (name == "pi") return graph.constant(M_PI);
+            if (name == "e") return graph.constant(M_E);
+
+            int index = variableIndex(name);
+            if (index < 0) {
+                pos = start;
+                fail("unknown identifier '" + name + "'");
+            }
+            maxVariable = (std::max)(maxVariable, index);
+            return graph.variable(index);
+        }
+
+        fail("unexpected character '" + std::string(1, c) + "'");
+        return -1;
+    }
+
+    Op functionOp(const std::string& name, size_t start) {
+        static const struct { const char* name; Op op; } table[] = {
+            { "sin", Op::Sin }, { "cos", Op::Cos }, { "tan", Op::Tan },
+            { "exp", Op::Exp }, { "log", Op::Log }, { "sqrt", Op::Sqrt },
+            { "abs", Op::Abs }, { "atan", Op::Atan }, { "tanh", Op::Tanh },
+            { "sign", Op::Sign }
+        };
+        for (const auto& f : table) {
+            if (name == f.name) return f.op;
+        }
+        pos = start;
+        fail("unknown function '" + name + "'");
+        return Op::Const;
+    }
+
+    // x, y, z или x1, x2, ... -> индекс с нуля; -1 для неизвестного имени
+    static int variableIndex(const std::string& name) {
+        if (name == "x") return 0;
+        if (name == "y") return 1;
+        if (name == "z") return 2;
+        if (name.size() > 1 && name[0] == 'x') {
+            int index = 0;
+            for (size_t i = 1; i < name.size(); ++i) {
+                if (!std::isdigit(static_cast<unsigned char>(name[i])) || index > 1000000) return -1;
+                index = index * 10 + (name[i] - '0');
+            }
+            return index >= 1 ? index - 1 : -1;
+        }
+        return -1;
+    }
+};
+
+} // namespace
+
+int parse(const std::string& text, Graph& graph, int& dimension) {
+    Parser parser(text, graph);
+    int root = parser.parseAll();
+    dimension = parser.variableCount();
+    return root;
+}
+
+// ---------------------------------------------------------------------------
+// Символьное дифференцирование
+// ---------------------------------------------------------------------------
+
+std::vector<int> differentiate(Graph& graph, int root, int dimension) {
+    // Сопряжённые выражения для исходных узлов; новые узлы появляются в конце графа
+    // и в обратный проход не попадают
+    std::vector<int> adjoint(root + 1, -1);
+    adjoint[root] = graph.constant(1.0);
+
+    auto accumulate = [&](int id, int term) {
+        adjoint[id] = adjoint[id] < 0 ? term : graph.binary(Op::Add, adjoint[id], term);
+    };
+
+    for (int id = root; id >= 0; --id) {
+        const int adj = adjoint[id];
+        if (adj < 0) continue;
+        const Node node = graph.node(id);
+        const int a = node.a;
+        const int b = node.b;
+
+        switch (node.op) {
+        case Op::Add:
+            accumulate(a, adj);
+            accumulate(b, adj);
+            break;
+        case Op::Sub:
+            accumulate(a, adj);
+            accumulate(b, graph.unary(Op::Neg, adj));
+            break;
+        case Op::Mul:
+            accumulate(a, graph.binary(Op::Mul, adj, b));
+            accumulate(b, graph.binary(Op::Mul, adj, a));
+            break;
+        case Op::Div:
+            // d(a/b) = da/b - (a/b) db/b
+            accumulate(a, graph.binary(Op::Div, adj, b));
+            accumulate(b, graph.unary(Op::Neg, graph.binary(Op::Div, graph.binary(Op::Mul, adj, id), b)));
+            break;
+        case Op::Pow: {
+            // d(a^b) = b a^(b-1) da + a^b ln(a) db; при постоянном b второе слагаемое не строится
+            const int exponent = graph.binary(Op::Sub, b, graph.constant(1.0));
+            accumulate(a, graph.binary(Op::Mul, adj, graph.binary(Op::Mul, b, graph.binary(Op::Pow, a, exponent))));
+            if (graph.node(b).op != Op::Const) {
+                accumulate(b, graph.binary(Op::Mul, adj, graph.binary(Op::Mul, id, graph.unary(Op::Log, a))));
+            }
+            break;
+        }
+        case Op::Neg:
+            accumulate(a, graph.unary(Op::Neg, adj));
+            break;
+        case Op::Sin:
+            accumulate(a, graph.binary(Op::Mul, adj, graph.unary(Op::Cos, a)));
+            break;
+        case Op::Cos:
+            accumulate(a, graph.unary(Op::Neg, graph.binary(Op::Mul, adj, graph.unary(Op::Sin, a))));
+            break;
+        case Op::Tan:
+            accumulate(a, graph.binary(Op::Mul, adj, graph.binary(Op::Add, graph.constant(1.0), graph.binary(Op::Mul, id, id))));
+            break;
+        case Op::Exp:
+            accumulate(a, graph.binary(Op::Mul, adj, id));
+            break;
+        case Op::Log:
+            accumulate(a, graph.binary(Op::Div, adj, a));
+            break;
+        case Op::Sqrt:
+            accumulate(a, graph.binary(Op::Div, adj, graph.binary(Op::Mul, graph.constant(2.0), id)));
+            break;
+        case Op::Abs:
+            accumulate(a, graph.binary(Op::Mul, adj, graph.unary(Op::Sign, a)));
+            break;
+        case Op::Atan:
+            accumulate(a, graph.binary(Op::Div, adj, graph.binary(Op::Add, graph.constant(1.0), graph.binary(Op::Mul, a, a))));
+            break;
+        case Op::Tanh:
+            accumulate(a, graph.binary(Op::Mul, adj, graph.binary(Op::Sub, graph.constant(1.0), graph.binary(Op::Mul, id, id))));
+            break;
+        default:
+            // Const, Var и Sign (производная 0) дальше не распространяются
+            break;
+        }
+    }
+
+    std::vector<int> gradient(dimension, -1);
+    for (int id = 0; id <= root; ++id) {
+        const Node& node = graph.node(id);
+        if (node.op == Op::Var && node.index < dimension && adjoint[id] >= 0) {
+            gradient[node.index] = adjoint[id];
+        }
+    }
+    for (int j = 0; j < dimension; ++j) {
+        if (gradient[j] < 0) gradient[j] = graph.constant(0.0);
+    }
+    return gradient;
+}
+
+// ---------------------------------------------------------------------------
+// Program
+// ---------------------------------------------------------------------------
+
+Program::Program(const Graph& graph, const std::vector<int>& outputs, int dim)
+    : dimension(dim), registerCount(0), tempCount(0) {
+
+    const int n = static_cast<int>(graph.size());
+
+    // Живые узлы: достижимые от выходов
+    std::vector<char> live(n, 0);
+    for (int id : outputs) live[id] = 1;
+    for (int id = n - 1; id >= 0; --id) {
+        if (!live[id]) continue;
+        const Node& node = graph.node(id);
+        if (isBinary(node.op) || isUnary(node.op)) live[node.a] = 1;
+        if (isBinary(node.op)) live[node.b] = 1;
+    }
+
+    // Последнее использование каждого узла (выходы живут до конца)
+    std::vector<int> lastUse(n, -1);
+    for (int id = 0; id < n; ++id) {
+        if (!live[id]) continue;
+        const Node& node = graph.node(id);
+        if (isBinary(node.op) || isUnary(node.op)) lastUse[node.a] = id;
+        if (isBinary(node.op)) lastUse[node.b] = id;
+    }
+    for (int id : outputs) lastUse[id] = INT_MAX;
+
+    // Распределение регистров: константы и переменные получают постоянные регистры,
+    // результаты инструкций - временные, освобождаемые после последнего использования.
+    // Операнд освобождается до выбора регистра результата, поэтому результат может
+    // занять регистр операнда (все циклы интерпретатора поэлементные).
+    std::vector<int> regOf(n, -1);
+    std::vector<int> freeTemps;
+    for (int id = 0; id < n; ++id) {
+        if (!live[id]) continue;
+        const Node& node = graph.node(id);
+
+        if (node.op == Op::Const) {
+            regOf[id] = registerCount++;
+            tempSlot.push_back(-1);
+            constants.push_back({ regOf[id], node.value });
+            continue;
+        }
+        if (node.op == Op::Var) {
+            if (node.index >= dimension) {
+                throw std::invalid_argument("Expression uses x" + std::to_string(node.index + 1) +
+                    " but function dimension is " + std::to_string(dimension));
+            }
+            regOf[id] = registerCount++;
+            tempSlot.push_back(-1);
+            variables.push_back({ regOf[id], node.index });
+            continue;
+        }
+
+        const int operands[2] = { node.a, isBinary(node.op) ? node.b : -1 };
+        for (int k = 0; k < 2; ++k) {
+            const int operand = operands[k];
+            if (operand < 0 || (k == 1 && operand == operands[0])) continue;
+            if (lastUse[operand] == id && tempSlot[regOf[operand]] >= 0) {
+                freeTemps.push_back(regOf[operand]);
+            }
+        }
+
+        int dst;
+        if (!freeTemps.empty()) {
+            dst = freeTemps.back();
+            freeTemps.pop_back();
+        }
+        else {
+            dst = registerCount++;
+            tempSlot.push_back(tempCount++);
+        }
+        regOf[id] = dst;
+        code.push_back({ node.op, dst, regOf[node.a], isBinary(node.op) ? regOf[node.b] : -1 });
+    }
+
+    for (int id : outputs) outputRegs.push_back(regOf[id]);
+}
+
+void Program::run(const double* x, double* out) const {
+    static thread_local std::vector<double> regs;
+    regs.resize(registerCount);
+
+    for (const ConstReg& c : constants) regs[c.reg] = c.value;
+    for (const VarReg& v : variables) regs[v.reg] = x[v.index];
+    for (const Instr& in : code) {
+        regs[in.dst] = apply(in.op, regs[in.a], in.b >= 0 ? regs[in.b] : 0.0);
+    }
+    for (size_t k = 0; k < outputRegs.size(); ++k) out[k] = regs[outputRegs[k]];
+}
+
+void Program::runBatch(const double* points, size_t count, double* const* outputs) const {
+    // Буферы: временные регистры, константы, три рабочих для sin/cos
+    const size_t constCount = constants.size();
+    static thread_local std::vector<double> storage;
+    static thread_local std::vector<const double*> source;
+    storage.resize((tempCount + constCount + 3) * BLOCK);
+    source.resize(registerCount);
+
+    double* temps = storage.data();
+    double* consts = temps + tempCount * BLOCK;
+    double* arg = consts + constCount * BLOCK;
+    double* sinBuf = arg + BLOCK;
+    double* cosBuf = sinBuf + BLOCK;
+
+    for (size_t k = 0; k < constCount; ++k) {
+        std::fill(consts + k * BLOCK, consts + (k + 1) * BLOCK, constants[k].value);
+        source[constants[k].reg] = consts + k * BLOCK;
+    }
+    for (int r = 0; r < registerCount; ++r) {
+        if (tempSlot[r] >= 0) source[r] = temps + tempSlot[r] * BLOCK;
+    }
+
+    for (size_t start = 0; start < count; start += BLOCK) {
+        const size_t n = (std::min)(BLOCK, count - start);
+        for (const VarReg& v : variables) {
+            source[v.reg] = points + static_cast<size_t>(v.index) * count + start;
+        }
+
+        for (const Instr& in : code) {
+            double* d = temps + tempSlot[in.dst] * BLOCK;
+            const double* a = source[in.a];
+            const double* b = in.b >= 0 ? source[in.b] : nullptr;
+
+            switch (in.op) {
+            case Op::Add: for (size_t i = 0; i < n; ++i) d[i] = a[i] + b[i]; break;
+            case Op::Sub: for (size_t i = 0; i < n; ++i) d[i] = a[i] - b[i]; break;
+            case Op::Mul: for (size_t i = 0; i < n; ++i) d[i] = a[i] * b[i]; break;
+            case Op::Div: for (size_t i = 0; i < n; ++i) d[i] = a[i] / b[i]; break;
+            case Op::Pow: for (size_t i = 0; i < n; ++i) d[i] = std::pow(a[i], b[i]); break;
+            case Op::Neg: for (size_t i = 0; i < n; ++i) d[i] = -a[i]; break;
+            case Op::Sqrt: for (size_t i = 0; i < n; ++i) d[i] = std::sqrt(a[i]); break;
+            case Op::Abs: for (size_t i = 0; i < n; ++i) d[i] = std::fabs(a[i]); break;
+            case Op::Sin:
+            case Op::Cos:
+                // sin(a) = sin(2pi * a/(2pi)) через векторный sincos2pi
+                for (size_t i = 0; i < n; ++i) arg[i] = a[i] * INV_TWO_PI;
+                if (in.op == Op::Sin) simd::sincos2pi(arg, n, d, cosBuf);
+                else simd::sincos2pi(arg, n, sinBuf, d);
+                break;
+            default:
+                for (size_t i = 0; i < n; ++i) d[i] = apply(in.op, a[i], 0.0);
+                break;
+            }
+        }
+
+        for (size_t k = 0; k < outputRegs.size(); ++k) {
+            const double* r = source[outputRegs[k]];
+            std::copy(r, r + n, outputs[k] + start);
+        }
+    }
+}
+
+} // namespace expr
+
+// ---------------------------------------------------------------------------
+// ExprFunc
+// ---------------------------------------------------------------------------
+
+ExprFunc::ExprFunc(const std::string& text, int dim)
+    : formula(text), dimension(dim), root(-1) {
+    int used = 0;
+    root = expr::parse(formula, graph, used);
+    if (dimension <= 0) {
+        dimension = (std::max)(used, 1);
+    }
+    valueProgram = expr::Program(graph, { root }, dimension);
+
+    gradientRoots = expr::differentiate(graph, root, dimension);
+    std::vector<int> outputs;
+    outputs.reserve(dimension + 1);
+    outputs.push_back(root);
+    outputs.insert(outputs.end(), gradientRoots.begin(), gradientRoots.end());
+    gradientProgram = expr::Program(graph, outputs, dimension);
+
+    // Переменные dimension..2*dimension-1 - компоненты направления v
+    int directional = graph.constant(0.0);
+    for (int j = 0; j < dimension; ++j) {
+        directional = graph.binary(expr::Op::Add, directional,
+            graph.binary(expr::Op::Mul, gradientRoots[j], graph.variable(dimension + j)));
+    }
+    hessianProgram = expr::Program(graph, expr::differentiate(graph, directional, dimension), 2 * dimension);
+}
+
+double ExprFunc::operator()(const std::vector<double>& x) const {
+    if (static_cast<int>(x.size()) != dimension) {
+        throw std::invalid_argument("ExprFunc requires exactly " + std::to_string(dimension) + " dimensions");
+    }
+    double value;
+    valueProgram.run(x.data(), &value);
+    return value;
+}
+
+std::vector<double> ExprFunc::getGradient(const std::vector<double>& x) const {
+    std::vector<double> grad;
+    valueAndGradient(x, grad);
+    return grad;
+}
+
+double ExprFunc::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    if (static_cast<int>(x.size()) != dimension) {
+        throw std::invalid_argument("ExprFunc requires exactly " + std::to_string(dimension) + " dimensions");
+    }
+    static thread_local std::vector<double> out;
+    out.resize(dimension + 1);
+    gradientProgram.run(x.data(), out.data());
+    grad.assign(out.begin() + 1, out.end());
+    return out[0];
+}
+
+std::string ExprFunc::getName() const {
+    return "Expression: f = " + formula;
+}
+
+int ExprFunc::getDimension() const {
+    return dimension;
+}
+
+void ExprFunc::evaluateBatch(const double* points, size_t count, double* values) const {
+    double* outputs[1] = { values };
+    valueProgram.runBatch(points, count, outputs);
+}
+
+void ExprFunc::gradientBatch(const double* points, size_t count, double* grads) const {
+    // Значение - нулевой выход той же программы, его буфер отбрасывается
+    std::vector<double> values(count);
+    std::vector<double*> outputs(dimension + 1);
+    outputs[0] = values.data();
+    for (int j = 0; j < dimension; ++j) {
+        outputs[j + 1] = grads + static_cast<size_t>(j) * count;
+    }
+    gradientProgram.runBatch(points, count, outputs.data());
+}
+
+std::vector<double> ExprFunc::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    if (static_cast<int>(x.size()) != dimension || static_cast<int>(v.size()) != dimension) {
+        throw std::invalid_argument("ExprFunc requires exactly " + std::to_string(dimension) + " dimensions");
+    }
+    static thread_local std::vector<double> input;
+    input.resize(2 * dimension);
+    std::copy(x.begin(), x.end(), input.begin());
+    std::copy(v.begin(), v.end(), input.begin() + dimension);
+    std::vector<double> hv(dimension);
+    hessianProgram.run(input.data(), hv.data());
+    return hv;
+}
@@ -0,0 +1,161 @@
+﻿#ifndef EXPRFUNC_H
+#define EXPRFUNC_H
+
+#include "AbstrFunc.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Целевая функция, заданная строкой, например "(x-3)^2 + sin(y)*y".
+//
+// Строка разбирается один раз в граф выражения (expr::Graph). При построении
+// граф сворачивает константы, упрощает тождества (x*1, x+0, x^2 -> x*x) и
+// объединяет одинаковые подвыражения: каждый узел хранится один раз. Затем граф
+// компилируется в регистровый байткод (expr::Program), интерпретатор которого
+// выполняет каждую инструкцию сразу над блоком точек пакета, так что разбор
+// инструкции приходится на блок, а не на точку.
+//
+// Переменные: x, y, z или x1, x2, ... (x == x1, y == x2, z == x3).
+// Операции: + - * / ^, унарный минус, скобки.
+// Функции: sin cos tan exp log sqrt abs sign atan tanh. Константы: pi, e.
+//
+// Градиент строится символьно (expr::differentiate) в том же графе, поэтому
+// общие с функцией подвыражения (например, cos(2*pi*x)) вычисляются один раз,
+// и компилируется в одну программу вместе со значением. Произведение гессиана
+// на вектор - градиент по x выражения sum_j df/dx_j * v_j, где v_j - ещё n
+// переменных графа.
+namespace expr {
+
+enum class Op : unsigned char {
+    Const, Var,
+    Add, Sub, Mul, Div, Pow,
+    Neg, Sin, Cos, Tan, Exp, Log, Sqrt, Abs, Atan, Tanh, Sign
+};
+
+// Узел графа; для Const значение в value, для Var индекс переменной в index
+struct Node {
+    Op op;
+    int a;
+    int b;
+    int index;
+    double value;
+};
+
+// Граф выражения с хэш-консингом: одинаковые узлы не создаются повторно.
+// Дочерние узлы всегда имеют меньший номер, чем родитель.
+class Graph {
+public:
+    int constant(double v);
+    int variable(int index);
+    int unary(Op op, int a);
+    int binary(Op op, int a, int b);
+
+    const Node& node(int id) const { return nodes[id]; }
+    size_t size() const { return nodes.size(); }
+    bool isConstant(int id, double v) const;
+
+private:
+    struct Key {
+        Op op;
+        int a;
+        int b;
+        uint64_t bits;
+        bool operator==(const Key& o) const { return op == o.op && a == o.a && b == o.b && bits == o.bits; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+
+    std::vector<Node> nodes;
+    std::unordered_map<Key, int, KeyHash> lookup;
+
+    int insert(const Node& n, uint64_t bits);
+};
+
+// Разбор строки в граф. Возвращает корень; в dimension - число переменных
+// (наибольший индекс + 1). Ошибки - std::invalid_argument с позицией в строке.
+int parse(const std::string& text, Graph& graph, int& dimension);
+
+// Символьный градиент обратным проходом по графу: сопряжённые выражения
+// накапливаются от корня к листьям и добавляются в тот же граф (с упрощением и
+// объединением подвыражений). Возвращает узлы df/dx_j для j = 0..dimension-1.
+std::vector<int> differentiate(Graph& graph, int root, int dimension);
+
+// Регистровый байткод для набора выходов графа
+class Program {
+public:
+    // Число точек, обрабатываемых одной инструкцией
+    static const size_t BLOCK = 256;
+
+    Program() : dimension(0), registerCount(0), tempCount(0) {}
+    Program(const Graph& graph, const std::vector<int>& outputs, int dimension);
+
+    // Одна точка: x[0..dimension), out[0..outputCount)
+    void run(const double* x, double* out) const;
+    // Пакет SoA: k-й выход i-й точки записывается в outputs[k][i]
+    void runBatch(const double* points, size_t count, double* const* outputs) const;
+
+    size_t instructionCount() const { return code.size(); }
+    int registers() const { return registerCount; }
+    size_t outputCount() const { return outputRegs.size(); }
+
+private:
+    struct Instr {
+        Op op;
+        int dst;
+        int a;
+        int b;
+    };
+    struct ConstReg {
+        int reg;
+        double value;
+    };
+    struct VarReg {
+        int reg;
+        int index;
+    };
+
+    int dimension;
+    int registerCount;
+    int tempCount;                   // регистры под результаты инструкций
+    std::vector<Instr> code;
+    std::vector<ConstReg> constants;
+    std::vector<VarReg> variables;
+    std::vector<int> tempSlot;       // номер временного буфера для регистра или -1
+    std::vector<int> outputRegs;
+};
+
+} // namespace expr
+
+class ExprFunc : public AbstrFunc {
+private:
+    std::string formula;
+    int dimension;
+    expr::Graph graph;
+    int root;
+    std::vector<int> gradientRoots;
+    expr::Program valueProgram;
+    expr::Program gradientProgram;   // выходы: f, df/dx_0, ..., df/dx_{n-1}
+    expr::Program hessianProgram;    // входы: x, v; выходы: (H v)_0, ..., (H v)_{n-1}
+
+public:
+    // dim == 0: размерность определяется по переменным формулы
+    explicit ExprFunc(const std::string& text, int dim = 0);
+
+    double operator()(const std::vector<double>& x) const override;
+    std::vector<double> getGradient(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    int getDimension() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+
+    const std::string& getFormula() const { return formula; }
+    const expr::Program& program() const { return valueProgram; }
+    const expr::Program& gradientProgramCode() const { return gradientProgram; }
+};
+
+#endif
@@ -0,0 +1,127 @@
+﻿#include "pch.h"
+#include "FiniteDifference.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Наименьшая часть пакета, отдаваемая одному потоку
+const size_t PARALLEL_GRAIN = 8;
+
+// Набор точек схемы: для Central точки 2j и 2j+1 - x + h_j e_j и x - h_j e_j,
+// для Forward точка j - x + h_j e_j; при withCenter последняя точка - сам x.
+void evaluateStencil(const AbstrFunc& f, const std::vector<double>& x, const std::vector<double>& steps,
+    bool withCenter, const FiniteDifferenceOptions& options, std::vector<double>& values) {
+    const size_t dim = x.size();
+    const bool central = options.scheme == DifferenceScheme::Central;
+    const size_t perturbed = central ? 2 * dim : dim;
+    const size_t total = perturbed + (withCenter ? 1 : 0);
+    values.resize(total);
+
+    auto evaluateRange = [&](size_t begin, size_t end) {
+        NumericalGradientScope scope;
+        const size_t m = end - begin;
+        std::vector<double> points(dim * m);
+        for (size_t j = 0; j < dim; ++j) {
+            std::fill(points.begin() + j * m, points.begin() + (j + 1) * m, x[j]);
+        }
+        for (size_t k = begin; k < end && k < perturbed; ++k) {
+            const size_t j = central ? k / 2 : k;
+            const bool minus = central && (k & 1) != 0;
+            points[j * m + (k - begin)] = minus ? x[j] - steps[j] : x[j] + steps[j];
+        }
+        f.evaluateBatch(points.data(), m, values.data() + begin);
+    };
+
+    if (options.parallel && total >= options.minParallelPoints && !f.prefersWholeBatch()) {
+        ThreadPool::shared().parallelFor(total, PARALLEL_GRAIN, evaluateRange);
+    }
+    else {
+        evaluateRange(0, total);
+    }
+}
+
+std::vector<double> gradientFromStencil(const std::vector<double>& x, const std::vector<double>& steps,
+    const std::vector<double>& values, double fx, DifferenceScheme scheme) {
+    std::vector<double> grad(x.size());
+    for (size_t j = 0; j < x.size(); ++j) {
+        if (scheme == DifferenceScheme::Central) {
+            // Знаменатель по фактическим точкам: x - h может округлиться иначе, чем x + h
+            const double width = (x[j] + steps[j]) - (x[j] - steps[j]);
+            grad[j] = (values[2 * j] - values[2 * j + 1]) / width;
+        }
+        else {
+            grad[j] = (values[j] - fx) / steps[j];
+        }
+    }
+    return grad;
+}
+
+} // namespace
+
+std::vector<double> finiteDifferenceSteps(const std::vector<double>& x, DifferenceScheme scheme, double step) {
+    if (step <= 0.0) {
+        const double eps = std::numeric_limits<double>::epsilon();
+        step = scheme == DifferenceScheme::Forward ? std::sqrt(eps) : std::cbrt(eps);
+    }
+    std::vector<double> steps(x.size());
+    for (size_t j = 0; j < x.size(); ++j) {
+        const double h = step * (std::max)(std::fabs(x[j]), 1.0);
+        const double shifted = x[j] + h;
+        steps[j] = shifted - x[j];
+    }
+    return steps;
+}
+
+std::vector<double> finiteDifferenceGradient(const AbstrFunc& f, const std::vector<double>& x,
+    const FiniteDifferenceOptions& options) {
+    if (options.scheme == DifferenceScheme::Forward) {
+        std::vector<double> grad;
+        finiteDifferenceValueAndGradient(f, x, grad, options);
+        return grad;
+    }
+    const std::vector<double> steps = finiteDifferenceSteps(x, options.scheme, options.step);
+    std::vector<double> values;
+    evaluateStencil(f, x, steps, false, options, values);
+    return gradientFromStencil(x, steps, values, 0.0, options.scheme);
+}
+
+std::vector<double> finiteDifferenceGradient(const AbstrFunc& f, const std::vector<double>& x, double fx,
+    const FiniteDifferenceOptions& options) {
+    const std::vector<double> steps = finiteDifferenceSteps(x, options.scheme, options.step);
+    std::vector<double> values;
+    evaluateStencil(f, x, steps, false, options, values);
+    return gradientFromStencil(x, steps, values, fx, options.scheme);
+}
+
+double finiteDifferenceValueAndGradient(const AbstrFunc& f, const std::vector<double>& x, std::vector<double>& grad,
+    const FiniteDifferenceOptions& options) {
+    const std::vector<double> steps = finiteDifferenceSteps(x, options.scheme, options.step);
+    std::vector<double> values;
+    evaluateStencil(f, x, steps, true, options, values);
+    const double fx = values.back();
+    grad = gradientFromStencil(x, steps, values, fx, options.scheme);
+    return fx;
+}
+
+double evaluateWithGradient(const AbstrFunc& f, const std::vector<double>& x, std::vector<double>& grad,
+    const FiniteDifferenceOptions& options) {
+    try {
+        return f.valueAndGradient(x, grad);
+    }
+    catch (...) {
+        return finiteDifferenceValueAndGradient(f, x, grad, options);
+    }
+}
+
+std::vector<double> gradientWithKnownValue(const AbstrFunc& f, const std::vector<double>& x, double fx,
+    const FiniteDifferenceOptions& options) {
+    try {
+        return f.getGradient(x);
+    }
+    catch (...) {
+        return finiteDifferenceGradient(f, x, fx, options);
+    }
+}
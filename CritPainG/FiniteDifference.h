@@ -0,0 +1,54 @@
+﻿#ifndef FINITEDIFFERENCE_H
+#define FINITEDIFFERENCE_H
+
+#include "AbstrFunc.h"
+#include <cstddef>
+#include <vector>
+
+// Численный градиент для функций без аналитического градиента.
+//
+// Все смещённые точки собираются в пакеты SoA и вычисляются через
+// AbstrFunc::evaluateBatch; при достаточном числе точек пакет делится на части,
+// которые считаются параллельно в ThreadPool::shared(). Функция должна допускать
+// одновременные вызовы из нескольких потоков (все встроенные функции допускают).
+// Функции с prefersWholeBatch() (ProcessFunc) получают все точки одним пакетом.
+//
+// Шаг выбирается для каждой координаты: h_j = step * max(|x_j|, 1) и
+// округляется так, что (x_j + h_j) - x_j == h_j точно.
+enum class DifferenceScheme {
+    Forward,  // (f(x + h e_j) - f(x)) / h: N вычислений при известном f(x), ошибка O(h)
+    Central   // (f(x + h e_j) - f(x - h e_j)) / 2h: 2N вычислений, ошибка O(h^2)
+};
+
+struct FiniteDifferenceOptions {
+    DifferenceScheme scheme = DifferenceScheme::Central;
+    double step = 0.0;               // относительный шаг; 0 - sqrt(eps) для Forward, cbrt(eps) для Central
+    bool parallel = true;
+    size_t minParallelPoints = 64;   // меньшие наборы точек считаются в вызывающем потоке
+};
+
+// Шаги по координатам для точки x
+std::vector<double> finiteDifferenceSteps(const std::vector<double>& x, DifferenceScheme scheme, double step = 0.0);
+
+// Градиент в x; для Forward f(x) вычисляется в том же пакете (N + 1 точка)
+std::vector<double> finiteDifferenceGradient(const AbstrFunc& f, const std::vector<double>& x,
+    const FiniteDifferenceOptions& options = FiniteDifferenceOptions());
+
+// Градиент при уже известном fx = f(x): для Forward ровно N вычислений
+std::vector<double> finiteDifferenceGradient(const AbstrFunc& f, const std::vector<double>& x, double fx,
+    const FiniteDifferenceOptions& options = FiniteDifferenceOptions());
+
+// Значение и градиент одним пакетом: N + 1 точка для Forward, 2N + 1 для Central
+double finiteDifferenceValueAndGradient(const AbstrFunc& f, const std::vector<double>& x, std::vector<double>& grad,
+    const FiniteDifferenceOptions& options = FiniteDifferenceOptions());
+
+// Значение и градиент: аналитический, если функция его даёт (valueAndGradient
+// не бросает исключение), иначе численный тем же пакетом
+double evaluateWithGradient(const AbstrFunc& f, const std::vector<double>& x, std::vector<double>& grad,
+    const FiniteDifferenceOptions& options = FiniteDifferenceOptions());
+
+// Градиент в точке с уже известным значением fx: аналитический или численный
+std::vector<double> gradientWithKnownValue(const AbstrFunc& f, const std::vector<double>& x, double fx,
+    const FiniteDifferenceOptions& options = FiniteDifferenceOptions());
+
+#endif
@@ -0,0 +1,405 @@
+﻿#ifndef FIXEDOPTIM_H
+#define FIXEDOPTIM_H
+
+#include "AbstrOptim.h"
+#include "ForwardAD.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+// Оптимизаторы с размерностью, известной на этапе компиляции.
+//
+// Точка хранится в FixedPoint<N> (std::array) на стеке, функция вызывается
+// напрямую через невиртуальный шаблон Func::evaluate<T>(const T* x), а градиент
+// берётся одним проходом Dual<N>. В рабочем цикле нет выделений памяти кроме
+// записи траектории. Func - любой класс с таким шаблоном: QuadraticFunc2D,
+// SphereFunc2D, RastriginFunc2D, SphereFunc3D, FunctionFromTemplate<F>.
+//
+// Алгоритмы повторяют RandomSearchOptim и ConjugateGradientFRConstrained.
+
+template <int N>
+using FixedPoint = std::array<double, N>;
+
+template <int N>
+inline std::vector<double> toVector(const FixedPoint<N>& x) {
+    return std::vector<double>(x.begin(), x.end());
+}
+
+template <int N>
+inline FixedPoint<N> toFixedPoint(const std::vector<double>& x) {
+    if (x.size() != static_cast<size_t>(N)) {
+        throw std::invalid_argument("Point dimension does not match FixedPoint size.");
+    }
+    FixedPoint<N> p;
+    std::copy(x.begin(), x.end(), p.begin());
+    return p;
+}
+
+// Значение и точный градиент за один проход прямого дифференцирования
+template <int N, class Func>
+inline double fixedValueAndGradient(const Func& f, const FixedPoint<N>& x, FixedPoint<N>& grad) {
+    Dual<N> args[N];
+    for (int j = 0; j < N; ++j) {
+        args[j] = Dual<N>(x[j]);
+        args[j].d[j] = 1.0;
+    }
+    Dual<N> r = f.evaluate(args);
+    for (int j = 0; j < N; ++j) {
+        grad[j] = r.d[j];
+    }
+    return r.v;
+}
+
+template <int N, class Func>
+class RandomSearchOptimFixed : public AbstrOptim {
+private:
+    const Func* typedFunc;
+    FixedPoint<N> lower_bounds;
+    FixedPoint<N> upper_bounds;
+    double delta;
+    std::mt19937 gen;
+    double p;
+    double alpha;
+
+public:
+    RandomSearchOptimFixed(const Func* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, const std::vector<double>& lb,
+        const std::vector<double>& ub, double d, unsigned int seed = std::random_device{}(),
+        double p_value = 0.2, double alpha_value = 0.8)
+        : AbstrOptim(f, std::move(c), x0), typedFunc(f),
+        lower_bounds(toFixedPoint<N>(lb)), upper_bounds(toFixedPoint<N>(ub)),
+        delta(d), gen(seed), p(p_value), alpha(alpha_value) {
+
+        if (f->getDimension() != N) {
+            throw std::invalid_argument("Function dimension does not match FixedPoint size.");
+        }
+        const FixedPoint<N> start = toFixedPoint<N>(x0);
+        for (int i = 0; i < N; ++i) {
+            if (lower_bounds[i] > upper_bounds[i]) {
+                throw std::invalid_argument("Lower bound must be <= upper bound.");
+            }
+            if (start[i] < lower_bounds[i] || start[i] > upper_bounds[i]) {
+                throw std::invalid_argument("Initial point must be inside the box D.");
+            }
+        }
+        if (delta <= 0) {
+            throw std::invalid_argument("Delta must be positive.");
+        }
+        if (p_value <= 0.0 || p_value >= 1.0) {
+            throw std::invalid_argument("P must be in range (0, 1).");
+        }
+        if (alpha_value <= 0.0 || alpha_value >= 1.0) {
+            throw std::invalid_argument("Alpha must be in range (0, 1).");
+        }
+    }
+
+protected:
+    Result run() override {
+        trajectory.clear();
+
+        FixedPoint<N> current_point = toFixedPoint<N>(initialPoint);
+        // typedFunc вызывается в обход counter, поэтому вычисления учитываются вручную
+        double current_value = typedFunc->evaluate(current_point.data());
+        counter.record(1, 0);
+        int iteration = 0;
+        addPointToTrajectory(initialPoint);
+
+        FixedPoint<N> best_point = current_point;
+        double best_value = current_value;
+
+        // Критерию нужен std::vector: держим один буфер и копируем в него
+        std::vector<double> current_vec = initialPoint;
+
+        double max_possible_delta = 0.0;
+        for (int i = 0; i < N; ++i) {
+            max_possible_delta = (std::max)(max_possible_delta, upper_bounds[i] - lower_bounds[i]);
+        }
+
+        const int max_fallback_iterations = MaxI;
+        double current_delta = delta;
+
+        std::uniform_real_distribution<double> prob_dis(0.0, 1.0);
+        std::uniform_real_distribution<double> global_dis(0.0, 1.0);
+        std::uniform_real_distribution<double> coord_dis;
+        const int max_no_improvement = 50;
+        int no_improvement_count = 0;
+
+        while (!criterial->isSatisfied(current_vec, current_value, iteration)) {
+            if (iteration >= max_fallback_iterations) {
+                return { toVector<N>(best_point), best_value, iteration,
+                         "Fallback: reached maximum iterations", trajectory };
+            }
+
+            FixedPoint<N> candidate_point;
+            bool is_local_search = (prob_dis(gen) < p);
+
+            if (is_local_search) {
+                coord_dis.param(std::uniform_real_distribution<double>::param_type(
+                    -current_delta, current_delta));
+                for (int i = 0; i < N; ++i) {
+                    double candidate = current_point[i] + coord_dis(gen);
+                    candidate_point[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], candidate));
+                }
+            }
+            else {
+                for (int i = 0; i < N; ++i) {
+                    candidate_point[i] = lower_bounds[i] +
+                        global_dis(gen) * (upper_bounds[i] - lower_bounds[i]);
+                }
+            }
+
+            double candidate_value = typedFunc->evaluate(candidate_point.data());
+            counter.record(1, 0);
+
+            if (candidate_value < current_value) {
+                current_point = candidate_point;
+                current_value = candidate_value;
+                std::copy(current_point.begin(), current_point.end(), current_vec.begin());
+
+                no_improvement_count = 0;
+                addPointToTrajectory(current_vec);
+                if (is_local_search) {
+                    current_delta *= alpha;
+                }
+
+                if (candidate_value < best_value) {
+                    best_point = candidate_point;
+                    best_value = candidate_value;
+                }
+            }
+            else {
+                no_improvement_count++;
+
+                if (no_improvement_count >= max_no_improvement) {
+                    current_delta /= alpha;
+                    if (current_delta > max_possible_delta) {
+                        current_delta = max_possible_delta;
+                    }
+                    no_improvement_count = 0;
+                }
+            }
+
+            iteration++;
+        }
+
+        return { toVector<N>(best_point), best_value, iteration, "Criterial satisfied", trajectory };
+    }
+};
+
+template <int N, class Func>
+class ConjugateGradientFRConstrainedFixed : public AbstrOptim {
+private:
+    const Func* typedFunc;
+    FixedPoint<N> lower_bounds;
+    FixedPoint<N> upper_bounds;
+    double grad_epsilon;
+
+    FixedPoint<N> projectToBounds(const FixedPoint<N>& x) const {
+        FixedPoint<N> projected;
+        for (int i = 0; i < N; ++i) {
+            projected[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], x[i]));
+        }
+        return projected;
+    }
+
+    // Шаг x + alpha * p с проекцией на границы
+    FixedPoint<N> step(const FixedPoint<N>& x, const FixedPoint<N>& p, double alpha) const {
+        FixedPoint<N> next;
+        for (int i = 0; i < N; ++i) {
+            next[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], x[i] + alpha * p[i]));
+        }
+        return next;
+    }
+
+    // phi(alpha) = f(P(x + alpha p)) на стеке; производная - по ломаной, как в
+    // VectorLineFunction. typedFunc вызывается в обход counter
+    class FixedLineFunction : public LineFunction {
+    public:
+        const ConjugateGradientFRConstrainedFixed& owner;
+        const FixedPoint<N>& x;
+        const FixedPoint<N>& p;
+        FixedPoint<N> point;
+        FixedPoint<N> gradient;
+        FixedPoint<N> savedPoint;
+        FixedPoint<N> savedGradient;
+
+        FixedLineFunction(const ConjugateGradientFRConstrainedFixed& o, const FixedPoint<N>& x0, const FixedPoint<N>& dir)
+            : owner(o), x(x0), p(dir), point(x0), gradient(), savedPoint(x0), savedGradient() {}
+
+        bool blocked(int i, double alpha) const {
+            const double moved = x[i] + alpha * p[i];
+            return p[i] > 0.0 ? moved >= owner.upper_bounds[i] : moved <= owner.lower_bounds[i];
+        }
+
+        double slope(double alpha, const FixedPoint<N>& g) const {
+            double sum = 0.0;
+            for (int i = 0; i < N; ++i) {
+                if (!blocked(i, alpha)) sum += g[i] * p[i];
+            }
+            return sum;
+        }
+
+        double value(double alpha) override {
+            point = owner.step(x, p, alpha);
+            owner.counter.record(1, 0);
+            return owner.typedFunc->evaluate(point.data());
+        }
+
+        double valueAndSlope(double alpha, double& d) override {
+            point = owner.step(x, p, alpha);
+            owner.counter.record(1, 1);
+            const double fx = fixedValueAndGradient<N>(*owner.typedFunc, point, gradient);
+            d = slope(alpha, gradient);
+            return fx;
+        }
+
+        void completeGradient(double) override {
+            owner.counter.record(0, 1);
+            fixedValueAndGradient<N>(*owner.typedFunc, point, gradient);
+        }
+
+        void save() override {
+            savedPoint = point;
+            savedGradient = gradient;
+        }
+
+        void restore() override {
+            point = savedPoint;
+            gradient = savedGradient;
+        }
+    };
+
+public:
+    ConjugateGradientFRConstrainedFixed(const Func* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, const std::vector<double>& lb,
+        const std::vector<double>& ub, double grad_eps = 1e-8)
+        : AbstrOptim(f, std::move(c), x0), typedFunc(f),
+        lower_bounds(toFixedPoint<N>(lb)), upper_bounds(toFixedPoint<N>(ub)),
+        grad_epsilon(grad_eps) {
+
+        if (f->getDimension() != N) {
+            throw std::invalid_argument("Function dimension does not match FixedPoint size.");
+        }
+        toFixedPoint<N>(x0);
+        for (int i = 0; i < N; ++i) {
+            if (lower_bounds[i] > upper_bounds[i]) {
+                throw std::invalid_argument("Lower bound must be <= upper bound.");
+            }
+        }
+    }
+
+protected:
+    Result run() override {
+        trajectory.clear();
+
+        FixedPoint<N> x = projectToBounds(toFixedPoint<N>(initialPoint));
+        std::vector<double> x_vec = toVector<N>(x);
+        int iteration = 0;
+        addPointToTrajectory(x_vec);
+
+        FixedPoint<N> grad;
+        // typedFunc вызывается в обход counter, поэтому вычисления учитываются вручную
+        double f_val = fixedValueAndGradient<N>(*typedFunc, x, grad);
+        counter.record(1, 1);
+        FixedPoint<N> p;
+        for (int i = 0; i < N; ++i) p[i] = -grad[i];
+
+        bool steepest = true;
+
+        FixedPoint<N> best_x = x;
+        double best_f_val = f_val;
+
+        // Шаг - сильные условия Вулфа, как у ConjugateGradientFRConstrained
+        const StrongWolfeLineSearch lineSearch(1e-4, 0.1, 100, 1e-6);
+        double prev_step = 1.0, prev_slope = 0.0;
+
+        const int max_fallback_iterations = MaxI;
+
+        while (!criterial->isSatisfied(x_vec, f_val, iteration)) {
+            if (iteration >= max_fallback_iterations) {
+                addPointToTrajectory(toVector<N>(best_x));
+                return { toVector<N>(best_x), best_f_val, iteration,
+                         "Reached maximum iterations", trajectory };
+            }
+
+            double grad_norm_sq_old = 0.0;
+            for (int i = 0; i < N; ++i) grad_norm_sq_old += grad[i] * grad[i];
+            if (std::sqrt(grad_norm_sq_old) < grad_epsilon) {
+                addPointToTrajectory(toVector<N>(best_x));
+                return { toVector<N>(best_x), best_f_val, iteration,
+                         "Gradient norm below threshold", trajectory };
+            }
+
+            FixedLineFunction phi(*this, x, p);
+            double slope = phi.slope(0.0, grad);
+            if (!(slope < 0.0)) {
+                for (int i = 0; i < N; ++i) p[i] = -grad[i];
+                slope = phi.slope(0.0, grad);
+                steepest = true;
+                if (!(slope < 0.0)) {
+                    addPointToTrajectory(toVector<N>(best_x));
+                    return { toVector<N>(best_x), best_f_val, iteration,
+                             "Projected gradient norm below threshold", trajectory };
+                }
+            }
+            double initial_step = prev_slope < 0.0 ? prev_step * prev_slope / slope : 1.0;
+            if (!(initial_step > 0.0) || !std::isfinite(initial_step)) initial_step = 1.0;
+
+            const LineSearchResult ls = lineSearch.search(phi, f_val, slope, initial_step);
+            if (!ls.accepted) {
+                if (!steepest) {
+                    for (int i = 0; i < N; ++i) p[i] = -grad[i];
+                    steepest = true;
+                    prev_slope = 0.0;
+                    continue;
+                }
+                addPointToTrajectory(toVector<N>(best_x));
+                return { toVector<N>(best_x), best_f_val, iteration,
+                         "Line search failed", trajectory };
+            }
+            prev_step = ls.step;
+            prev_slope = slope;
+
+            const FixedPoint<N> x_new = phi.point;
+            const FixedPoint<N> grad_new = phi.gradient;
+            const double f_val_new = ls.value;
+
+            if (f_val_new < best_f_val) {
+                best_x = x_new;
+                best_f_val = f_val_new;
+            }
+
+            double grad_norm_sq_new = 0.0;
+            bool grad_has_nan = false;
+            for (int i = 0; i < N; ++i) {
+                grad_has_nan = grad_has_nan || std::isnan(grad_new[i]);
+                grad_norm_sq_new += grad_new[i] * grad_new[i];
+            }
+            if (grad_has_nan) {
+                addPointToTrajectory(toVector<N>(best_x));
+                return { toVector<N>(best_x), best_f_val, iteration,
+                         "Gradient contains NaN", trajectory };
+            }
+
+            // Fletcher-Reeves beta
+            double beta = grad_norm_sq_old > 0 ? grad_norm_sq_new / grad_norm_sq_old : 0.0;
+            for (int i = 0; i < N; ++i) {
+                p[i] = -grad_new[i] + beta * p[i];
+            }
+            steepest = false;
+
+            x = x_new;
+            std::copy(x.begin(), x.end(), x_vec.begin());
+            f_val = f_val_new;
+            grad = grad_new;
+            iteration++;
+        }
+        addPointToTrajectory(toVector<N>(best_x));
+
+        return { toVector<N>(best_x), best_f_val, iteration, "Criterial satisfied", trajectory };
+    }
+};
+
+#endif
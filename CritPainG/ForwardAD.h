@@ -0,0 +1,197 @@
+﻿#ifndef FORWARDAD_H
+#define FORWARDAD_H
+
+#include "AbstrFunc.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Автоматическое дифференцирование прямым ходом.
+//
+// Функция записывается один раз как шаблон по типу аргумента:
+//
+//     struct Rosen {
+//         template <class T> T operator()(const T* x, int n) const {
+//             using std::sin; ...
+//         }
+//     };
+//
+// При T = double это обычное вычисление, при T = Dual<W> одновременно
+// вычисляются W производных по направлениям. Градиент в N измерениях
+// получается за ceil(N / W) проходов вместо 2N вычислений numericalGradient,
+// и он точен (без шага h).
+
+template <int W>
+struct Dual {
+    double v;        // значение
+    double d[W];     // производные по W направлениям
+
+    Dual() : v(0.0) { for (int k = 0; k < W; ++k) d[k] = 0.0; }
+    Dual(double value) : v(value) { for (int k = 0; k < W; ++k) d[k] = 0.0; }
+
+    Dual& operator+=(const Dual& b) { v += b.v; for (int k = 0; k < W; ++k) d[k] += b.d[k]; return *this; }
+    Dual& operator-=(const Dual& b) { v -= b.v; for (int k = 0; k < W; ++k) d[k] -= b.d[k]; return *this; }
+    Dual& operator*=(const Dual& b) { *this = *this * b; return *this; }
+    Dual& operator/=(const Dual& b) { *this = *this / b; return *this; }
+
+    // Производная сложной функции: результат g(v) с g'(v) = dg
+    Dual chain(double value, double dg) const {
+        Dual r(value);
+        for (int k = 0; k < W; ++k) r.d[k] = dg * d[k];
+        return r;
+    }
+
+    friend Dual operator+(const Dual& a, const Dual& b) { Dual r(a); r += b; return r; }
+    friend Dual operator-(const Dual& a, const Dual& b) { Dual r(a); r -= b; return r; }
+    friend Dual operator-(const Dual& a) { return a.chain(-a.v, -1.0); }
+    friend Dual operator+(const Dual& a) { return a; }
+
+    friend Dual operator*(const Dual& a, const Dual& b) {
+        Dual r(a.v * b.v);
+        for (int k = 0; k < W; ++k) r.d[k] = a.d[k] * b.v + a.v * b.d[k];
+        return r;
+    }
+
+    friend Dual operator/(const Dual& a, const Dual& b) {
+        const double inv = 1.0 / b.v;
+        const double q = a.v * inv;
+        Dual r(q);
+        for (int k = 0; k < W; ++k) r.d[k] = (a.d[k] - q * b.d[k]) * inv;
+        return r;
+    }
+
+    // Смешанные операции с числами не создают лишних нулевых производных
+    friend Dual operator+(const Dual& a, double b) { Dual r(a); r.v += b; return r; }
+    friend Dual operator+(double a, const Dual& b) { return b + a; }
+    friend Dual operator-(const Dual& a, double b) { Dual r(a); r.v -= b; return r; }
+    friend Dual operator-(double a, const Dual& b) { return b.chain(a - b.v, -1.0); }
+    friend Dual operator*(const Dual& a, double b) { return a.chain(a.v * b, b); }
+    friend Dual operator*(double a, const Dual& b) { return b.chain(a * b.v, a); }
+    friend Dual operator/(const Dual& a, double b) { return a.chain(a.v / b, 1.0 / b); }
+    friend Dual operator/(double a, const Dual& b) { const double q = a / b.v; return b.chain(q, -q / b.v); }
+
+    friend bool operator<(const Dual& a, const Dual& b) { return a.v < b.v; }
+    friend bool operator>(const Dual& a, const Dual& b) { return a.v > b.v; }
+    friend bool operator<=(const Dual& a, const Dual& b) { return a.v <= b.v; }
+    friend bool operator>=(const Dual& a, const Dual& b) { return a.v >= b.v; }
+    friend bool operator==(const Dual& a, const Dual& b) { return a.v == b.v; }
+    friend bool operator!=(const Dual& a, const Dual& b) { return a.v != b.v; }
+
+    // Элементарные функции (находятся через ADL)
+    friend Dual sin(const Dual& a) { return a.chain(std::sin(a.v), std::cos(a.v)); }
+    friend Dual cos(const Dual& a) { return a.chain(std::cos(a.v), -std::sin(a.v)); }
+    friend Dual tan(const Dual& a) { const double t = std::tan(a.v); return a.chain(t, 1.0 + t * t); }
+    friend Dual exp(const Dual& a) { const double e = std::exp(a.v); return a.chain(e, e); }
+    friend Dual log(const Dual& a) { return a.chain(std::log(a.v), 1.0 / a.v); }
+    friend Dual sqrt(const Dual& a) { const double s = std::sqrt(a.v); return a.chain(s, 0.5 / s); }
+    friend Dual atan(const Dual& a) { return a.chain(std::atan(a.v), 1.0 / (1.0 + a.v * a.v)); }
+    friend Dual tanh(const Dual& a) { const double t = std::tanh(a.v); return a.chain(t, 1.0 - t * t); }
+    friend Dual abs(const Dual& a) { return a.chain(std::abs(a.v), a.v < 0.0 ? -1.0 : 1.0); }
+    friend Dual fabs(const Dual& a) { return abs(a); }
+
+    friend Dual pow(const Dual& a, double p) {
+        const double r = std::pow(a.v, p);
+        return a.chain(r, p == 0.0 ? 0.0 : p * std::pow(a.v, p - 1.0));
+    }
+    // d(a^b) = b a^(b-1) da + a^b ln(a) db. При a <= 0 слагаемое с ln(a)
+    // опускается: степень отрицательного числа определена только для целого
+    // показателя, и он здесь постоянный (например, pow(x, T(3)))
+    friend Dual pow(const Dual& a, const Dual& b) {
+        const double r = std::pow(a.v, b.v);
+        const double da = b.v == 0.0 ? 0.0 : b.v * std::pow(a.v, b.v - 1.0);
+        const double db = a.v > 0.0 ? r * std::log(a.v) : 0.0;
+        Dual res(r);
+        for (int k = 0; k < W; ++k) res.d[k] = da * a.d[k] + db * b.d[k];
+        return res;
+    }
+    friend Dual pow(double a, const Dual& b) {
+        const double r = std::pow(a, b.v);
+        return b.chain(r, a > 0.0 ? r * std::log(a) : 0.0);
+    }
+};
+
+template <int W>
+inline double valueOf(const Dual<W>& a) { return a.v; }
+inline double valueOf(double a) { return a; }
+
+// Адаптер: шаблонный функтор F -> AbstrFunc с точным градиентом прямым ходом.
+// W - число направлений, вычисляемых за один проход.
+template <class F, int W = 8>
+class FunctionFromTemplate : public AbstrFunc {
+private:
+    F func;
+    int dimension;
+    std::string name;
+
+    void checkSize(const std::vector<double>& x) const {
+        if (static_cast<int>(x.size()) != dimension) {
+            throw std::invalid_argument(name + " requires exactly " + std::to_string(dimension) + " dimensions");
+        }
+    }
+
+    // Один проход: производные по координатам [first, first + W)
+    double gradientPass(const std::vector<double>& x, std::vector<Dual<W>>& args, int first, std::vector<double>& grad) const {
+        for (int j = 0; j < dimension; ++j) {
+            args[j] = Dual<W>(x[j]);
+            const int lane = j - first;
+            if (lane >= 0 && lane < W) {
+                args[j].d[lane] = 1.0;
+            }
+        }
+
+        Dual<W> r = func(args.data(), dimension);
+        for (int lane = 0; lane < W && first + lane < dimension; ++lane) {
+            grad[first + lane] = r.d[lane];
+        }
+        return r.v;
+    }
+
+public:
+    FunctionFromTemplate(F f, int dim, std::string funcName)
+        : func(std::move(f)), dimension(dim), name(std::move(funcName)) {
+        if (dim <= 0) {
+            throw std::invalid_argument("Dimension must be positive.");
+        }
+    }
+
+    double operator()(const std::vector<double>& x) const override {
+        checkSize(x);
+        return func(x.data(), dimension);
+    }
+
+    std::vector<double> getGradient(const std::vector<double>& x) const override {
+        std::vector<double> grad;
+        valueAndGradient(x, grad);
+        return grad;
+    }
+
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override {
+        checkSize(x);
+        grad.resize(dimension);
+        std::vector<Dual<W>> args(dimension);
+
+        double value = 0.0;
+        for (int first = 0; first < dimension; first += W) {
+            value = gradientPass(x, args, first, grad);
+        }
+        return value;
+    }
+
+    std::string getName() const override { return name; }
+    int getDimension() const override { return dimension; }
+
+    // Прямой (невиртуальный) доступ к шаблонному вычислению
+    template <class T>
+    T evaluate(const T* x) const { return func(x, dimension); }
+
+    const F& functor() const { return func; }
+};
+
+template <int W = 8, class F>
+FunctionFromTemplate<F, W> makeFunctionFromTemplate(F f, int dim, std::string name) {
+    return FunctionFromTemplate<F, W>(std::move(f), dim, std::move(name));
+}
+
+#endif
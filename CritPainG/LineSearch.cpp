@@ -0,0 +1,278 @@
+﻿#include "pch.h"
+#include "LineSearch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Минимум кубического многочлена по значениям и производным в a и b;
+// NaN, если кубика не имеет минимума
+double cubicMinimizer(double a, double fa, double da, double b, double fb, double db) {
+    const double d1 = da + db - 3.0 * (fa - fb) / (a - b);
+    const double radicand = d1 * d1 - da * db;
+    if (!(radicand >= 0.0)) return std::numeric_limits<double>::quiet_NaN();
+    const double d2 = (b > a ? 1.0 : -1.0) * std::sqrt(radicand);
+    const double denominator = db - da + 2.0 * d2;
+    if (denominator == 0.0) return std::numeric_limits<double>::quiet_NaN();
+    return b - (b - a) * (db + d2 - d1) / denominator;
+}
+
+void checkStep(double initialStep) {
+    if (!(initialStep > 0.0)) {
+        throw std::invalid_argument("Initial step must be positive.");
+    }
+}
+
+} // namespace
+
+ArmijoLineSearch::ArmijoLineSearch(double c1_, int max_iter_)
+    : c1(c1_), max_iter(max_iter_) {
+    if (c1 <= 0.0 || c1 >= 1.0) {
+        throw std::invalid_argument("Armijo constant must be in range (0, 1).");
+    }
+    if (max_iter < 1) {
+        throw std::invalid_argument("Maximum line search iterations must be positive.");
+    }
+}
+
+LineSearchResult ArmijoLineSearch::search(LineFunction& phi, double f0, double slope0, double initialStep) const {
+    checkStep(initialStep);
+    double step = initialStep;
+    for (int k = 0; k < max_iter; ++k) {
+        const double value = phi.value(step);
+        if (value <= f0 + c1 * step * slope0) {
+            phi.completeGradient(value);
+            return { true, step, value, k + 1 };
+        }
+        // Минимум параболы по phi(0), phi'(0), phi(step)
+        double next = 0.5 * step;
+        const double excess = value - f0 - slope0 * step;
+        if (std::isfinite(value) && excess > 0.0) {
+            next = -slope0 * step * step / (2.0 * excess);
+        }
+        step = (std::max)(0.1 * step, (std::min)(0.5 * step, next));
+    }
+    return { false, step, f0, max_iter };
+}
+
+std::unique_ptr<LineSearch> ArmijoLineSearch::clone() const {
+    return std::make_unique<ArmijoLineSearch>(*this);
+}
+
+std::string ArmijoLineSearch::getName() const {
+    return "Armijo backtracking (c1 = " + std::to_string(c1) + ")";
+}
+
+StrongWolfeLineSearch::StrongWolfeLineSearch(double c1_, double c2_, int max_iter_, double tolerance_)
+    : c1(c1_), c2(c2_), max_iter(max_iter_), tolerance(tolerance_) {
+    if (c1 <= 0.0 || c1 >= c2 || c2 >= 1.0) {
+        throw std::invalid_argument("Wolfe constants must satisfy 0 < c1 < c2 < 1.");
+    }
+    if (max_iter < 1) {
+        throw std::invalid_argument("Maximum line search iterations must be positive.");
+    }
+    if (tolerance < 0.0) {
+        throw std::invalid_argument("Line search tolerance must be non-negative.");
+    }
+}
+
+LineSearchResult StrongWolfeLineSearch::search(LineFunction& phi, double f0, double slope0, double initialStep) const {
+    checkStep(initialStep);
+    int evaluations = 0;
+    auto armijo = [&](double step, double value) { return value <= f0 + c1 * step * slope0; };
+    auto curvatureHolds = [&](double slope) { return std::fabs(slope) <= -c2 * slope0; };
+
+    // Сужение интервала: lo - лучшая точка с условием Армихо, phi'(lo) (hi - lo) < 0
+    auto zoom = [&](double lo, double f_lo, double d_lo, double hi, double f_hi, double d_hi) -> LineSearchResult {
+        while (evaluations < max_iter) {
+            const double width = std::fabs(hi - lo);
+            if (width <= tolerance * (std::max)(initialStep, (std::max)(lo, hi))) break;
+
+            // Кубическая интерполяция, если она даёт точку внутри интервала
+            // не ближе 10% к концам, иначе середина
+            double step = std::isfinite(f_hi) && std::isfinite(d_hi)
+                ? cubicMinimizer(lo, f_lo, d_lo, hi, f_hi, d_hi)
+                : std::numeric_limits<double>::quiet_NaN();
+            const double left = (std::min)(lo, hi) + 0.1 * width;
+            const double right = (std::max)(lo, hi) - 0.1 * width;
+            if (!(step >= left && step <= right)) step = 0.5 * (lo + hi);
+
+            double slope = 0.0;
+            const double value = phi.valueAndSlope(step, slope);
+            ++evaluations;
+            if (!armijo(step, value) || value >= f_lo) {
+                hi = step;
+                f_hi = value;
+                d_hi = slope;
+            }
+            else {
+                if (curvatureHolds(slope)) return { true, step, value, evaluations };
+                if (slope * (hi - lo) >= 0.0) {
+                    hi = lo;
+                    f_hi = f_lo;
+                    d_hi = d_lo;
+                }
+                lo = step;
+                f_lo = value;
+                d_lo = slope;
+                phi.save();
+            }
+        }
+        // Интервал исчерпан: лучшая точка с условием Армихо, если она есть
+        if (lo > 0.0) {
+            phi.restore();
+            return { true, lo, f_lo, evaluations };
+        }
+        return { false, lo, f0, evaluations };
+    };
+
+    double prev = 0.0, f_prev = f0, d_prev = slope0;
+    double step = initialStep;
+    while (evaluations < max_iter) {
+        double slope = 0.0;
+        const double value = phi.valueAndSlope(step, slope);
+        ++evaluations;
+        if (!armijo(step, value) || (evaluations > 1 && value >= f_prev)) {
+            return zoom(prev, f_prev, d_prev, step, value, slope);
+        }
+        if (curvatureHolds(slope)) {
+            return { true, step, value, evaluations };
+        }
+        // Шаг с условием Армихо становится lo для zoom или prev для расширения
+        phi.save();
+        if (slope >= 0.0) {
+            return zoom(step, value, slope, prev, f_prev, d_prev);
+        }
+        // Расширение: экстраполяция кубикой в пределах [1.1, 4] шага
+        double next = cubicMinimizer(prev, f_prev, d_prev, step, value, slope);
+        const double low = step + 1.1 * (step - prev);
+        const double high = 4.0 * step;
+        if (!(next >= low && next <= high)) next = high;
+        prev = step;
+        f_prev = value;
+        d_prev = slope;
+        step = next;
+    }
+    // Бюджет исчерпан на расширении: последний шаг удовлетворяет Армихо
+    if (prev > 0.0) {
+        phi.restore();
+        return { true, prev, f_prev, evaluations };
+    }
+    return { false, step, f0, evaluations };
+}
+
+std::unique_ptr<LineSearch> StrongWolfeLineSearch::clone() const {
+    return std::make_unique<StrongWolfeLineSearch>(*this);
+}
+
+std::string StrongWolfeLineSearch::getName() const {
+    return "Strong Wolfe (c1 = " + std::to_string(c1) + ", c2 = " + std::to_string(c2) + ")";
+}
+
+ExactQuadraticLineSearch::ExactQuadraticLineSearch(double c1, int max_iter)
+    : fallback(c1, max_iter) {}
+
+LineSearchResult ExactQuadraticLineSearch::search(LineFunction& phi, double f0, double slope0, double initialStep) const {
+    checkStep(initialStep);
+    const double curvature = phi.curvature();
+    if (curvature > 0.0 && std::isfinite(curvature)) {
+        // Дробление Армихо начинается с точного шага и для квадратичной
+        // функции принимает его сразу (phi(a*) = phi(0) + a* phi'(0) / 2)
+        return fallback.search(phi, f0, slope0, -slope0 / curvature);
+    }
+    return fallback.search(phi, f0, slope0, initialStep);
+}
+
+std::unique_ptr<LineSearch> ExactQuadraticLineSearch::clone() const {
+    return std::make_unique<ExactQuadraticLineSearch>(*this);
+}
+
+std::string ExactQuadraticLineSearch::getName() const {
+    return "Exact quadratic step";
+}
+
+VectorLineFunction::VectorLineFunction(const AbstrFunc& f, const FiniteDifferenceOptions& fd_,
+    const std::vector<double>& x_, const std::vector<double>& p_,
+    const std::vector<double>* lower_, const std::vector<double>* upper_)
+    : func(f), fd(fd_), x(x_), p(p_), lower(lower_), upper(upper_), point(x_), gradient(x_.size()) {
+    if (p.size() != x.size()) {
+        throw std::invalid_argument("Direction size must match point size.");
+    }
+    if ((lower == nullptr) != (upper == nullptr) ||
+        (lower && (lower->size() != x.size() || upper->size() != x.size()))) {
+        throw std::invalid_argument("Sizes of bounds and point must match.");
+    }
+}
+
+void VectorLineFunction::moveTo(double alpha) {
+    for (size_t i = 0; i < x.size(); ++i) {
+        point[i] = x[i] + alpha * p[i];
+    }
+    if (lower) {
+        for (size_t i = 0; i < x.size(); ++i) {
+            point[i] = (std::max)((*lower)[i], (std::min)((*upper)[i], point[i]));
+        }
+    }
+}
+
+double VectorLineFunction::slopeAt(double alpha) const {
+    double slope = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        // Координата, упёршаяся в границу, вдоль ломаной не меняется
+        if (lower) {
+            const double moved = x[i] + alpha * p[i];
+            if (p[i] > 0.0 ? moved >= (*upper)[i] : moved <= (*lower)[i]) continue;
+        }
+        slope += gradient[i] * p[i];
+    }
+    return slope;
+}
+
+double VectorLineFunction::initialSlope(const std::vector<double>& grad) const {
+    double slope = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (lower && (p[i] > 0.0 ? x[i] >= (*upper)[i] : x[i] <= (*lower)[i])) continue;
+        slope += grad[i] * p[i];
+    }
+    return slope;
+}
+
+double VectorLineFunction::value(double alpha) {
+    moveTo(alpha);
+    return func(point);
+}
+
+double VectorLineFunction::valueAndSlope(double alpha, double& slope) {
+    moveTo(alpha);
+    const double fx = evaluateWithGradient(func, point, gradient, fd);
+    slope = slopeAt(alpha);
+    return fx;
+}
+
+void VectorLineFunction::completeGradient(double value) {
+    gradient = gradientWithKnownValue(func, point, value, fd);
+}
+
+void VectorLineFunction::save() {
+    savedPoint = point;
+    savedGradient = gradient;
+}
+
+void VectorLineFunction::restore() {
+    point = savedPoint;
+    gradient = savedGradient;
+}
+
+double VectorLineFunction::curvature() {
+    std::vector<double> direction = p;
+    if (lower) {
+        for (size_t i = 0; i < x.size(); ++i) {
+            if (p[i] > 0.0 ? x[i] >= (*upper)[i] : x[i] <= (*lower)[i]) direction[i] = 0.0;
+        }
+    }
+    const std::vector<double> hp = func.hessianVectorProduct(x, direction);
+    double sum = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) sum += direction[i] * hp[i];
+    return sum;
+}
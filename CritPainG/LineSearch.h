@@ -0,0 +1,138 @@
+﻿#ifndef LINESEARCH_H
+#define LINESEARCH_H
+
+#include "AbstrFunc.h"
+#include "FiniteDifference.h"
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Одномерный поиск шага для градиентных методов.
+//
+// Стратегия работает с функцией phi(alpha) = f(x(alpha)) через LineFunction и
+// не знает, как устроена точка: VectorLineFunction считает через AbstrFunc,
+// оптимизаторы с фиксированной размерностью (FixedOptim.h) дают свою
+// реализацию. При успехе последняя вычисленная (или восстановленная) точка -
+// принятая, и градиент в ней уже посчитан, так что оптимизатору не нужно
+// вычислять её повторно.
+
+class LineFunction {
+public:
+    virtual ~LineFunction() = default;
+    // phi(alpha); точка становится последней, градиент в ней не считается
+    virtual double value(double alpha) = 0;
+    // phi(alpha) и phi'(alpha); точка и градиент становятся последними
+    virtual double valueAndSlope(double alpha, double& slope) = 0;
+    // Досчитывает градиент в последней точке value() при известном значении
+    virtual void completeGradient(double value) = 0;
+    // Запомнить последнюю точку с градиентом / снова сделать её последней
+    virtual void save() = 0;
+    virtual void restore() = 0;
+    // phi''(0); NaN - кривизна неизвестна
+    virtual double curvature() { return std::numeric_limits<double>::quiet_NaN(); }
+};
+
+struct LineSearchResult {
+    bool accepted;
+    double step;
+    double value;     // phi(step) для принятого шага
+    int evaluations;  // вычислений phi
+};
+
+class LineSearch {
+public:
+    virtual ~LineSearch() = default;
+    // f0 = phi(0), slope0 = phi'(0) < 0, initialStep > 0 - первый пробный шаг
+    virtual LineSearchResult search(LineFunction& phi, double f0, double slope0, double initialStep) const = 0;
+    virtual std::unique_ptr<LineSearch> clone() const = 0;
+    virtual std::string getName() const = 0;
+};
+
+// Дробление с условием Армихо phi(a) <= phi(0) + c1 a phi'(0); новый шаг -
+// минимум квадратичной интерполяции, но в пределах [0.1 a, 0.5 a]. Градиент
+// считается только в принятой точке
+class ArmijoLineSearch : public LineSearch {
+private:
+    double c1;
+    int max_iter;
+public:
+    explicit ArmijoLineSearch(double c1 = 1e-4, int max_iter = 50);
+    LineSearchResult search(LineFunction& phi, double f0, double slope0, double initialStep) const override;
+    std::unique_ptr<LineSearch> clone() const override;
+    std::string getName() const override;
+};
+
+// Сильные условия Вулфа: Армихо и |phi'(a)| <= c2 |phi'(0)|. Интервал с
+// минимумом ищется расширением шага, затем сужается (zoom) минимумом кубической
+// интерполяции по значениям и производным концов с защитой от выхода к концам,
+// как у Морэ-Туэнте. Для Флетчера-Ривса c2 < 1/2 гарантирует спуск следующего
+// направления. Если интервал сузился до tolerance (относительно большего из
+// начального и текущего шага) или кончился бюджет, берётся лучшая точка с
+// условием Армихо: её состояние запоминается в LineFunction, а не вычисляется
+// повторно
+class StrongWolfeLineSearch : public LineSearch {
+private:
+    double c1;
+    double c2;
+    int max_iter;
+    double tolerance;
+public:
+    StrongWolfeLineSearch(double c1 = 1e-4, double c2 = 0.1, int max_iter = 50, double tolerance = 1e-10);
+    LineSearchResult search(LineFunction& phi, double f0, double slope0, double initialStep) const override;
+    std::unique_ptr<LineSearch> clone() const override;
+    std::string getName() const override;
+};
+
+// Точный шаг для квадратичной функции: a = -phi'(0) / phi''(0), где
+// phi''(0) = p^T H p берётся из AbstrFunc::hessianVectorProduct. Если кривизна
+// неизвестна или неположительна либо шаг не проходит условие Армихо
+// (функция не квадратичная), шаг уточняется дроблением Армихо
+class ExactQuadraticLineSearch : public LineSearch {
+private:
+    ArmijoLineSearch fallback;
+public:
+    explicit ExactQuadraticLineSearch(double c1 = 1e-4, int max_iter = 50);
+    LineSearchResult search(LineFunction& phi, double f0, double slope0, double initialStep) const override;
+    std::unique_ptr<LineSearch> clone() const override;
+    std::string getName() const override;
+};
+
+// phi(alpha) = f(P(x + alpha p)) для AbstrFunc; P - проекция на границы, если
+// они заданы. Производная берётся по ломаной: координаты, упёршиеся в границу,
+// в phi' не входят. Градиент без аналитического считается численно (fd)
+class VectorLineFunction : public LineFunction {
+private:
+    const AbstrFunc& func;
+    const FiniteDifferenceOptions& fd;
+    const std::vector<double>& x;
+    const std::vector<double>& p;
+    const std::vector<double>* lower;
+    const std::vector<double>* upper;
+    std::vector<double> savedPoint;
+    std::vector<double> savedGradient;
+
+    void moveTo(double alpha);
+    double slopeAt(double alpha) const;
+
+public:
+    // Последняя вычисленная точка и градиент в ней
+    std::vector<double> point;
+    std::vector<double> gradient;
+
+    VectorLineFunction(const AbstrFunc& f, const FiniteDifferenceOptions& fd,
+        const std::vector<double>& x, const std::vector<double>& p,
+        const std::vector<double>* lower = nullptr, const std::vector<double>* upper = nullptr);
+
+    // phi'(0) по градиенту grad в x
+    double initialSlope(const std::vector<double>& grad) const;
+
+    double value(double alpha) override;
+    double valueAndSlope(double alpha, double& slope) override;
+    void completeGradient(double value) override;
+    void save() override;
+    void restore() override;
+    double curvature() override;
+};
+
+#endif
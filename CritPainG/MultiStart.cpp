@@ -0,0 +1,82 @@
+﻿#include "pch.h"
+#include "MultiStart.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+MultiStartResult runMultiStart(const OptimizerFactory& factory,
+    const std::vector<std::vector<double>>& starts, ThreadPool& pool) {
+    if (starts.empty()) {
+        throw std::invalid_argument("Multi-start needs at least one initial point.");
+    }
+
+    MultiStartResult result;
+    result.runs.resize(starts.size());
+    std::vector<char> failed(starts.size(), 0);
+    std::vector<std::string> errors(starts.size());
+    // Каждая задача пишет только свои элементы
+    pool.forEachTask(starts.size(), [&](size_t run) {
+        try {
+            std::unique_ptr<AbstrOptim> optimizer = factory(starts[run], run);
+            if (!optimizer) {
+                throw std::runtime_error("Optimizer factory returned null.");
+            }
+            result.runs[run] = optimizer->optimize();
+        }
+        catch (const std::exception& e) {
+            failed[run] = 1;
+            errors[run] = e.what();
+            result.runs[run] = AbstrOptim::Result(starts[run], std::numeric_limits<double>::infinity(), 0,
+                "Run failed: " + errors[run], {});
+        }
+    });
+
+    // Первый удавшийся запуск, затем меньшее значение; NaN не заменяет число
+    bool found = false;
+    for (size_t run = 0; run < result.runs.size(); ++run) {
+        if (failed[run]) continue;
+        const double value = result.runs[run].value;
+        const double best = result.runs[result.bestRun].value;
+        if (!found || (!std::isnan(value) && (std::isnan(best) || value < best))) {
+            result.bestRun = run;
+            found = true;
+        }
+    }
+    if (!found) {
+        throw std::runtime_error("All multi-start runs failed: " + errors[0]);
+    }
+    result.best = result.runs[result.bestRun];
+    return result;
+}
+
+std::vector<std::vector<double>> multiStartPoints(const std::vector<double>& x0,
+    const std::vector<double>& lb, const std::vector<double>& ub,
+    size_t count, unsigned int seed) {
+    if (lb.size() != ub.size() || lb.size() != x0.size()) {
+        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+    }
+    for (size_t i = 0; i < lb.size(); ++i) {
+        if (lb[i] > ub[i]) {
+            throw std::invalid_argument("Lower bound must be <= upper bound.");
+        }
+    }
+
+    std::vector<std::vector<double>> starts;
+    if (count == 0) {
+        return starts;
+    }
+    starts.reserve(count);
+    starts.push_back(x0);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (size_t k = 1; k < count; ++k) {
+        std::vector<double> x(x0.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            x[i] = lb[i] + uniform(gen) * (ub[i] - lb[i]);
+        }
+        starts.push_back(std::move(x));
+    }
+    return starts;
+}
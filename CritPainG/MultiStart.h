@@ -0,0 +1,47 @@
+﻿#ifndef MULTISTART_H
+#define MULTISTART_H
+
+#include "AbstrOptim.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Мультистарт: независимые запуски оптимизатора из разных начальных точек.
+//
+// Каждый запуск - отдельная задача ThreadPool::forEachTask. Запуски длятся
+// очень по-разному (один сходится за десятки итераций, другой идёт до
+// критерия), поэтому они не делятся между потоками заранее: освободившийся
+// поток берёт следующий запуск или перехватывает задачу у занятого, в том
+// числе части пакетов evaluatePopulation, которые запуск сам раздаёт пулу.
+//
+// Оптимизатор запуска создаёт factory(x0, run) в потоке пула, так что фабрика
+// должна быть потокобезопасной (обычно - только читает конфигурацию), а функция
+// - допускать одновременные вызовы. Результат запуска зависит только от его
+// номера (например, seed = base + run), но не от порядка выполнения.
+
+// Создаёт оптимизатор запуска run из точки x0
+using OptimizerFactory = std::function<std::unique_ptr<AbstrOptim>(const std::vector<double>& x0, size_t run)>;
+
+struct MultiStartResult {
+    AbstrOptim::Result best;               // копия runs[bestRun]
+    size_t bestRun = 0;
+    std::vector<AbstrOptim::Result> runs;  // в порядке начальных точек
+};
+
+// Запуск, выбросивший исключение, записывается со значением +inf и причиной
+// "Run failed: ..."; остальные запуски продолжаются. Если не удался ни один -
+// std::runtime_error. Лучший - наименьшее значение (NaN хуже любого числа), при
+// равенстве - запуск с меньшим номером.
+MultiStartResult runMultiStart(const OptimizerFactory& factory,
+    const std::vector<std::vector<double>>& starts,
+    ThreadPool& pool = ThreadPool::shared());
+
+// count начальных точек: x0 и count - 1 точек, равномерно распределённых в
+// параллелепипеде lb, ub
+std::vector<std::vector<double>> multiStartPoints(const std::vector<double>& x0,
+    const std::vector<double>& lb, const std::vector<double>& ub,
+    size_t count, unsigned int seed);
+
+#endif
@@ -0,0 +1,262 @@
+﻿#include "pch.h"
+#include "NelderMead.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+NelderMead::NelderMead(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, const std::vector<double>& lb,
+    const std::vector<double>& ub, double initial_step, bool adaptive)
+    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub),
+    initial_step(initial_step), adaptive(adaptive), x_tolerance(1e-10), f_tolerance(1e-12), shrinks(0) {
+    if (x0.empty()) {
+        throw std::invalid_argument("Initial point must not be empty.");
+    }
+    if (!(initial_step > 0.0)) {
+        throw std::invalid_argument("Initial simplex step must be positive.");
+    }
+    if (lb.empty() && ub.empty()) {
+        return;
+    }
+    if (lb.size() != ub.size() || lb.size() != x0.size()) {
+        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+    }
+    for (size_t i = 0; i < lb.size(); ++i) {
+        if (lb[i] > ub[i]) {
+            throw std::invalid_argument("Lower bound must be <= upper bound.");
+        }
+        if (x0[i] < lb[i] || x0[i] > ub[i]) {
+            throw std::invalid_argument("Initial point must be inside the box D.");
+        }
+    }
+}
+
+NelderMead::NelderMead(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, double initial_step, bool adaptive)
+    : NelderMead(f, std::move(c), x0, std::vector<double>(), std::vector<double>(), initial_step, adaptive) {}
+
+void NelderMead::setTolerances(double x_tol, double f_tol) {
+    if (x_tol < 0.0 || f_tol < 0.0) {
+        throw std::invalid_argument("Simplex tolerances must be non-negative.");
+    }
+    x_tolerance = x_tol;
+    f_tolerance = f_tol;
+}
+
+void NelderMead::project(std::vector<double>& x) const {
+    if (lower_bounds.empty()) return;
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = (std::max)(lower_bounds[i], (std::min)(upper_bounds[i], x[i]));
+    }
+}
+
+AbstrOptim::Result NelderMead::run() {
+    trajectory.clear();
+    shrinks = 0;
+    const size_t n = initialPoint.size();
+    const double dn = static_cast<double>(n);
+
+    // Отражение, растяжение, сжатие, редукция
+    const bool scaled = adaptive && n >= 2;
+    const double rho = 1.0;
+    const double chi = scaled ? 1.0 + 2.0 / dn : 2.0;
+    const double gamma = scaled ? 0.75 - 0.5 / dn : 0.5;
+    const double sigma = scaled ? 1.0 - 1.0 / dn : 0.5;
+
+    std::vector<double> simplex((n + 1) * n);
+    std::vector<double> values(n + 1);
+    std::vector<size_t> order(n + 1);
+    // Точки для evaluateBatch в раскладке SoA: j-я координата i-й точки в batch[j * n + i]
+    std::vector<double> batch(n * n);
+
+    // Начальный симплекс: x0 и n шагов вдоль осей; шаг, выходящий за верхнюю
+    // границу, делается в обратную сторону, а если выходит и он - до дальней
+    // от x0 границы, так что вершина остаётся в параллелепипеде
+    for (size_t j = 0; j < n; ++j) simplex[j] = initialPoint[j];
+    for (size_t v = 1; v <= n; ++v) {
+        double* vertex = &simplex[v * n];
+        for (size_t j = 0; j < n; ++j) vertex[j] = initialPoint[j];
+        const size_t j = v - 1;
+        double h;
+        if (!lower_bounds.empty()) {
+            h = initial_step * (upper_bounds[j] - lower_bounds[j]);
+            if (vertex[j] + h > upper_bounds[j]) {
+                const double up = upper_bounds[j] - vertex[j];
+                const double down = vertex[j] - lower_bounds[j];
+                h = down >= h ? -h : (up >= down ? up : -down);
+            }
+        }
+        else {
+            h = initial_step * (std::max)(std::fabs(vertex[j]), 1.0);
+        }
+        vertex[j] += h;
+    }
+    values[0] = (*func)(initialPoint);
+    for (size_t v = 1; v <= n; ++v) {
+        for (size_t j = 0; j < n; ++j) batch[j * n + (v - 1)] = simplex[v * n + j];
+    }
+    func->evaluateBatch(batch.data(), n, &values[1]);
+
+    std::vector<double> sum(n);
+    auto recomputeSum = [&]() {
+        std::fill(sum.begin(), sum.end(), 0.0);
+        for (size_t v = 0; v <= n; ++v) {
+            for (size_t j = 0; j < n; ++j) sum[j] += simplex[v * n + j];
+        }
+    };
+    auto sortOrder = [&]() {
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return values[a] < values[b]; });
+    };
+    recomputeSum();
+    sortOrder();
+
+    std::vector<double> best_point(simplex.begin() + order[0] * n, simplex.begin() + (order[0] + 1) * n);
+    double best_value = values[order[0]];
+    addPointToTrajectory(best_point);
+
+    std::vector<double> centroid(n), reflected(n), trial(n);
+    int iteration = 0;
+    int since_sum = 0;
+
+    const int max_fallback_iterations = MaxI;
+
+    while (!criterial->isSatisfied(best_point, best_value, iteration)) {
+        if (iteration >= max_fallback_iterations) {
+            return { best_point, best_value, iteration,
+                     "Fallback: reached maximum iterations", trajectory };
+        }
+
+        const size_t best = order[0];
+        const size_t worst = order[n];
+        const double f_best = values[best];
+        const double f_worst = values[worst];
+        if (std::isnan(f_best)) {
+            return { best_point, best_value, iteration,
+                     "Function value is NaN", trajectory };
+        }
+
+        // Размер симплекса проверяется только при малом разбросе значений
+        if (f_worst - f_best <= f_tolerance) {
+            double diameter = 0.0;
+            const double* xb = &simplex[best * n];
+            for (size_t v = 0; v <= n && diameter <= x_tolerance; ++v) {
+                const double* xv = &simplex[v * n];
+                for (size_t j = 0; j < n; ++j) {
+                    diameter = (std::max)(diameter, std::fabs(xv[j] - xb[j]));
+                }
+            }
+            if (diameter <= x_tolerance) {
+                return { best_point, best_value, iteration,
+                         "Simplex converged", trajectory };
+            }
+        }
+
+        double* xw = &simplex[worst * n];
+        for (size_t j = 0; j < n; ++j) {
+            centroid[j] = (sum[j] - xw[j]) / dn;
+            reflected[j] = centroid[j] + rho * (centroid[j] - xw[j]);
+        }
+        project(reflected);
+        const double f_reflected = (*func)(reflected);
+
+        const std::vector<double>* accepted = nullptr;
+        double f_accepted = 0.0;
+        if (f_reflected < f_best) {
+            for (size_t j = 0; j < n; ++j) trial[j] = centroid[j] + chi * (reflected[j] - centroid[j]);
+            project(trial);
+            const double f_expanded = (*func)(trial);
+            if (f_expanded < f_reflected) {
+                accepted = &trial;
+                f_accepted = f_expanded;
+            }
+            else {
+                accepted = &reflected;
+                f_accepted = f_reflected;
+            }
+        }
+        else if (f_reflected < values[order[n - 1]]) {
+            accepted = &reflected;
+            f_accepted = f_reflected;
+        }
+        else if (f_reflected < f_worst) {
+            // Внешнее сжатие
+            for (size_t j = 0; j < n; ++j) trial[j] = centroid[j] + gamma * (reflected[j] - centroid[j]);
+            project(trial);
+            const double f_contracted = (*func)(trial);
+            if (f_contracted <= f_reflected) {
+                accepted = &trial;
+                f_accepted = f_contracted;
+            }
+        }
+        else {
+            // Внутреннее сжатие
+            for (size_t j = 0; j < n; ++j) trial[j] = centroid[j] + gamma * (xw[j] - centroid[j]);
+            project(trial);
+            const double f_contracted = (*func)(trial);
+            if (f_contracted < f_worst) {
+                accepted = &trial;
+                f_accepted = f_contracted;
+            }
+        }
+
+        if (accepted) {
+            // Новая вершина на месте худшей и вставка в упорядоченный список
+            for (size_t j = 0; j < n; ++j) {
+                sum[j] += (*accepted)[j] - xw[j];
+                xw[j] = (*accepted)[j];
+            }
+            values[worst] = f_accepted;
+            size_t k = n;
+            while (k > 0 && values[order[k - 1]] > f_accepted) {
+                order[k] = order[k - 1];
+                --k;
+            }
+            order[k] = worst;
+            // Накопленная ошибка суммы сбрасывается раз в n шагов: в среднем O(n) на шаг
+            if (++since_sum >= static_cast<int>(n)) {
+                recomputeSum();
+                since_sum = 0;
+            }
+        }
+        else {
+            // Редукция к лучшей вершине на месте
+            ++shrinks;
+            const double* xb = &simplex[best * n];
+            size_t i = 0;
+            for (size_t v = 0; v <= n; ++v) {
+                if (v == best) continue;
+                double* xv = &simplex[v * n];
+                for (size_t j = 0; j < n; ++j) {
+                    xv[j] = xb[j] + sigma * (xv[j] - xb[j]);
+                    if (!lower_bounds.empty()) {
+                        xv[j] = (std::max)(lower_bounds[j], (std::min)(upper_bounds[j], xv[j]));
+                    }
+                    batch[j * n + i] = xv[j];
+                }
+                ++i;
+            }
+            func->evaluateBatch(batch.data(), n, trial.data());
+            i = 0;
+            for (size_t v = 0; v <= n; ++v) {
+                if (v == best) continue;
+                values[v] = trial[i++];
+            }
+            recomputeSum();
+            since_sum = 0;
+            sortOrder();
+        }
+
+        if (values[order[0]] < best_value) {
+            const double* xb = &simplex[order[0] * n];
+            best_point.assign(xb, xb + n);
+            best_value = values[order[0]];
+            addPointToTrajectory(best_point);
+        }
+        iteration++;
+    }
+
+    return { best_point, best_value, iteration, "Criterial satisfied", trajectory };
+}
@@ -0,0 +1,57 @@
+﻿#ifndef NELDERMEAD_H
+#define NELDERMEAD_H
+
+#include "AbstrOptim.h"
+#include <vector>
+
+// Симплексный метод Нелдера-Мида: без производных, только значения функции.
+//
+// Коэффициенты отражения, растяжения, сжатия и редукции при adaptive зависят от
+// размерности (Гао-Хань): 1, 1 + 2/n, 3/4 - 1/(2n), 1 - 1/n. С классическими
+// 1, 2, 1/2, 1/2 метод при n > 10 часто вырождается и останавливается вдали от
+// минимума.
+//
+// Ограничения - тот же параллелепипед, что у RandomSearchOptim: отражённая и
+// растянутая точки проецируются на него. Точки сжатия и редукции - выпуклые
+// комбинации вершин, но центр тяжести берётся из накопленной суммы, и округление
+// может вывести их на несколько ulp за границу, поэтому они тоже проецируются.
+// Пустые lb и ub - задача без ограничений.
+//
+// Вершины лежат подряд в одном буфере (n + 1) x n, вершина v - с v * n; шаги
+// пишут в него на место худшей вершины, редукция - на месте. Порядок вершин по
+// значению хранится отдельно и после обычного шага поправляется вставкой, сумма
+// вершин для центра тяжести обновляется на разность, так что итерация без
+// редукции стоит O(n) плюс одно-два вычисления. Начальный симплекс и редукция
+// вычисляют n точек одним evaluateBatch.
+class NelderMead : public AbstrOptim {
+private:
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    double initial_step;
+    bool adaptive;
+    double x_tolerance;
+    double f_tolerance;
+    int shrinks;
+
+    void project(std::vector<double>& x) const;
+
+public:
+    // initial_step - ребро начального симплекса: доля ширины параллелепипеда по
+    // координате (не дальше границ), без ограничений - доля max(|x0_i|, 1)
+    NelderMead(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, const std::vector<double>& lb,
+        const std::vector<double>& ub, double initial_step = 0.1, bool adaptive = true);
+    NelderMead(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, double initial_step = 0.1, bool adaptive = true);
+
+    // Остановка, когда разброс значений в вершинах не больше f_tol и все
+    // вершины ближе x_tol к лучшей (по максимуму модуля координат)
+    void setTolerances(double x_tol, double f_tol);
+    // Редукций симплекса за последний запуск
+    int getShrinkCount() const { return shrinks; }
+
+protected:
+    Result run() override;
+};
+
+#endif
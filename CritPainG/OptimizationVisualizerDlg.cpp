@@ -6,6 +6,8 @@
 #include "afxdialogex.h"
 #include "OptimizationVisualizerDlg.h"
 #include "resource.h"
+#include "ExprFunc.h"
+#include "PluginFunc.h"
 
 // OptimizationVisualizerDlg dialog
 
@@ -18,6 +20,7 @@ OptimizationVisualizerDlg::OptimizationVisualizerDlg(CWnd* pParent /*=nullptr*/)
 	, m_DELTA(0.5), m_P(0.2), m_ALPA(0.8), m_EPS(1e-6)
 	, m_CriterialType(0)        // По умолчанию: 1000 итераций
 	, m_SelectedFunction(0)
+	, m_Formula(_T("(x-3)^2 + sin(y)*y"))
 {
 }
 
@@ -43,19 +46,55 @@ void OptimizationVisualizerDlg::DoDataExchange(CDataExchange* pDX)
 	DDV_MinMaxDouble(pDX, m_EPS, 0, 1);
 	DDX_Radio(pDX, MAXIT, m_CriterialType);
 	DDX_Control(pDX, FUNCCONT, m_funcCombo);
+	DDX_Text(pDX, FORMULA, m_Formula);
+	DDX_Text(pDX, PLUGINPATH, m_PluginPath);
 }
 
 
 BEGIN_MESSAGE_MAP(OptimizationVisualizerDlg, CDialog)
 	ON_BN_CLICKED(IDOK, &OptimizationVisualizerDlg::OnBnClickedOk)
+	ON_BN_CLICKED(PLUGINBROWSE, &OptimizationVisualizerDlg::OnBnClickedPluginBrowse)
 END_MESSAGE_MAP()
 
 void OptimizationVisualizerDlg::OnBnClickedOk()
 {
-	m_SelectedFunction = m_funcCombo.GetCurSel();
+	// Комбобокс сортированный, поэтому номер функции хранится в данных элемента
+	int sel = m_funcCombo.GetCurSel();
+	m_SelectedFunction = (sel == CB_ERR) ? 0 : static_cast<int>(m_funcCombo.GetItemData(sel));
 	// Получаем данные из элементов управления
 	UpdateData(TRUE);
 
+	if (m_SelectedFunction == 3) // Пользовательская формула
+	{
+		try
+		{
+			ExprFunc check(std::string(CT2A(m_Formula)), 2);
+		}
+		catch (const std::exception& e)
+		{
+			AfxMessageBox(CString(e.what()));
+			return;
+		}
+	}
+
+	if (m_SelectedFunction == 4) // Функция из библиотеки
+	{
+		try
+		{
+			PluginFunc check(std::string(CT2A(m_PluginPath)));
+			if (check.getDimension() != 2)
+			{
+				AfxMessageBox(_T("Plugin function must be two-dimensional"));
+				return;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			AfxMessageBox(CString(e.what()));
+			return;
+		}
+	}
+
 	if (m_X1 >= m_X2)
 	{
 		AfxMessageBox(_T("X2 must be greater than X1"));
@@ -91,7 +130,7 @@ void OptimizationVisualizerDlg::OnBnClickedOk()
 	}
 
 	// Проверка параметров градиентов
-	if (m_TypeOpt == 0) // Если выбраны градиенты
+	if (m_TypeOpt == 0 || m_TypeOpt == 2) // Если выбраны градиенты или L-BFGS-B
 	{
 		if (m_EPS <= 0)
 		{
@@ -109,17 +148,50 @@ BOOL OptimizationVisualizerDlg::OnInitDialog()
 	CDialog::OnInitDialog();
 
 	// Заполняем комбобокс
-	m_funcCombo.AddString(_T("Quadratic: f(x,y) = (x-3)^2 + (y+1)^2"));
-	m_funcCombo.AddString(_T("Sphere: f(x,y) = x^2 + y^2"));
-	m_funcCombo.AddString(_T("Rastrigin: f(x,y) = 20 + x^2 + y^2 - 10(cos(2*pi*x) + cos(2*pi*y))"));
+	const LPCTSTR names[] = {
+		_T("Quadratic: f(x,y) = (x-3)^2 + (y+1)^2"),
+		_T("Sphere: f(x,y) = x^2 + y^2"),
+		_T("Rastrigin: f(x,y) = 20 + x^2 + y^2 - 10(cos(2*pi*x) + cos(2*pi*y))"),
+		_T("Custom: f(x,y) from the formula field"),
+		_T("Plugin library: f(x,y) from the library field")
+	};
+	for (int i = 0; i < _countof(names); ++i)
+	{
+		int item = m_funcCombo.AddString(names[i]);
+		m_funcCombo.SetItemData(item, i);
+	}
 
 	// Устанавливаем текущий выбор
-	if (m_SelectedFunction >= 0 && m_SelectedFunction < 3)
-		m_funcCombo.SetCurSel(m_SelectedFunction);
-	else
-		m_funcCombo.SetCurSel(0);
+	m_funcCombo.SetCurSel(0);
+	for (int item = 0; item < m_funcCombo.GetCount(); ++item)
+	{
+		if (static_cast<int>(m_funcCombo.GetItemData(item)) == m_SelectedFunction)
+		{
+			m_funcCombo.SetCurSel(item);
+			break;
+		}
+	}
 
 	UpdateData(FALSE);
 
 	return TRUE;
 }
+
+void OptimizationVisualizerDlg::OnBnClickedPluginBrowse()
+{
+	CFileDialog fileDlg(TRUE, _T("dll"), nullptr, OFN_FILEMUSTEXIST | OFN_HIDEREADONLY,
+		_T("Function libraries (*.dll)|*.dll|All files (*.*)|*.*||"), this);
+	if (fileDlg.DoModal() != IDOK)
+		return;
+
+	SetDlgItemText(PLUGINPATH, fileDlg.GetPathName());
+	// Выбранная библиотека сразу становится текущей функцией
+	for (int item = 0; item < m_funcCombo.GetCount(); ++item)
+	{
+		if (static_cast<int>(m_funcCombo.GetItemData(item)) == 4)
+		{
+			m_funcCombo.SetCurSel(item);
+			break;
+		}
+	}
+}
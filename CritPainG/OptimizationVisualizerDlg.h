@@ -27,9 +27,13 @@ public:
 	double m_DELTA, m_P, m_ALPA, m_EPS;
 	int m_CriterialType;
 	int m_SelectedFunction;
+	CString m_Formula;      // Формула для пользовательской функции
+	CString m_PluginPath;   // Библиотека с функцией (CritPainGPlugin.h)
 
 	CComboBox m_funcCombo;
 
 	// Обработчик OK для валидации
 	afx_msg void OnBnClickedOk();
+	// Выбор библиотеки с функцией
+	afx_msg void OnBnClickedPluginBrowse();
 };
\ No newline at end of file
@@ -0,0 +1,130 @@
+﻿#include "pch.h"
+#include "ParticleSwarm.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// NaN хуже любого числа
+bool better(double a, double b) {
+    return !std::isnan(a) && (std::isnan(b) || a < b);
+}
+
+} // namespace
+
+ParticleSwarm::ParticleSwarm(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+    const std::vector<double>& x0, const std::vector<double>& lb,
+    const std::vector<double>& ub, size_t swarm, double inertia,
+    double cognitive, double social, unsigned int seed)
+    : AbstrOptim(f, std::move(c), x0), lower_bounds(lb), upper_bounds(ub), swarm_size(swarm),
+    inertia(inertia), cognitive(cognitive), social(social), velocity_fraction(0.2) {
+    if (x0.empty()) {
+        throw std::invalid_argument("Initial point must not be empty.");
+    }
+    if (swarm < 2) {
+        throw std::invalid_argument("Swarm size must be at least 2.");
+    }
+    if (lb.size() != ub.size() || lb.size() != x0.size()) {
+        throw std::invalid_argument("Sizes of bounds and initial point must match.");
+    }
+    for (size_t i = 0; i < lb.size(); ++i) {
+        if (lb[i] > ub[i]) {
+            throw std::invalid_argument("Lower bound must be <= upper bound.");
+        }
+        if (x0[i] < lb[i] || x0[i] > ub[i]) {
+            throw std::invalid_argument("Initial point must be inside the box D.");
+        }
+    }
+    rng.seed(seed);
+}
+
+void ParticleSwarm::setVelocityLimit(double fraction) {
+    if (!(fraction > 0.0)) {
+        throw std::invalid_argument("Velocity limit must be positive.");
+    }
+    velocity_fraction = fraction;
+}
+
+AbstrOptim::Result ParticleSwarm::run() {
+    trajectory.clear();
+    const size_t n = initialPoint.size();
+    const size_t S = swarm_size;
+
+    // Положения, скорости и личные лучшие точки: координата j частицы i - [j * S + i]
+    std::vector<double> x(n * S), v(n * S), pbest(n * S);
+    std::vector<double> f(S), pbest_f(S);
+    std::vector<simd::SwarmStep> steps(n);
+
+    for (size_t j = 0; j < n; ++j) {
+        const double lo = lower_bounds[j], width = upper_bounds[j] - lower_bounds[j];
+        steps[j] = { inertia, cognitive, social, velocity_fraction * width, lo, upper_bounds[j] };
+        double* xj = &x[j * S];
+        double* vj = &v[j * S];
+        simd::uniformFill(rng, xj, S);
+        simd::uniformFill(rng, vj, S);
+        for (size_t i = 0; i < S; ++i) {
+            xj[i] = lo + xj[i] * width;
+            vj[i] = (2.0 * vj[i] - 1.0) * steps[j].vmax;
+        }
+        xj[0] = initialPoint[j];
+    }
+    evaluatePopulation(*func, x.data(), n, S, f.data(), populationOptions);
+    pbest = x;
+    pbest_f = f;
+
+    size_t best = 0;
+    for (size_t i = 1; i < S; ++i) {
+        if (better(pbest_f[i], pbest_f[best])) best = i;
+    }
+    std::vector<double> best_point(n);
+    for (size_t j = 0; j < n; ++j) best_point[j] = pbest[j * S + best];
+    double best_value = pbest_f[best];
+    addPointToTrajectory(best_point);
+
+    std::vector<char> improved(S);
+    int iteration = 0;
+    const int max_fallback_iterations = MaxI;
+
+    while (!criterial->isSatisfied(best_point, best_value, iteration)) {
+        if (iteration >= max_fallback_iterations) {
+            return { best_point, best_value, iteration,
+                     "Fallback: reached maximum iterations", trajectory };
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            simd::swarmUpdate(&x[j * S], &v[j * S], &pbest[j * S], best_point[j], S, steps[j], rng);
+        }
+        evaluatePopulation(*func, x.data(), n, S, f.data(), populationOptions);
+
+        // Личные лучшие точки: сначала отметки, затем копирование по строкам
+        bool any = false;
+        for (size_t i = 0; i < S; ++i) {
+            improved[i] = better(f[i], pbest_f[i]);
+            if (improved[i]) {
+                pbest_f[i] = f[i];
+                any = true;
+            }
+        }
+        if (any) {
+            for (size_t j = 0; j < n; ++j) {
+                const double* xj = &x[j * S];
+                double* pj = &pbest[j * S];
+                for (size_t i = 0; i < S; ++i) {
+                    if (improved[i]) pj[i] = xj[i];
+                }
+            }
+            for (size_t i = 0; i < S; ++i) {
+                if (better(pbest_f[i], pbest_f[best])) best = i;
+            }
+            if (better(pbest_f[best], best_value)) {
+                for (size_t j = 0; j < n; ++j) best_point[j] = pbest[j * S + best];
+                best_value = pbest_f[best];
+                addPointToTrajectory(best_point);
+            }
+        }
+        iteration++;
+    }
+
+    return { best_point, best_value, iteration, "Criterial satisfied", trajectory };
+}
@@ -0,0 +1,52 @@
+﻿#ifndef PARTICLESWARM_H
+#define PARTICLESWARM_H
+
+#include "AbstrOptim.h"
+#include "Population.h"
+#include "SimdKernels.h"
+#include <random>
+#include <vector>
+
+// Рой частиц (глобальная топология) в параллелепипеде lb, ub.
+//
+// Положения, скорости и личные лучшие точки хранятся по координатам (SoA): j-я
+// координата i-й частицы - в x[j * S + i]. Обновление скоростей и положений
+// для координаты j - один вызов simd::swarmUpdate по строке из S частиц
+// (AVX-512, AVX2 или скалярный код), положения целиком уходят в
+// evaluatePopulation в раскладке evaluateBatch. Случайные r1, r2 дают
+// независимые генераторы дорожек simd::LaneRandom, а не один std::mt19937, так
+// что генерация векторизуется вместе с обновлением, а последовательность
+// случайных чисел при заданном seed не зависит от уровня SIMD.
+//
+// Частица, вышедшая за границу, ставится на неё с нулевой скоростью по этой
+// координате (обрезка, как у RandomSearchOptim). Скорость ограничена долей
+// velocity_fraction ширины параллелепипеда. Коэффициенты по умолчанию -
+// коэффициенты сжатия Клерка-Кеннеди. Итерация - одно поколение; первая
+// частица стартует из x0.
+class ParticleSwarm : public AbstrOptim {
+private:
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    size_t swarm_size;
+    double inertia;
+    double cognitive;
+    double social;
+    double velocity_fraction;
+    PopulationOptions populationOptions;
+    simd::LaneRandom rng;
+
+public:
+    ParticleSwarm(const AbstrFunc* f, std::unique_ptr<const AbstrCriterial> c,
+        const std::vector<double>& x0, const std::vector<double>& lb,
+        const std::vector<double>& ub, size_t swarm = 40,
+        double inertia = 0.7298, double cognitive = 1.49618, double social = 1.49618,
+        unsigned int seed = std::random_device{}());
+
+    void setVelocityLimit(double fraction);
+    void setPopulationOptions(const PopulationOptions& options) { populationOptions = options; }
+
+protected:
+    Result run() override;
+};
+
+#endif
@@ -0,0 +1,143 @@
+﻿#include "pch.h"
+#include "PluginFunc.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+
+void* openLibrary(const std::string& path, std::string& error) {
+    HMODULE module = LoadLibraryA(path.c_str());
+    if (!module) {
+        error = "LoadLibrary failed with error " + std::to_string(GetLastError());
+    }
+    return module;
+}
+
+void* findSymbol(void* library, const char* symbol) {
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), symbol));
+}
+
+void closeLibrary(void* library) {
+    FreeLibrary(static_cast<HMODULE>(library));
+}
+
+#else
+
+void* openLibrary(const std::string& path, std::string& error) {
+    void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+        const char* message = dlerror();
+        error = message ? message : "dlopen failed";
+    }
+    return library;
+}
+
+void* findSymbol(void* library, const char* symbol) {
+    return dlsym(library, symbol);
+}
+
+void closeLibrary(void* library) {
+    dlclose(library);
+}
+
+#endif
+
+} // namespace
+
+PluginFunc::PluginFunc(const std::string& libraryPath)
+    : path(libraryPath), library(nullptr), plugin(nullptr) {
+    std::string error;
+    library = openLibrary(path, error);
+    if (!library) {
+        throw std::runtime_error("Cannot load plugin '" + path + "': " + error);
+    }
+
+    // Таблица проверяется до того, как объект станет доступен
+    try {
+        CritPainPluginEntry entry = reinterpret_cast<CritPainPluginEntry>(findSymbol(library, CRITPAIN_PLUGIN_ENTRY));
+        if (!entry) {
+            throw std::runtime_error("Plugin '" + path + "' does not export " CRITPAIN_PLUGIN_ENTRY "()");
+        }
+        plugin = entry();
+        if (!plugin) {
+            throw std::runtime_error("Plugin '" + path + "' returned no function table");
+        }
+        if (plugin->abiVersion != CRITPAIN_PLUGIN_ABI_VERSION) {
+            throw std::runtime_error("Plugin '" + path + "' has ABI version " + std::to_string(plugin->abiVersion) +
+                ", expected " + std::to_string(CRITPAIN_PLUGIN_ABI_VERSION));
+        }
+        if (plugin->dimension <= 0) {
+            throw std::runtime_error("Plugin '" + path + "' reports a non-positive dimension");
+        }
+        if (!plugin->evaluate || !plugin->evaluateBatch) {
+            throw std::runtime_error("Plugin '" + path + "' must provide evaluate and evaluateBatch");
+        }
+    }
+    catch (...) {
+        closeLibrary(library);
+        throw;
+    }
+
+    name = plugin->name ? plugin->name : "Plugin";
+    name += " [" + std::to_string(plugin->dimension) + "D plugin]";
+}
+
+PluginFunc::~PluginFunc() {
+    closeLibrary(library);
+}
+
+void PluginFunc::checkSize(const std::vector<double>& x) const {
+    if (static_cast<int>(x.size()) != plugin->dimension) {
+        throw std::invalid_argument("Plugin function requires exactly " + std::to_string(plugin->dimension) + " dimensions");
+    }
+}
+
+double PluginFunc::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    return plugin->evaluate(x.data());
+}
+
+std::vector<double> PluginFunc::getGradient(const std::vector<double>& x) const {
+    checkSize(x);
+    if (!plugin->gradient) {
+        // Оптимизаторы перехватывают исключение и считают численный градиент
+        throw std::logic_error("Plugin function has no analytic gradient");
+    }
+    std::vector<double> grad(plugin->dimension);
+    plugin->gradient(x.data(), grad.data());
+    return grad;
+}
+
+std::string PluginFunc::getName() const {
+    return name;
+}
+
+int PluginFunc::getDimension() const {
+    return plugin->dimension;
+}
+
+double PluginFunc::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    grad = getGradient(x);
+    return plugin->evaluate(x.data());
+}
+
+void PluginFunc::evaluateBatch(const double* points, size_t count, double* values) const {
+    if (count == 0) return;
+    plugin->evaluateBatch(points, count, values);
+}
+
+void PluginFunc::gradientBatch(const double* points, size_t count, double* grads) const {
+    if (count == 0) return;
+    if (plugin->gradientBatch) {
+        plugin->gradientBatch(points, count, grads);
+        return;
+    }
+    AbstrFunc::gradientBatch(points, count, grads);
+}
@@ -0,0 +1,44 @@
+﻿#ifndef PLUGINFUNC_H
+#define PLUGINFUNC_H
+
+#include "AbstrFunc.h"
+#include "CritPainGPlugin.h"
+#include <string>
+#include <vector>
+
+// Целевая функция из динамической библиотеки (LoadLibrary / dlopen) с C ABI
+// из CritPainGPlugin.h. Новые функции подключаются без пересборки приложения.
+//
+// Пакетные вызовы передаются в evaluateBatch библиотеки целиком, так что
+// переход через границу ABI приходится на пакет, а не на точку.
+// Библиотека выгружается в деструкторе.
+class PluginFunc : public AbstrFunc {
+public:
+    // Ошибки загрузки и проверки таблицы - std::runtime_error
+    explicit PluginFunc(const std::string& path);
+    ~PluginFunc() override;
+
+    PluginFunc(const PluginFunc&) = delete;
+    PluginFunc& operator=(const PluginFunc&) = delete;
+
+    double operator()(const std::vector<double>& x) const override;
+    std::vector<double> getGradient(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    int getDimension() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+
+    bool hasGradient() const { return plugin->gradient != nullptr; }
+    const std::string& getPath() const { return path; }
+
+private:
+    std::string path;
+    void* library;
+    const CritPainPlugin* plugin;
+    std::string name;
+
+    void checkSize(const std::vector<double>& x) const;
+};
+
+#endif
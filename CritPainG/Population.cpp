@@ -0,0 +1,26 @@
+﻿#include "pch.h"
+#include "Population.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <vector>
+
+void evaluatePopulation(const AbstrFunc& f, const double* points, size_t dim, size_t count,
+    double* values, const PopulationOptions& options) {
+    ThreadPool& pool = ThreadPool::shared();
+    if (!options.parallel || count < options.minParallelPoints || pool.size() <= 1 || f.prefersWholeBatch()) {
+        f.evaluateBatch(points, count, values);
+        return;
+    }
+
+    // По одной части на поток: внутри части функция сама векторизует пакет
+    const size_t grain = (count + pool.size() - 1) / pool.size();
+    pool.parallelFor(count, grain, [&](size_t begin, size_t end) {
+        const size_t m = end - begin;
+        std::vector<double> part(dim * m);
+        for (size_t j = 0; j < dim; ++j) {
+            const double* row = points + j * count + begin;
+            std::copy(row, row + m, part.begin() + j * m);
+        }
+        f.evaluateBatch(part.data(), m, values + begin);
+    });
+}
@@ -0,0 +1,24 @@
+﻿#ifndef POPULATION_H
+#define POPULATION_H
+
+#include "AbstrFunc.h"
+#include <cstddef>
+
+// Вычисление поколения популяционных методов (CMA-ES и др.).
+//
+// Точки лежат в раскладке SoA evaluateBatch: j-я координата i-й точки - в
+// points[j * count + i]. При parallel, count >= minParallelPoints и нескольких
+// потоках в ThreadPool::shared() поколение делится на части по числу потоков,
+// каждая часть копируется в свой пакет SoA и уходит в evaluateBatch. Иначе, а
+// также для функций с prefersWholeBatch() весь пакет передаётся функции как
+// есть: ProcessFunc сама раздаёт его своим процессам. Функция должна допускать
+// одновременные вызовы из нескольких потоков, как и для численного градиента.
+struct PopulationOptions {
+    bool parallel = true;
+    size_t minParallelPoints = 16;
+};
+
+void evaluatePopulation(const AbstrFunc& f, const double* points, size_t dim, size_t count,
+    double* values, const PopulationOptions& options = PopulationOptions());
+
+#endif
@@ -0,0 +1,439 @@
+﻿#include "pch.h"
+#include "ProcessFunc.h"
+#include "ProcessProtocol.h"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Платформенная часть: запуск процесса, обмен байтами, остановка
+#ifdef _WIN32
+
+struct Channel {
+    HANDLE process = nullptr;
+    HANDLE input = nullptr;   // запись в stdin процесса
+    HANDLE output = nullptr;  // чтение из stdout процесса
+};
+
+bool startProcess(const std::string& command, Channel& channel, std::string& error) {
+    SECURITY_ATTRIBUTES security = { sizeof(security), nullptr, TRUE };
+    HANDLE childInput = nullptr, childOutput = nullptr;
+    const DWORD bufferSize = 1 << 20;
+    if (!CreatePipe(&childInput, &channel.input, &security, bufferSize)) {
+        error = "CreatePipe failed with error " + std::to_string(GetLastError());
+        return false;
+    }
+    if (!CreatePipe(&channel.output, &childOutput, &security, bufferSize)) {
+        error = "CreatePipe failed with error " + std::to_string(GetLastError());
+        CloseHandle(childInput);
+        CloseHandle(channel.input);
+        return false;
+    }
+    // Родительские концы не наследуются, иначе процесс не увидит закрытия stdin
+    SetHandleInformation(channel.input, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(channel.output, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdInput = childInput;
+    startup.hStdOutput = childOutput;
+    startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    PROCESS_INFORMATION info = {};
+    std::vector<char> commandLine(command.begin(), command.end());
+    commandLine.push_back('\0');
+    BOOL created = CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, TRUE,
+        CREATE_NO_WINDOW, nullptr, nullptr, &startup, &info);
+    DWORD lastError = GetLastError();
+    CloseHandle(childInput);
+    CloseHandle(childOutput);
+    if (!created) {
+        error = "CreateProcess failed with error " + std::to_string(lastError);
+        CloseHandle(channel.input);
+        CloseHandle(channel.output);
+        return false;
+    }
+    CloseHandle(info.hThread);
+    channel.process = info.hProcess;
+    return true;
+}
+
+bool writeAll(Channel& channel, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        DWORD chunk = static_cast<DWORD>((std::min)(size, static_cast<size_t>(1 << 30)));
+        DWORD written = 0;
+        if (!WriteFile(channel.input, bytes, chunk, &written, nullptr) || written == 0) return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool readAll(Channel& channel, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        DWORD chunk = static_cast<DWORD>((std::min)(size, static_cast<size_t>(1 << 30)));
+        DWORD received = 0;
+        if (!ReadFile(channel.output, bytes, chunk, &received, nullptr) || received == 0) return false;
+        bytes += received;
+        size -= received;
+    }
+    return true;
+}
+
+void stopProcess(Channel& channel) {
+    if (channel.input) CloseHandle(channel.input);
+    if (channel.process) {
+        if (WaitForSingleObject(channel.process, 2000) != WAIT_OBJECT_0) {
+            TerminateProcess(channel.process, 1);
+            WaitForSingleObject(channel.process, INFINITE);
+        }
+        CloseHandle(channel.process);
+    }
+    if (channel.output) CloseHandle(channel.output);
+    channel = Channel();
+}
+
+#else
+
+struct Channel {
+    pid_t pid = -1;
+    int socket = -1;  // stdin и stdout процесса
+};
+
+bool startProcess(const std::string& command, Channel& channel, std::string& error) {
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+        error = std::string("socketpair failed: ") + std::strerror(errno);
+        return false;
+    }
+    // Сокет родителя не должен попасть в другие вычислители
+    fcntl(sockets[0], F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(sockets[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        error = std::string("fork failed: ") + std::strerror(errno);
+        close(sockets[0]);
+        close(sockets[1]);
+        return false;
+    }
+    if (pid == 0) {
+        // Между fork и exec допустимы только async-signal-safe вызовы
+        dup2(sockets[1], STDIN_FILENO);
+        dup2(sockets[1], STDOUT_FILENO);
+        if (sockets[1] > STDOUT_FILENO) close(sockets[1]);
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    close(sockets[1]);
+    channel.pid = pid;
+    channel.socket = sockets[0];
+    return true;
+}
+
+bool writeAll(Channel& channel, const void* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = send(channel.socket, bytes, size, flags);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool readAll(Channel& channel, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t received = recv(channel.socket, bytes, size, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+void stopProcess(Channel& channel) {
+    if (channel.socket >= 0) close(channel.socket);
+    if (channel.pid > 0) {
+        // Закрытие сокета - сигнал завершения; зависший процесс снимается
+        int status = 0;
+        bool exited = false;
+        for (int i = 0; i < 200 && !exited; ++i) {
+            pid_t result = waitpid(channel.pid, &status, WNOHANG);
+            exited = result == channel.pid || (result < 0 && errno != EINTR);
+            if (!exited) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!exited) {
+            kill(channel.pid, SIGKILL);
+            while (waitpid(channel.pid, &status, 0) < 0 && errno == EINTR) {}
+        }
+    }
+    channel = Channel();
+}
+
+#endif
+
+// Запрос в пути: какие точки пакета он несёт
+struct InFlight {
+    size_t worker;
+    uint32_t sequence;
+    size_t offset;
+    size_t count;
+};
+
+} // namespace
+
+struct ProcessFunc::Worker {
+    std::mutex mutex;
+    Channel channel;
+    uint32_t sequence = 0;
+    bool alive = false;
+    std::vector<double> buffer;
+    std::vector<char> errorText;
+
+    ~Worker() {
+        if (alive) stopProcess(channel);
+    }
+
+    void fail() {
+        stopProcess(channel);
+        alive = false;
+    }
+
+    // Отправляет точки [offset, offset + n) пакета SoA из count точек
+    bool send(const double* points, size_t count, size_t offset, size_t n, int dimension, uint32_t& sent) {
+        buffer.resize(n * dimension);
+        for (size_t i = 0; i < n; ++i) {
+            for (int j = 0; j < dimension; ++j) {
+                buffer[i * dimension + j] = points[j * count + offset + i];
+            }
+        }
+        process_protocol::RequestHeader header = { sequence, static_cast<uint32_t>(n) };
+        if (!writeAll(channel, &header, sizeof(header)) ||
+            !writeAll(channel, buffer.data(), buffer.size() * sizeof(double))) {
+            return false;
+        }
+        sent = sequence++;
+        return true;
+    }
+
+    // Читает ответ на запрос sequence из n точек. false - канал оборван или
+    // поток нарушен; ошибка вычислителя возвращается в message
+    bool receive(uint32_t expected, size_t n, double* values, std::string& message) {
+        process_protocol::ResponseHeader header;
+        if (!readAll(channel, &header, sizeof(header)) || header.sequence != expected) return false;
+        if (header.status == process_protocol::Ok) {
+            return header.count == n && readAll(channel, values, n * sizeof(double));
+        }
+        if (header.status != process_protocol::Error || header.count > process_protocol::MAX_ERROR_LENGTH) return false;
+        errorText.resize(header.count);
+        if (header.count > 0 && !readAll(channel, errorText.data(), header.count)) return false;
+        message.assign(errorText.begin(), errorText.end());
+        if (message.empty()) message = "unknown error";
+        return true;
+    }
+};
+
+ProcessFunc::ProcessFunc(const std::string& command_, const ProcessPoolOptions& options_)
+    : command(command_), options(options_), dimension(0), nextWorker(0) {
+    if (command.empty()) {
+        throw std::invalid_argument("Process command must not be empty");
+    }
+    if (options.workers < 0 || options.depth < 1 || options.maxPointsPerRequest < 1 ||
+        options.maxPointsPerRequest > process_protocol::MAX_POINTS_PER_REQUEST) {
+        throw std::invalid_argument("Invalid process pool options");
+    }
+    int count = options.workers;
+    if (count == 0) {
+        count = static_cast<int>((std::max)(1u, std::thread::hardware_concurrency()));
+    }
+
+    // Если процесс не стартовал, уже запущенные останавливает деструктор Worker
+    for (int w = 0; w < count; ++w) {
+        std::unique_ptr<Worker> worker(new Worker());
+        std::string error;
+        if (!startProcess(command, worker->channel, error)) {
+            throw std::runtime_error("Cannot start '" + command + "': " + error);
+        }
+        worker->alive = true;
+
+        process_protocol::Hello hello;
+        if (!readAll(worker->channel, &hello, sizeof(hello)) || hello.magic != process_protocol::MAGIC) {
+            throw std::runtime_error("Process '" + command + "' did not answer with a valid handshake");
+        }
+        if (hello.dimension == 0 || hello.dimension > 1000000) {
+            throw std::runtime_error("Process '" + command + "' reports an invalid dimension");
+        }
+        if (dimension == 0) {
+            dimension = static_cast<int>(hello.dimension);
+        }
+        else if (dimension != static_cast<int>(hello.dimension)) {
+            throw std::runtime_error("Processes of '" + command + "' report different dimensions");
+        }
+        workers.push_back(std::move(worker));
+    }
+}
+
+ProcessFunc::~ProcessFunc() = default;
+
+double ProcessFunc::operator()(const std::vector<double>& x) const {
+    if (static_cast<int>(x.size()) != dimension) {
+        throw std::invalid_argument("Process function requires exactly " + std::to_string(dimension) + " dimensions");
+    }
+
+    // Свободный процесс, иначе ожидание очередного по кругу
+    const size_t n = workers.size();
+    const size_t start = nextWorker.fetch_add(1, std::memory_order_relaxed) % n;
+    std::unique_lock<std::mutex> lock;
+    Worker* worker = nullptr;
+    for (size_t k = 0; k < n && !worker; ++k) {
+        Worker& candidate = *workers[(start + k) % n];
+        std::unique_lock<std::mutex> attempt(candidate.mutex, std::try_to_lock);
+        if (attempt.owns_lock() && candidate.alive) {
+            lock = std::move(attempt);
+            worker = &candidate;
+        }
+    }
+    for (size_t k = 0; k < n && !worker; ++k) {
+        Worker& candidate = *workers[(start + k) % n];
+        std::unique_lock<std::mutex> attempt(candidate.mutex);
+        if (candidate.alive) {
+            lock = std::move(attempt);
+            worker = &candidate;
+        }
+    }
+    if (!worker) {
+        throw std::runtime_error("All processes of '" + command + "' have failed");
+    }
+
+    double value = 0.0;
+    uint32_t sequence = 0;
+    std::string message;
+    if (!worker->send(x.data(), 1, 0, 1, dimension, sequence) ||
+        !worker->receive(sequence, 1, &value, message)) {
+        worker->fail();
+        throw std::runtime_error("Process of '" + command + "' terminated or broke the protocol");
+    }
+    if (!message.empty()) {
+        throw std::runtime_error("Process of '" + command + "' failed: " + message);
+    }
+    return value;
+}
+
+std::vector<double> ProcessFunc::getGradient(const std::vector<double>&) const {
+    // Оптимизаторы перехватывают исключение и считают численный градиент пакетом
+    throw std::logic_error("Process function has no analytic gradient");
+}
+
+std::string ProcessFunc::getName() const {
+    return "Process: " + command + " [" + std::to_string(dimension) + "D]";
+}
+
+int ProcessFunc::getDimension() const {
+    return dimension;
+}
+
+int ProcessFunc::workerCount() const {
+    int alive = 0;
+    for (const auto& worker : workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (worker->alive) ++alive;
+    }
+    return alive;
+}
+
+void ProcessFunc::evaluateBatch(const double* points, size_t count, double* values) const {
+    if (count == 0) return;
+
+    // Пакет занимает весь пул; порядок захвата один, взаимных блокировок нет
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(workers.size());
+    std::vector<size_t> live;
+    for (size_t w = 0; w < workers.size(); ++w) {
+        locks.emplace_back(workers[w]->mutex);
+        if (workers[w]->alive) live.push_back(w);
+    }
+    if (live.empty()) {
+        throw std::runtime_error("All processes of '" + command + "' have failed");
+    }
+
+    // Запросы мельче пакета, чтобы у каждого процесса было depth запросов
+    const size_t slots = live.size() * static_cast<size_t>(options.depth);
+    const size_t chunk = (std::max)(static_cast<size_t>(1),
+        (std::min)(options.maxPointsPerRequest, (count + slots - 1) / slots));
+
+    std::deque<InFlight> queue;
+    size_t next = 0;
+    std::string failure;
+    std::string message;
+
+    auto post = [&](size_t w) {
+        size_t n = (std::min)(chunk, count - next);
+        uint32_t sequence = 0;
+        if (!workers[w]->send(points, count, next, n, dimension, sequence)) {
+            workers[w]->fail();
+            failure = "Process of '" + command + "' terminated or broke the protocol";
+            return;
+        }
+        queue.push_back({ w, sequence, next, n });
+        next += n;
+    };
+
+    for (int d = 0; d < options.depth && failure.empty(); ++d) {
+        for (size_t k = 0; k < live.size() && next < count && failure.empty(); ++k) {
+            post(live[k]);
+        }
+    }
+
+    // Ответы по порядку отправки; освободившийся процесс сразу получает новый
+    // запрос. После сбоя новых запросов нет, ответы ушедших дочитываются,
+    // чтобы каналы остались синхронными
+    while (!queue.empty()) {
+        InFlight request = queue.front();
+        queue.pop_front();
+        Worker& worker = *workers[request.worker];
+        if (!worker.alive) continue;
+        std::string error;
+        if (!worker.receive(request.sequence, request.count, values + request.offset, error)) {
+            worker.fail();
+            if (failure.empty()) failure = "Process of '" + command + "' terminated or broke the protocol";
+            continue;
+        }
+        if (!error.empty() && message.empty()) message = error;
+        if (failure.empty() && message.empty() && next < count) post(request.worker);
+    }
+
+    if (!failure.empty()) throw std::runtime_error(failure);
+    if (!message.empty()) throw std::runtime_error("Process of '" + command + "' failed: " + message);
+}
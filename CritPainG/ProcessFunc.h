@@ -0,0 +1,67 @@
+﻿#ifndef PROCESSFUNC_H
+#define PROCESSFUNC_H
+
+#include "AbstrFunc.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Целевая функция, вычисляемая внешними процессами (например, симуляторами,
+// которые нельзя вызывать из нескольких потоков одного процесса).
+//
+// Конструктор запускает пул процессов командой command; каждый процесс говорит
+// по протоколу ProcessProtocol.h через свои stdin/stdout (на POSIX - сокет
+// Unix, на Windows - анонимные каналы). Вычислитель пишется на основе
+// serveProcessWorker (ProcessWorker.h) или реализует протокол сам.
+//
+// evaluateBatch делит пакет на запросы и держит в очереди каждого процесса до
+// depth запросов: пока процесс считает один запрос, следующий уже лежит в
+// канале, так что процессы не простаивают на обмене. Ответы читаются в порядке
+// отправки, освободившийся процесс сразу получает новый запрос.
+//
+// Градиента нет: оптимизаторы считают численный, и его точки уходят в пул одним
+// пакетом (prefersWholeBatch: численный градиент и evaluatePopulation не делят
+// пакет по потокам). Одновременные вызовы из нескольких потоков допустимы: скалярный
+// вызов занимает один свободный процесс, пакет - все.
+struct ProcessPoolOptions {
+    int workers = 0;                  // 0 - по числу ядер
+    int depth = 2;                    // запросов в очереди одного процесса
+    size_t maxPointsPerRequest = 64;  // пакет делится не крупнее
+};
+
+class ProcessFunc : public AbstrFunc {
+public:
+    // Ошибки запуска и приветствия - std::runtime_error
+    explicit ProcessFunc(const std::string& command, const ProcessPoolOptions& options = ProcessPoolOptions());
+    ~ProcessFunc() override;
+
+    ProcessFunc(const ProcessFunc&) = delete;
+    ProcessFunc& operator=(const ProcessFunc&) = delete;
+
+    double operator()(const std::vector<double>& x) const override;
+    std::vector<double> getGradient(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    int getDimension() const override;
+    // Ошибка вычислителя или обрыв канала - std::runtime_error; упавший процесс
+    // исключается из пула
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    // Пакет делится между процессами здесь; деление по потокам только
+    // выстроило бы части в очередь к занятому пулу
+    bool prefersWholeBatch() const override { return true; }
+
+    // Число работающих процессов
+    int workerCount() const;
+
+private:
+    struct Worker;
+
+    std::string command;
+    ProcessPoolOptions options;
+    int dimension;
+    std::vector<std::unique_ptr<Worker>> workers;
+    mutable std::atomic<unsigned> nextWorker;
+};
+
+#endif
@@ -0,0 +1,51 @@
+﻿#ifndef PROCESSPROTOCOL_H
+#define PROCESSPROTOCOL_H
+
+#include <cstdint>
+
+// Двоичный протокол между ProcessFunc и процессом-вычислителем (ProcessWorker.h).
+// Канал - stdin/stdout вычислителя; числа в порядке байт машины, обе стороны
+// работают на одном компьютере.
+//
+//   вычислитель -> ProcessFunc: Hello при запуске
+//   ProcessFunc -> вычислитель: RequestHeader, затем count * dimension double
+//                               (точки подряд, координаты точки подряд)
+//   вычислитель -> ProcessFunc: ResponseHeader, затем
+//                               Ok:    count double - значения в порядке точек
+//                               Error: count байт - текст ошибки
+//
+// Запросы обрабатываются строго по очереди, поэтому ответы приходят в порядке
+// запросов, и sequence служит только для проверки. Закрытие stdin означает
+// завершение работы.
+namespace process_protocol {
+
+const uint32_t MAGIC = 0x31575043;  // "CPW1"
+
+struct Hello {
+    uint32_t magic;
+    uint32_t dimension;
+};
+
+struct RequestHeader {
+    uint32_t sequence;
+    uint32_t count;
+};
+
+enum Status : uint32_t {
+    Ok = 0,
+    Error = 1
+};
+
+struct ResponseHeader {
+    uint32_t sequence;
+    uint32_t status;
+    uint32_t count;
+};
+
+// Защита от повреждённого потока
+const uint32_t MAX_POINTS_PER_REQUEST = 1u << 20;
+const uint32_t MAX_ERROR_LENGTH = 1u << 16;
+
+} // namespace process_protocol
+
+#endif
@@ -0,0 +1,85 @@
+﻿#include "pch.h"
+#include "ProcessWorker.h"
+#include "ProcessProtocol.h"
+#include <exception>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+bool readAll(std::FILE* input, void* data, size_t size) {
+    return std::fread(data, 1, size, input) == size;
+}
+
+bool writeAll(std::FILE* output, const void* data, size_t size) {
+    return std::fwrite(data, 1, size, output) == size;
+}
+
+} // namespace
+
+int serveProcessWorker(const AbstrFunc& f) {
+#ifdef _WIN32
+    // Текстовый режим испортил бы двоичные данные
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    return serveProcessWorker(f, stdin, stdout);
+}
+
+int serveProcessWorker(const AbstrFunc& f, std::FILE* input, std::FILE* output) {
+    using namespace process_protocol;
+
+    const size_t dimension = static_cast<size_t>(f.getDimension());
+    Hello hello = { MAGIC, static_cast<uint32_t>(dimension) };
+    if (!writeAll(output, &hello, sizeof(hello)) || std::fflush(output) != 0) return 1;
+
+    std::vector<double> aos, soa, values;
+    RequestHeader request;
+    while (readAll(input, &request, sizeof(request))) {
+        if (request.count == 0 || request.count > MAX_POINTS_PER_REQUEST) return 1;
+        const size_t count = request.count;
+        aos.resize(count * dimension);
+        if (!readAll(input, aos.data(), aos.size() * sizeof(double))) return 1;
+
+        // Протокол передаёт точки подряд, evaluateBatch ждёт SoA
+        soa.resize(aos.size());
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < dimension; ++j) {
+                soa[j * count + i] = aos[i * dimension + j];
+            }
+        }
+
+        values.resize(count);
+        std::string error;
+        try {
+            f.evaluateBatch(soa.data(), count, values.data());
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+        }
+        catch (...) {
+            error = "unknown exception";
+        }
+
+        bool written;
+        if (error.empty()) {
+            ResponseHeader response = { request.sequence, Ok, request.count };
+            written = writeAll(output, &response, sizeof(response)) &&
+                writeAll(output, values.data(), count * sizeof(double));
+        }
+        else {
+            if (error.size() > MAX_ERROR_LENGTH) error.resize(MAX_ERROR_LENGTH);
+            if (error.empty()) error = "error";
+            ResponseHeader response = { request.sequence, Error, static_cast<uint32_t>(error.size()) };
+            written = writeAll(output, &response, sizeof(response)) &&
+                writeAll(output, error.data(), error.size());
+        }
+        if (!written || std::fflush(output) != 0) return 1;
+    }
+    return std::feof(input) ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+﻿#ifndef PROCESSWORKER_H
+#define PROCESSWORKER_H
+
+#include "AbstrFunc.h"
+#include <cstdio>
+
+// Сторона вычислителя для ProcessFunc: отдельная программа оборачивает свою
+// функцию и отдаёт управление циклу обслуживания. Пример:
+//
+//     #include "ProcessWorker.h"
+//     #include "TestFunctions.h"
+//
+//     int main() {
+//         RosenbrockFuncND f(10);
+//         return serveProcessWorker(f);
+//     }
+//
+// Готовый вычислитель этого вида - Tests/RosenbrockWorker (на нём проверяется
+// ProcessFunc в Tests/CritPainGTests).
+//
+// Запросы обрабатываются по одному через f.evaluateBatch; исключение функции
+// уходит родителю как ошибка запроса, и процесс продолжает работу. Возврат -
+// код завершения: 0 после закрытия входа, 1 при нарушении протокола.
+int serveProcessWorker(const AbstrFunc& f);
+int serveProcessWorker(const AbstrFunc& f, std::FILE* input, std::FILE* output);
+
+#endif
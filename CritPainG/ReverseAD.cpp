@@ -0,0 +1,48 @@
+﻿#include "pch.h"
+#include "ReverseAD.h"
+#include <deque>
+
+namespace rad {
+
+const int Tape::BLOCK_SHIFT;
+const size_t Tape::BLOCK_SIZE;
+
+void Tape::gradient(int output, int nInputs, double* grad) {
+    for (int j = 0; j < nInputs; ++j) {
+        grad[j] = 0.0;
+    }
+    // Результат не зависит от входов (константа)
+    if (output < 0) {
+        return;
+    }
+
+    // assign не перевыделяет память, пока хватает ёмкости
+    adjoints.assign(static_cast<size_t>(output) + 1, 0.0);
+    adjoints[output] = 1.0;
+
+    for (int i = output; i >= nInputs; --i) {
+        const double adj = adjoints[i];
+        if (adj == 0.0) {
+            continue;
+        }
+        const Node& n = blocks[static_cast<size_t>(i) >> BLOCK_SHIFT][static_cast<size_t>(i) & (BLOCK_SIZE - 1)];
+        if (n.a >= 0) adjoints[n.a] += n.da * adj;
+        if (n.b >= 0) adjoints[n.b] += n.db * adj;
+    }
+
+    const int last = output < nInputs ? output + 1 : nInputs;
+    for (int j = 0; j < last; ++j) {
+        grad[j] = adjoints[j];
+    }
+}
+
+Tape& Tape::threadLocal(size_t depth) {
+    // deque не перемещает уже созданные ленты при росте
+    static thread_local std::deque<Tape> tapes;
+    while (tapes.size() <= depth) {
+        tapes.emplace_back();
+    }
+    return tapes[depth];
+}
+
+} // namespace rad
@@ -0,0 +1,282 @@
+﻿#ifndef REVERSEAD_H
+#define REVERSEAD_H
+
+#include "AbstrFunc.h"
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Автоматическое дифференцирование обратным ходом.
+//
+// Функция записывается тем же шаблоном, что и для ForwardAD.h:
+//     template <class T> T operator()(const T* x, int n) const;
+// При T = rad::Var каждая операция записывается на ленту (Tape), после чего
+// один обратный проход даёт весь градиент. Стоимость градиента - небольшое
+// постоянное число вычислений функции независимо от N, поэтому этот путь
+// предназначен для задач с 10^4..10^6 переменных.
+//
+// Лента хранится в арене из блоков фиксированного размера: reset() только
+// обнуляет счётчик, поэтому после первой итерации оптимизатора новых
+// выделений памяти нет.
+//
+// Вложенная запись (функтор сам вызывает valueAndGradient другой TapedFunction)
+// идёт на следующую ленту потока и не стирает внешнюю; внешняя запись видит
+// результат вложенной как константу.
+namespace rad {
+
+// Узел ленты: до двух родителей и частные производные по ним
+struct Node {
+    int a;
+    int b;
+    double da;
+    double db;
+};
+
+class Tape {
+public:
+    static const int BLOCK_SHIFT = 16;
+    static const size_t BLOCK_SIZE = size_t(1) << BLOCK_SHIFT;
+
+    Tape() : count(0) {}
+    Tape(const Tape&) = delete;
+    Tape& operator=(const Tape&) = delete;
+
+    // Записать узел; -1 означает отсутствие родителя
+    int push(int a, double da, int b, double db) {
+        if (count == blocks.size() * BLOCK_SIZE) {
+            blocks.emplace_back(new Node[BLOCK_SIZE]);
+        }
+        Node& n = blocks[count >> BLOCK_SHIFT][count & (BLOCK_SIZE - 1)];
+        n.a = a;
+        n.da = da;
+        n.b = b;
+        n.db = db;
+        return static_cast<int>(count++);
+    }
+
+    // Очистить ленту, сохранив выделенные блоки
+    void reset() { count = 0; }
+    size_t size() const { return count; }
+    size_t capacity() const { return blocks.size() * BLOCK_SIZE; }
+
+    // Обратный проход от узла output; первые nInputs узлов - входные переменные.
+    // Градиент записывается в grad[0..nInputs).
+    void gradient(int output, int nInputs, double* grad);
+
+    // Лента текущего потока для уровня вложенности depth (0 - внешний вызов).
+    // Используется TapedFunction, переиспользуется между вызовами
+    static Tape& threadLocal(size_t depth);
+
+    // Лента, на которую сейчас записываются операции с Var
+    static Tape*& active() {
+        static thread_local Tape* tape = nullptr;
+        return tape;
+    }
+
+private:
+    std::vector<std::unique_ptr<Node[]>> blocks;
+    size_t count;
+    std::vector<double> adjoints;
+};
+
+// Делает ленту активной на время жизни объекта
+class ActiveTape {
+public:
+    explicit ActiveTape(Tape& tape) : previous(Tape::active()) { Tape::active() = &tape; }
+    ~ActiveTape() { Tape::active() = previous; }
+    ActiveTape(const ActiveTape&) = delete;
+    ActiveTape& operator=(const ActiveTape&) = delete;
+private:
+    Tape* previous;
+};
+
+// Очищенная лента текущего потока, активная на время жизни объекта. Каждый
+// уровень вложенности получает свою ленту
+class ScopedTape {
+public:
+    ScopedTape() : level(depth()), tape(Tape::threadLocal(level)), guard(tape) {
+        tape.reset();
+        ++depth();
+    }
+    ~ScopedTape() { --depth(); }
+    ScopedTape(const ScopedTape&) = delete;
+    ScopedTape& operator=(const ScopedTape&) = delete;
+
+    const size_t level;
+    Tape& tape;
+
+private:
+    ActiveTape guard;
+
+    static size_t& depth() {
+        static thread_local size_t d = 0;
+        return d;
+    }
+};
+
+// Переменная на ленте. Константы (index == -1) на ленту не попадают.
+class Var {
+public:
+    Var() : v(0.0), index(-1) {}
+    Var(double value) : v(value), index(-1) {}
+
+    // Новая входная переменная на активной ленте
+    static Var input(double value) { return Var(value, Tape::active()->push(-1, 0.0, -1, 0.0)); }
+
+    double value() const { return v; }
+    int node() const { return index; }
+
+    Var& operator+=(const Var& b) { *this = *this + b; return *this; }
+    Var& operator-=(const Var& b) { *this = *this - b; return *this; }
+    Var& operator*=(const Var& b) { *this = *this * b; return *this; }
+    Var& operator/=(const Var& b) { *this = *this / b; return *this; }
+
+    friend Var operator+(const Var& a, const Var& b) { return binary(a.v + b.v, a, 1.0, b, 1.0); }
+    friend Var operator-(const Var& a, const Var& b) { return binary(a.v - b.v, a, 1.0, b, -1.0); }
+    friend Var operator*(const Var& a, const Var& b) { return binary(a.v * b.v, a, b.v, b, a.v); }
+    friend Var operator/(const Var& a, const Var& b) {
+        const double inv = 1.0 / b.v;
+        const double q = a.v * inv;
+        return binary(q, a, inv, b, -q * inv);
+    }
+    friend Var operator-(const Var& a) { return a.unary(-a.v, -1.0); }
+    friend Var operator+(const Var& a) { return a; }
+
+    friend Var operator+(const Var& a, double b) { return a.unary(a.v + b, 1.0); }
+    friend Var operator+(double a, const Var& b) { return b.unary(a + b.v, 1.0); }
+    friend Var operator-(const Var& a, double b) { return a.unary(a.v - b, 1.0); }
+    friend Var operator-(double a, const Var& b) { return b.unary(a - b.v, -1.0); }
+    friend Var operator*(const Var& a, double b) { return a.unary(a.v * b, b); }
+    friend Var operator*(double a, const Var& b) { return b.unary(a * b.v, a); }
+    friend Var operator/(const Var& a, double b) { return a.unary(a.v / b, 1.0 / b); }
+    friend Var operator/(double a, const Var& b) { const double q = a / b.v; return b.unary(q, -q / b.v); }
+
+    friend bool operator<(const Var& a, const Var& b) { return a.v < b.v; }
+    friend bool operator>(const Var& a, const Var& b) { return a.v > b.v; }
+    friend bool operator<=(const Var& a, const Var& b) { return a.v <= b.v; }
+    friend bool operator>=(const Var& a, const Var& b) { return a.v >= b.v; }
+    friend bool operator==(const Var& a, const Var& b) { return a.v == b.v; }
+    friend bool operator!=(const Var& a, const Var& b) { return a.v != b.v; }
+
+    friend Var sin(const Var& a) { return a.unary(std::sin(a.v), std::cos(a.v)); }
+    friend Var cos(const Var& a) { return a.unary(std::cos(a.v), -std::sin(a.v)); }
+    friend Var tan(const Var& a) { const double t = std::tan(a.v); return a.unary(t, 1.0 + t * t); }
+    friend Var exp(const Var& a) { const double e = std::exp(a.v); return a.unary(e, e); }
+    friend Var log(const Var& a) { return a.unary(std::log(a.v), 1.0 / a.v); }
+    friend Var sqrt(const Var& a) { const double s = std::sqrt(a.v); return a.unary(s, 0.5 / s); }
+    friend Var atan(const Var& a) { return a.unary(std::atan(a.v), 1.0 / (1.0 + a.v * a.v)); }
+    friend Var tanh(const Var& a) { const double t = std::tanh(a.v); return a.unary(t, 1.0 - t * t); }
+    friend Var abs(const Var& a) { return a.unary(std::abs(a.v), a.v < 0.0 ? -1.0 : 1.0); }
+    friend Var fabs(const Var& a) { return abs(a); }
+
+    friend Var pow(const Var& a, double p) {
+        return a.unary(std::pow(a.v, p), p == 0.0 ? 0.0 : p * std::pow(a.v, p - 1.0));
+    }
+    friend Var pow(const Var& a, const Var& b) {
+        const double r = std::pow(a.v, b.v);
+        const double da = b.v == 0.0 ? 0.0 : b.v * std::pow(a.v, b.v - 1.0);
+        const double db = a.v > 0.0 ? r * std::log(a.v) : 0.0;
+        return binary(r, a, da, b, db);
+    }
+    friend Var pow(double a, const Var& b) {
+        const double r = std::pow(a, b.v);
+        return b.unary(r, r * std::log(a));
+    }
+
+private:
+    double v;
+    int index;
+
+    Var(double value, int node) : v(value), index(node) {}
+
+    Var unary(double value, double d) const {
+        if (index < 0) return Var(value);
+        return Var(value, Tape::active()->push(index, d, -1, 0.0));
+    }
+
+    static Var binary(double value, const Var& a, double da, const Var& b, double db) {
+        if (a.index < 0 && b.index < 0) return Var(value);
+        return Var(value, Tape::active()->push(a.index, da, b.index, db));
+    }
+};
+
+inline double valueOf(const Var& a) { return a.value(); }
+
+} // namespace rad
+
+// Адаптер: шаблонный функтор F -> AbstrFunc с градиентом обратным ходом.
+// Вычисления значения (T = double) ленту не используют.
+template <class F>
+class TapedFunction : public AbstrFunc {
+private:
+    F func;
+    int dimension;
+    std::string name;
+
+    void checkSize(const std::vector<double>& x) const {
+        if (static_cast<int>(x.size()) != dimension) {
+            throw std::invalid_argument(name + " requires exactly " + std::to_string(dimension) + " dimensions");
+        }
+    }
+
+public:
+    TapedFunction(F f, int dim, std::string funcName)
+        : func(std::move(f)), dimension(dim), name(std::move(funcName)) {
+        if (dim <= 0) {
+            throw std::invalid_argument("Dimension must be positive.");
+        }
+    }
+
+    double operator()(const std::vector<double>& x) const override {
+        checkSize(x);
+        return func(x.data(), dimension);
+    }
+
+    std::vector<double> getGradient(const std::vector<double>& x) const override {
+        std::vector<double> grad;
+        valueAndGradient(x, grad);
+        return grad;
+    }
+
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override {
+        checkSize(x);
+        rad::ScopedTape scope;
+
+        // Буферы аргументов тоже переиспользуются между вызовами, по одному на
+        // уровень вложенности; deque не перемещает их при росте
+        static thread_local std::deque<std::vector<rad::Var>> argStack;
+        while (argStack.size() <= scope.level) {
+            argStack.emplace_back();
+        }
+        std::vector<rad::Var>& args = argStack[scope.level];
+        args.resize(dimension);
+        for (int j = 0; j < dimension; ++j) {
+            args[j] = rad::Var::input(x[j]);
+        }
+
+        rad::Var r = func(args.data(), dimension);
+        grad.resize(dimension);
+        scope.tape.gradient(r.node(), dimension, grad.data());
+        return r.value();
+    }
+
+    std::string getName() const override { return name; }
+    int getDimension() const override { return dimension; }
+
+    template <class T>
+    T evaluate(const T* x) const { return func(x, dimension); }
+
+    const F& functor() const { return func; }
+};
+
+template <class F>
+TapedFunction<F> makeTapedFunction(F f, int dim, std::string name) {
+    return TapedFunction<F>(std::move(f), dim, std::move(name));
+}
+
+#endif
@@ -0,0 +1,1034 @@
+﻿#include "pch.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC разрешает интринсики AVX в любой единице трансляции
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#else
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,fma")))
+#endif
+#endif
+
+namespace simd {
+
+namespace {
+
+const double TWO_PI = 6.28318530717958647693;
+
+// Коэффициенты минимаксных многочленов для |t| <= pi/4 (Cephes)
+const double SIN_COEF[6] = {
+     1.58962301576546568060E-10,
+    -2.50507477628578072866E-8,
+     2.75573136213857245213E-6,
+    -1.98412698295895385996E-4,
+     8.33333333332211858878E-3,
+    -1.66666666666666307295E-1
+};
+
+const double COS_COEF[6] = {
+    -1.13585365213876817300E-11,
+     2.08757008419747316778E-9,
+    -2.75573141792967388112E-7,
+     2.48015872888517045348E-5,
+    -1.38888888888730564116E-3,
+     4.16666666666665929218E-2
+};
+
+// ---------------------------------------------------------------------------
+// Скалярная реализация (запасной вариант и обработка хвостов пакетов)
+// ---------------------------------------------------------------------------
+
+inline void sincos2piScalar(double x, double& s, double& c) {
+    double r = x - std::nearbyint(x);         // точно, r в [-0.5, 0.5]
+    double q = std::nearbyint(4.0 * r);       // номер четверти: -2..2
+    double t = (r - 0.25 * q) * TWO_PI;       // |t| <= pi/4
+    double z = t * t;
+
+    double ps = SIN_COEF[0];
+    double pc = COS_COEF[0];
+    for (int k = 1; k < 6; ++k) {
+        ps = ps * z + SIN_COEF[k];
+        pc = pc * z + COS_COEF[k];
+    }
+    double sv = t + t * z * ps;
+    double cv = 1.0 - 0.5 * z + z * z * pc;
+
+    int qm = static_cast<int>(q) & 3;
+    switch (qm) {
+    case 0: s = sv;  c = cv;  break;
+    case 1: s = cv;  c = -sv; break;
+    case 2: s = -sv; c = -cv; break;
+    default: s = -cv; c = sv; break;
+    }
+}
+
+void sincos2piScalarLoop(const double* x, size_t n, double* s, double* c) {
+    for (size_t i = 0; i < n; ++i) {
+        sincos2piScalar(x[i], s[i], c[i]);
+    }
+}
+
+void sumOfSquaresScalar(const double* points, size_t count, int dim, const double* center, double* values) {
+    for (size_t i = 0; i < count; ++i) values[i] = 0.0;
+    for (int j = 0; j < dim; ++j) {
+        const double* xs = points + static_cast<size_t>(j) * count;
+        const double cj = center ? center[j] : 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double d = xs[i] - cj;
+            values[i] += d * d;
+        }
+    }
+}
+
+void sumOfSquaresGradientScalar(const double* points, size_t count, int dim, const double* center, double* grads) {
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        const double cj = center ? center[j] : 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            grads[offset + i] = 2.0 * (points[offset + i] - cj);
+        }
+    }
+}
+
+void rastriginScalar(const double* points, size_t count, int dim, double A, double* values) {
+    for (size_t i = 0; i < count; ++i) values[i] = A * dim;
+    for (int j = 0; j < dim; ++j) {
+        const double* xs = points + static_cast<size_t>(j) * count;
+        for (size_t i = 0; i < count; ++i) {
+            double s, c;
+            sincos2piScalar(xs[i], s, c);
+            values[i] += xs[i] * xs[i] - A * c;
+        }
+    }
+}
+
+void rastriginGradientScalar(const double* points, size_t count, int dim, double A, double* grads) {
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        for (size_t i = 0; i < count; ++i) {
+            double s, c;
+            sincos2piScalar(points[offset + i], s, c);
+            grads[offset + i] = 2.0 * points[offset + i] + TWO_PI * A * s;
+        }
+    }
+}
+
+// Градиент Розенброка по координате j (соседи x_{j-1}, x_{j+1} в той же точке)
+inline double rosenbrockPartial(double prev, double x, double next, bool hasPrev, bool hasNext) {
+    double g = 0.0;
+    if (hasNext) g += -400.0 * x * (next - x * x) - 2.0 * (1.0 - x);
+    if (hasPrev) g += 200.0 * (x - prev * prev);
+    return g;
+}
+
+void rosenbrockScalar(const double* points, size_t count, int dim, double* values) {
+    for (size_t i = 0; i < count; ++i) values[i] = 0.0;
+    for (int j = 0; j + 1 < dim; ++j) {
+        const double* xs = points + static_cast<size_t>(j) * count;
+        const double* ys = xs + count;
+        for (size_t i = 0; i < count; ++i) {
+            double t = ys[i] - xs[i] * xs[i];
+            double u = 1.0 - xs[i];
+            values[i] += 100.0 * t * t + u * u;
+        }
+    }
+}
+
+void rosenbrockGradientScalar(const double* points, size_t count, int dim, double* grads) {
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        const bool hasPrev = j > 0;
+        const bool hasNext = j + 1 < dim;
+        for (size_t i = 0; i < count; ++i) {
+            grads[offset + i] = rosenbrockPartial(
+                hasPrev ? points[offset - count + i] : 0.0, points[offset + i],
+                hasNext ? points[offset + count + i] : 0.0, hasPrev, hasNext);
+        }
+    }
+}
+
+void styblinskiTangScalar(const double* points, size_t count, int dim, double* values) {
+    for (size_t i = 0; i < count; ++i) values[i] = 0.0;
+    for (int j = 0; j < dim; ++j) {
+        const double* xs = points + static_cast<size_t>(j) * count;
+        for (size_t i = 0; i < count; ++i) {
+            double x = xs[i];
+            double x2 = x * x;
+            values[i] += 0.5 * (x2 * x2 - 16.0 * x2 + 5.0 * x);
+        }
+    }
+}
+
+void styblinskiTangGradientScalar(const double* points, size_t count, int dim, double* grads) {
+    const size_t total = static_cast<size_t>(dim) * count;
+    for (size_t k = 0; k < total; ++k) {
+        double x = points[k];
+        grads[k] = 2.0 * x * x * x - 16.0 * x + 2.5;
+    }
+}
+
+// Генератор дорожек: xoshiro256+, в мантиссу идут 52 старших бита
+
+inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+inline double bitsToUniform(uint64_t bits) {
+    const uint64_t u = (bits >> 12) | 0x3FF0000000000000ULL;  // [1, 2)
+    double d;
+    std::memcpy(&d, &u, sizeof d);
+    return d - 1.0;
+}
+
+inline double nextUniformScalar(LaneRandom& rng, int lane) {
+    uint64_t& s0 = rng.state[0][lane];
+    uint64_t& s1 = rng.state[1][lane];
+    uint64_t& s2 = rng.state[2][lane];
+    uint64_t& s3 = rng.state[3][lane];
+    const uint64_t result = s0 + s3;
+    const uint64_t t = s1 << 17;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = rotl64(s3, 45);
+    return bitsToUniform(result);
+}
+
+void uniformFillScalar(LaneRandom& rng, double* out, size_t count) {
+    for (size_t i = 0; i < count; i += RANDOM_LANES) {
+        for (int lane = 0; lane < RANDOM_LANES; ++lane) {
+            const double u = nextUniformScalar(rng, lane);
+            if (i + lane < count) out[i + lane] = u;
+        }
+    }
+}
+
+// Шаг одной частицы; векторные версии повторяют порядок операций (и хвосты AVX2 идут сюда)
+inline void swarmElement(double& x, double& v, double p, double g, double r1, double r2, const SwarmStep& step) {
+    double vel = step.inertia * v + step.cognitive * r1 * (p - x) + step.social * r2 * (g - x);
+    vel = (std::max)(-step.vmax, (std::min)(step.vmax, vel));
+    double nx = x + vel;
+    if (nx < step.lower) {
+        nx = step.lower;
+        vel = 0.0;
+    }
+    else if (nx > step.upper) {
+        nx = step.upper;
+        vel = 0.0;
+    }
+    x = nx;
+    v = vel;
+}
+
+void swarmUpdateScalar(double* x, double* v, const double* pbest, double gbest, size_t count,
+    const SwarmStep& step, LaneRandom& rng) {
+    for (size_t i = 0; i < count; i += RANDOM_LANES) {
+        double r1[RANDOM_LANES], r2[RANDOM_LANES];
+        for (int lane = 0; lane < RANDOM_LANES; ++lane) {
+            r1[lane] = nextUniformScalar(rng, lane);
+            r2[lane] = nextUniformScalar(rng, lane);
+        }
+        const size_t m = (std::min)(static_cast<size_t>(RANDOM_LANES), count - i);
+        for (size_t k = 0; k < m; ++k) {
+            swarmElement(x[i + k], v[i + k], pbest[i + k], gbest, r1[k], r2[k], step);
+        }
+    }
+}
+
+#ifdef SIMD_X86
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA: 4 точки за инструкцию
+// ---------------------------------------------------------------------------
+
+SIMD_TARGET_AVX2 inline void sincos2piAvx2(__m256d x, __m256d& s, __m256d& c) {
+    const int roundMode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d three = _mm256_set1_pd(3.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+
+    __m256d r = _mm256_sub_pd(x, _mm256_round_pd(x, roundMode));
+    __m256d q = _mm256_round_pd(_mm256_mul_pd(r, four), roundMode);
+    __m256d t = _mm256_mul_pd(_mm256_fnmadd_pd(q, _mm256_set1_pd(0.25), r), _mm256_set1_pd(TWO_PI));
+    __m256d z = _mm256_mul_pd(t, t);
+
+    __m256d ps = _mm256_set1_pd(SIN_COEF[0]);
+    __m256d pc = _mm256_set1_pd(COS_COEF[0]);
+    for (int k = 1; k < 6; ++k) {
+        ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(SIN_COEF[k]));
+        pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(COS_COEF[k]));
+    }
+    __m256d sv = _mm256_fmadd_pd(_mm256_mul_pd(t, z), ps, t);
+    __m256d cv = _mm256_fmadd_pd(_mm256_mul_pd(z, z), pc, _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, one));
+
+    // Четверть в диапазоне 0..3
+    __m256d qm = _mm256_add_pd(q, _mm256_and_pd(_mm256_cmp_pd(q, zero, _CMP_LT_OQ), four));
+    __m256d isOne = _mm256_cmp_pd(qm, one, _CMP_EQ_OQ);
+    __m256d isTwo = _mm256_cmp_pd(qm, two, _CMP_EQ_OQ);
+    __m256d isThree = _mm256_cmp_pd(qm, three, _CMP_EQ_OQ);
+    __m256d swap = _mm256_or_pd(isOne, isThree);
+    __m256d sinNeg = _mm256_or_pd(isTwo, isThree);
+    __m256d cosNeg = _mm256_or_pd(isOne, isTwo);
+
+    __m256d sSel = _mm256_blendv_pd(sv, cv, swap);
+    __m256d cSel = _mm256_blendv_pd(cv, sv, swap);
+    s = _mm256_xor_pd(sSel, _mm256_and_pd(sinNeg, signBit));
+    c = _mm256_xor_pd(cSel, _mm256_and_pd(cosNeg, signBit));
+}
+
+SIMD_TARGET_AVX2 void sincos2piAvx2Loop(const double* x, size_t n, double* s, double* c) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d sv, cv;
+        sincos2piAvx2(_mm256_loadu_pd(x + i), sv, cv);
+        _mm256_storeu_pd(s + i, sv);
+        _mm256_storeu_pd(c + i, cv);
+    }
+    sincos2piScalarLoop(x + i, n - i, s + i, c + i);
+}
+
+SIMD_TARGET_AVX2 void sumOfSquaresAvx2(const double* points, size_t count, int dim, const double* center, double* values) {
+    const size_t vecEnd = count & ~static_cast<size_t>(3);
+    for (size_t i = 0; i < vecEnd; i += 4) {
+        __m256d acc = _mm256_setzero_pd();
+        for (int j = 0; j < dim; ++j) {
+            __m256d d = _mm256_sub_pd(_mm256_loadu_pd(points + static_cast<size_t>(j) * count + i),
+                _mm256_set1_pd(center ? center[j] : 0.0));
+            acc = _mm256_fmadd_pd(d, d, acc);
+        }
+        _mm256_storeu_pd(values + i, acc);
+    }
+    for (size_t i = vecEnd; i < count; ++i) {
+        double acc = 0.0;
+        for (int j = 0; j < dim; ++j) {
+            double d = points[static_cast<size_t>(j) * count + i] - (center ? center[j] : 0.0);
+            acc += d * d;
+        }
+        values[i] = acc;
+    }
+}
+
+SIMD_TARGET_AVX2 void sumOfSquaresGradientAvx2(const double* points, size_t count, int dim, const double* center, double* grads) {
+    const size_t vecEnd = count & ~static_cast<size_t>(3);
+    const __m256d two = _mm256_set1_pd(2.0);
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        const double cj = center ? center[j] : 0.0;
+        const __m256d cv = _mm256_set1_pd(cj);
+        for (size_t i = 0; i < vecEnd; i += 4) {
+            __m256d d = _mm256_sub_pd(_mm256_loadu_pd(points + offset + i), cv);
+            _mm256_storeu_pd(grads + offset + i, _mm256_mul_pd(two, d));
+        }
+        for (size_t i = vecEnd; i < count; ++i) {
+            grads[offset + i] = 2.0 * (points[offset + i] - cj);
+        }
+    }
+}
+
+SIMD_TARGET_AVX2 void rastriginAvx2(const double* points, size_t count, int dim, double A, double* values) {
+    const size_t vecEnd = count & ~static_cast<size_t>(3);
+    const __m256d a = _mm256_set1_pd(A);
+    for (size_t i = 0; i < vecEnd; i += 4) {
+        __m256d acc = _mm256_set1_pd(A * dim);
+        for (int j = 0; j < dim; ++j) {
+            __m256d x = _mm256_loadu_pd(points + static_cast<size_t>(j) * count + i);
+            __m256d s, c;
+            sincos2piAvx2(x, s, c);
+            acc = _mm256_fnmadd_pd(a, c, _mm256_fmadd_pd(x, x, acc));
+        }
+        _mm256_storeu_pd(values + i, acc);
+    }
+    for (size_t i = vecEnd; i < count; ++i) {
+        double acc = A * dim;
+        for (int j = 0; j < dim; ++j) {
+            double x = points[static_cast<size_t>(j) * count + i];
+            double s, c;
+            sincos2piScalar(x, s, c);
+            acc += x * x - A * c;
+        }
+        values[i] = acc;
+    }
+}
+
+SIMD_TARGET_AVX2 void rastriginGradientAvx2(const double* points, size_t count, int dim, double A, double* grads) {
+    const size_t vecEnd = count & ~static_cast<size_t>(3);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d k = _mm256_set1_pd(TWO_PI * A);
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        for (size_t i = 0; i < vecEnd; i += 4) {
+            __m256d x = _mm256_loadu_pd(points + offset + i);
+            __m256d s, c;
+            sincos2piAvx2(x, s, c);
+            _mm256_storeu_pd(grads + offset + i, _mm256_fmadd_pd(k, s, _mm256_mul_pd(two, x)));
+        }
+        for (size_t i = vecEnd; i < count; ++i) {
+            double s, c;
+            sincos2piScalar(points[offset + i], s, c);
+            grads[offset + i] = 2.0 * points[offset + i] + TWO_PI * A * s;
+        }
+    }
+}
+
+SIMD_TARGET_AVX2 void rosenbrockAvx2(const double* points, size_t count, int dim, double* values) {
+    const size_t vecEnd = count & ~static_cast<size_t>(3);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    for (size_t i = 0; i < vecEnd; i += 4) {
+        __m256d acc = _mm256_setzero_pd();
+        __m256d x = _mm256_loadu_pd(points + i);
+        for (int j = 0; j + 1 < dim; ++j) {
+            __m256d y = _mm256_loadu_pd(points + static_cast<size_t>(j + 1) * count + i);
+            __m256d t = _mm256_fnmadd_pd(x, x, y);
+            __m256d u = _mm256_sub_pd(one, x);
+            acc = _mm256_fmadd_pd(_mm256_mul_pd(hundred, t), t, _mm256_fmadd_pd(u, u, acc));
+            x = y;
+        }
+        _mm256_storeu_pd(values + i, acc);
+    }
+    for (size_t i = vecEnd; i < count; ++i) {
+        double acc = 0.0;
+        for (int j = 0; j + 1 < dim; ++j) {
+            double x = points[static_cast<size_t>(j) * count + i];
+            double t = points[static_cast<size_t>(j + 1) * count + i] - x * x;
+            acc += 100.0 * t * t + (1.0 - x) * (1.0 - x);
+        }
+        values[i] = acc;
+    }
+}
+
+SIMD_TARGET_AVX2 void rosenbrockGradientAvx2(const double* points, size_t count, int dim, double* grads) {
+    const size_t vecEnd = count & ~static_cast<size_t>(3);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d m400 = _mm256_set1_pd(-400.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d c200 = _mm256_set1_pd(200.0);
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        const bool hasPrev = j > 0;
+        const bool hasNext = j + 1 < dim;
+        for (size_t i = 0; i < vecEnd; i += 4) {
+            __m256d x = _mm256_loadu_pd(points + offset + i);
+            __m256d g = zero;
+            if (hasNext) {
+                __m256d y = _mm256_loadu_pd(points + offset + count + i);
+                __m256d t = _mm256_fnmadd_pd(x, x, y);
+                g = _mm256_fnmadd_pd(two, _mm256_sub_pd(one, x), _mm256_mul_pd(_mm256_mul_pd(m400, x), t));
+            }
+            if (hasPrev) {
+                __m256d w = _mm256_loadu_pd(points + offset - count + i);
+                g = _mm256_fmadd_pd(c200, _mm256_fnmadd_pd(w, w, x), g);
+            }
+            _mm256_storeu_pd(grads + offset + i, g);
+        }
+        for (size_t i = vecEnd; i < count; ++i) {
+            grads[offset + i] = rosenbrockPartial(
+                hasPrev ? points[offset - count + i] : 0.0, points[offset + i],
+                hasNext ? points[offset + count + i] : 0.0, hasPrev, hasNext);
+        }
+    }
+}
+
+SIMD_TARGET_AVX2 void styblinskiTangAvx2(const double* points, size_t count, int dim, double* values) {
+    const size_t vecEnd = count & ~static_cast<size_t>(3);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d c16 = _mm256_set1_pd(16.0);
+    const __m256d c5 = _mm256_set1_pd(5.0);
+    for (size_t i = 0; i < vecEnd; i += 4) {
+        __m256d acc = _mm256_setzero_pd();
+        for (int j = 0; j < dim; ++j) {
+            __m256d x = _mm256_loadu_pd(points + static_cast<size_t>(j) * count + i);
+            __m256d x2 = _mm256_mul_pd(x, x);
+            // x^4 - 16x^2 + 5x = x2*(x2 - 16) + 5x
+            acc = _mm256_add_pd(acc, _mm256_fmadd_pd(x2, _mm256_sub_pd(x2, c16), _mm256_mul_pd(c5, x)));
+        }
+        _mm256_storeu_pd(values + i, _mm256_mul_pd(half, acc));
+    }
+    for (size_t i = vecEnd; i < count; ++i) {
+        double acc = 0.0;
+        for (int j = 0; j < dim; ++j) {
+            double x = points[static_cast<size_t>(j) * count + i];
+            double x2 = x * x;
+            acc += x2 * (x2 - 16.0) + 5.0 * x;
+        }
+        values[i] = 0.5 * acc;
+    }
+}
+
+SIMD_TARGET_AVX2 void styblinskiTangGradientAvx2(const double* points, size_t count, int dim, double* grads) {
+    const size_t total = static_cast<size_t>(dim) * count;
+    const size_t vecEnd = total & ~static_cast<size_t>(3);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d c16 = _mm256_set1_pd(16.0);
+    const __m256d c25 = _mm256_set1_pd(2.5);
+    for (size_t k = 0; k < vecEnd; k += 4) {
+        __m256d x = _mm256_loadu_pd(points + k);
+        // 2x^3 - 16x + 2.5 = x*(2x^2 - 16) + 2.5
+        __m256d q = _mm256_fmsub_pd(_mm256_mul_pd(two, x), x, c16);
+        _mm256_storeu_pd(grads + k, _mm256_fmadd_pd(x, q, c25));
+    }
+    for (size_t k = vecEnd; k < total; ++k) {
+        double x = points[k];
+        grads[k] = x * (2.0 * x * x - 16.0) + 2.5;
+    }
+}
+
+// Дорожки 0-3 и 4-7 - две половины по 4
+SIMD_TARGET_AVX2 inline void loadLanesAvx2(const LaneRandom& rng, int half, __m256i s[4]) {
+    for (int k = 0; k < 4; ++k) {
+        s[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&rng.state[k][4 * half]));
+    }
+}
+
+SIMD_TARGET_AVX2 inline void storeLanesAvx2(LaneRandom& rng, int half, const __m256i s[4]) {
+    for (int k = 0; k < 4; ++k) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&rng.state[k][4 * half]), s[k]);
+    }
+}
+
+SIMD_TARGET_AVX2 inline __m256d nextUniformAvx2(__m256i s[4]) {
+    const __m256i result = _mm256_add_epi64(s[0], s[3]);
+    const __m256i t = _mm256_slli_epi64(s[1], 17);
+    s[2] = _mm256_xor_si256(s[2], s[0]);
+    s[3] = _mm256_xor_si256(s[3], s[1]);
+    s[1] = _mm256_xor_si256(s[1], s[2]);
+    s[0] = _mm256_xor_si256(s[0], s[3]);
+    s[2] = _mm256_xor_si256(s[2], t);
+    s[3] = _mm256_or_si256(_mm256_slli_epi64(s[3], 45), _mm256_srli_epi64(s[3], 19));
+    const __m256i bits = _mm256_or_si256(_mm256_srli_epi64(result, 12),
+        _mm256_set1_epi64x(0x3FF0000000000000LL));
+    return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+}
+
+SIMD_TARGET_AVX2 void uniformFillAvx2(LaneRandom& rng, double* out, size_t count) {
+    __m256i s[2][4];
+    loadLanesAvx2(rng, 0, s[0]);
+    loadLanesAvx2(rng, 1, s[1]);
+    for (size_t i = 0; i < count; i += RANDOM_LANES) {
+        for (int h = 0; h < 2; ++h) {
+            const __m256d u = nextUniformAvx2(s[h]);
+            const size_t base = i + 4 * h;
+            if (base + 4 <= count) {
+                _mm256_storeu_pd(out + base, u);
+            }
+            else if (base < count) {
+                double tail[4];
+                _mm256_storeu_pd(tail, u);
+                for (size_t k = 0; base + k < count; ++k) out[base + k] = tail[k];
+            }
+        }
+    }
+    storeLanesAvx2(rng, 0, s[0]);
+    storeLanesAvx2(rng, 1, s[1]);
+}
+
+SIMD_TARGET_AVX2 void swarmUpdateAvx2(double* x, double* v, const double* pbest, double gbest, size_t count,
+    const SwarmStep& step, LaneRandom& rng) {
+    const __m256d w = _mm256_set1_pd(step.inertia);
+    const __m256d c1 = _mm256_set1_pd(step.cognitive);
+    const __m256d c2 = _mm256_set1_pd(step.social);
+    const __m256d vmax = _mm256_set1_pd(step.vmax);
+    const __m256d vmin = _mm256_set1_pd(-step.vmax);
+    const __m256d lo = _mm256_set1_pd(step.lower);
+    const __m256d hi = _mm256_set1_pd(step.upper);
+    const __m256d g = _mm256_set1_pd(gbest);
+    __m256i s[2][4];
+    loadLanesAvx2(rng, 0, s[0]);
+    loadLanesAvx2(rng, 1, s[1]);
+    for (size_t i = 0; i < count; i += RANDOM_LANES) {
+        for (int h = 0; h < 2; ++h) {
+            const __m256d r1 = nextUniformAvx2(s[h]);
+            const __m256d r2 = nextUniformAvx2(s[h]);
+            const size_t base = i + 4 * h;
+            if (base + 4 <= count) {
+                const __m256d xv = _mm256_loadu_pd(x + base);
+                const __m256d pv = _mm256_loadu_pd(pbest + base);
+                __m256d vel = _mm256_add_pd(
+                    _mm256_add_pd(_mm256_mul_pd(w, _mm256_loadu_pd(v + base)),
+                        _mm256_mul_pd(_mm256_mul_pd(c1, r1), _mm256_sub_pd(pv, xv))),
+                    _mm256_mul_pd(_mm256_mul_pd(c2, r2), _mm256_sub_pd(g, xv)));
+                vel = _mm256_max_pd(_mm256_min_pd(vel, vmax), vmin);
+                __m256d nx = _mm256_add_pd(xv, vel);
+                const __m256d below = _mm256_cmp_pd(nx, lo, _CMP_LT_OQ);
+                const __m256d above = _mm256_cmp_pd(nx, hi, _CMP_GT_OQ);
+                nx = _mm256_blendv_pd(_mm256_blendv_pd(nx, lo, below), hi, above);
+                vel = _mm256_andnot_pd(_mm256_or_pd(below, above), vel);
+                _mm256_storeu_pd(x + base, nx);
+                _mm256_storeu_pd(v + base, vel);
+            }
+            else if (base < count) {
+                double t1[4], t2[4];
+                _mm256_storeu_pd(t1, r1);
+                _mm256_storeu_pd(t2, r2);
+                for (size_t k = 0; base + k < count; ++k) {
+                    swarmElement(x[base + k], v[base + k], pbest[base + k], gbest, t1[k], t2[k], step);
+                }
+            }
+        }
+    }
+    storeLanesAvx2(rng, 0, s[0]);
+    storeLanesAvx2(rng, 1, s[1]);
+}
+
+
+// ---------------------------------------------------------------------------
+// AVX-512: 8 точек за инструкцию, хвосты обрабатываются маской
+// ---------------------------------------------------------------------------
+
+SIMD_TARGET_AVX512 inline void sincos2piAvx512(__m512d x, __m512d& s, __m512d& c) {
+    const int roundMode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d four = _mm512_set1_pd(4.0);
+
+    __m512d r = _mm512_sub_pd(x, _mm512_roundscale_pd(x, roundMode));
+    __m512d q = _mm512_roundscale_pd(_mm512_mul_pd(r, four), roundMode);
+    __m512d t = _mm512_mul_pd(_mm512_fnmadd_pd(q, _mm512_set1_pd(0.25), r), _mm512_set1_pd(TWO_PI));
+    __m512d z = _mm512_mul_pd(t, t);
+
+    __m512d ps = _mm512_set1_pd(SIN_COEF[0]);
+    __m512d pc = _mm512_set1_pd(COS_COEF[0]);
+    for (int k = 1; k < 6; ++k) {
+        ps = _mm512_fmadd_pd(ps, z, _mm512_set1_pd(SIN_COEF[k]));
+        pc = _mm512_fmadd_pd(pc, z, _mm512_set1_pd(COS_COEF[k]));
+    }
+    __m512d sv = _mm512_fmadd_pd(_mm512_mul_pd(t, z), ps, t);
+    __m512d cv = _mm512_fmadd_pd(_mm512_mul_pd(z, z), pc, _mm512_fnmadd_pd(_mm512_set1_pd(0.5), z, one));
+
+    __m512d qm = _mm512_mask_add_pd(q, _mm512_cmp_pd_mask(q, zero, _CMP_LT_OQ), q, four);
+    __mmask8 isOne = _mm512_cmp_pd_mask(qm, one, _CMP_EQ_OQ);
+    __mmask8 isTwo = _mm512_cmp_pd_mask(qm, _mm512_set1_pd(2.0), _CMP_EQ_OQ);
+    __mmask8 isThree = _mm512_cmp_pd_mask(qm, _mm512_set1_pd(3.0), _CMP_EQ_OQ);
+    __mmask8 swap = static_cast<__mmask8>(isOne | isThree);
+    __mmask8 sinNeg = static_cast<__mmask8>(isTwo | isThree);
+    __mmask8 cosNeg = static_cast<__mmask8>(isOne | isTwo);
+
+    __m512d sSel = _mm512_mask_blend_pd(swap, sv, cv);
+    __m512d cSel = _mm512_mask_blend_pd(swap, cv, sv);
+    s = _mm512_mask_sub_pd(sSel, sinNeg, zero, sSel);
+    c = _mm512_mask_sub_pd(cSel, cosNeg, zero, cSel);
+}
+
+inline __mmask8 tailMask(size_t remaining) {
+    return remaining >= 8 ? static_cast<__mmask8>(0xFF) : static_cast<__mmask8>((1u << remaining) - 1u);
+}
+
+SIMD_TARGET_AVX512 void sincos2piAvx512Loop(const double* x, size_t n, double* s, double* c) {
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 m = tailMask(n - i);
+        __m512d sv, cv;
+        sincos2piAvx512(_mm512_maskz_loadu_pd(m, x + i), sv, cv);
+        _mm512_mask_storeu_pd(s + i, m, sv);
+        _mm512_mask_storeu_pd(c + i, m, cv);
+    }
+}
+
+SIMD_TARGET_AVX512 void sumOfSquaresAvx512(const double* points, size_t count, int dim, const double* center, double* values) {
+    for (size_t i = 0; i < count; i += 8) {
+        __mmask8 m = tailMask(count - i);
+        __m512d acc = _mm512_setzero_pd();
+        for (int j = 0; j < dim; ++j) {
+            __m512d d = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, points + static_cast<size_t>(j) * count + i),
+                _mm512_set1_pd(center ? center[j] : 0.0));
+            acc = _mm512_fmadd_pd(d, d, acc);
+        }
+        _mm512_mask_storeu_pd(values + i, m, acc);
+    }
+}
+
+SIMD_TARGET_AVX512 void sumOfSquaresGradientAvx512(const double* points, size_t count, int dim, const double* center, double* grads) {
+    const __m512d two = _mm512_set1_pd(2.0);
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        const __m512d cv = _mm512_set1_pd(center ? center[j] : 0.0);
+        for (size_t i = 0; i < count; i += 8) {
+            __mmask8 m = tailMask(count - i);
+            __m512d d = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, points + offset + i), cv);
+            _mm512_mask_storeu_pd(grads + offset + i, m, _mm512_mul_pd(two, d));
+        }
+    }
+}
+
+SIMD_TARGET_AVX512 void rastriginAvx512(const double* points, size_t count, int dim, double A, double* values) {
+    const __m512d a = _mm512_set1_pd(A);
+    for (size_t i = 0; i < count; i += 8) {
+        __mmask8 m = tailMask(count - i);
+        __m512d acc = _mm512_set1_pd(A * dim);
+        for (int j = 0; j < dim; ++j) {
+            __m512d x = _mm512_maskz_loadu_pd(m, points + static_cast<size_t>(j) * count + i);
+            __m512d s, c;
+            sincos2piAvx512(x, s, c);
+            acc = _mm512_fnmadd_pd(a, c, _mm512_fmadd_pd(x, x, acc));
+        }
+        _mm512_mask_storeu_pd(values + i, m, acc);
+    }
+}
+
+SIMD_TARGET_AVX512 void rastriginGradientAvx512(const double* points, size_t count, int dim, double A, double* grads) {
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d k = _mm512_set1_pd(TWO_PI * A);
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        for (size_t i = 0; i < count; i += 8) {
+            __mmask8 m = tailMask(count - i);
+            __m512d x = _mm512_maskz_loadu_pd(m, points + offset + i);
+            __m512d s, c;
+            sincos2piAvx512(x, s, c);
+            _mm512_mask_storeu_pd(grads + offset + i, m, _mm512_fmadd_pd(k, s, _mm512_mul_pd(two, x)));
+        }
+    }
+}
+
+SIMD_TARGET_AVX512 void rosenbrockAvx512(const double* points, size_t count, int dim, double* values) {
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d hundred = _mm512_set1_pd(100.0);
+    for (size_t i = 0; i < count; i += 8) {
+        __mmask8 m = tailMask(count - i);
+        __m512d acc = _mm512_setzero_pd();
+        __m512d x = _mm512_maskz_loadu_pd(m, points + i);
+        for (int j = 0; j + 1 < dim; ++j) {
+            __m512d y = _mm512_maskz_loadu_pd(m, points + static_cast<size_t>(j + 1) * count + i);
+            __m512d t = _mm512_fnmadd_pd(x, x, y);
+            __m512d u = _mm512_sub_pd(one, x);
+            acc = _mm512_fmadd_pd(_mm512_mul_pd(hundred, t), t, _mm512_fmadd_pd(u, u, acc));
+            x = y;
+        }
+        _mm512_mask_storeu_pd(values + i, m, acc);
+    }
+}
+
+SIMD_TARGET_AVX512 void rosenbrockGradientAvx512(const double* points, size_t count, int dim, double* grads) {
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d m400 = _mm512_set1_pd(-400.0);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d c200 = _mm512_set1_pd(200.0);
+    for (int j = 0; j < dim; ++j) {
+        const size_t offset = static_cast<size_t>(j) * count;
+        const bool hasPrev = j > 0;
+        const bool hasNext = j + 1 < dim;
+        for (size_t i = 0; i < count; i += 8) {
+            __mmask8 m = tailMask(count - i);
+            __m512d x = _mm512_maskz_loadu_pd(m, points + offset + i);
+            __m512d g = zero;
+            if (hasNext) {
+                __m512d y = _mm512_maskz_loadu_pd(m, points + offset + count + i);
+                __m512d t = _mm512_fnmadd_pd(x, x, y);
+                g = _mm512_fnmadd_pd(two, _mm512_sub_pd(one, x), _mm512_mul_pd(_mm512_mul_pd(m400, x), t));
+            }
+            if (hasPrev) {
+                __m512d w = _mm512_maskz_loadu_pd(m, points + offset - count + i);
+                g = _mm512_fmadd_pd(c200, _mm512_fnmadd_pd(w, w, x), g);
+            }
+            _mm512_mask_storeu_pd(grads + offset + i, m, g);
+        }
+    }
+}
+
+SIMD_TARGET_AVX512 void styblinskiTangAvx512(const double* points, size_t count, int dim, double* values) {
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d c16 = _mm512_set1_pd(16.0);
+    const __m512d c5 = _mm512_set1_pd(5.0);
+    for (size_t i = 0; i < count; i += 8) {
+        __mmask8 m = tailMask(count - i);
+        __m512d acc = _mm512_setzero_pd();
+        for (int j = 0; j < dim; ++j) {
+            __m512d x = _mm512_maskz_loadu_pd(m, points + static_cast<size_t>(j) * count + i);
+            __m512d x2 = _mm512_mul_pd(x, x);
+            acc = _mm512_add_pd(acc, _mm512_fmadd_pd(x2, _mm512_sub_pd(x2, c16), _mm512_mul_pd(c5, x)));
+        }
+        _mm512_mask_storeu_pd(values + i, m, _mm512_mul_pd(half, acc));
+    }
+}
+
+SIMD_TARGET_AVX512 void styblinskiTangGradientAvx512(const double* points, size_t count, int dim, double* grads) {
+    const size_t total = static_cast<size_t>(dim) * count;
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d c16 = _mm512_set1_pd(16.0);
+    const __m512d c25 = _mm512_set1_pd(2.5);
+    for (size_t k = 0; k < total; k += 8) {
+        __mmask8 m = tailMask(total - k);
+        __m512d x = _mm512_maskz_loadu_pd(m, points + k);
+        __m512d q = _mm512_fmsub_pd(_mm512_mul_pd(two, x), x, c16);
+        _mm512_mask_storeu_pd(grads + k, m, _mm512_fmadd_pd(x, q, c25));
+    }
+}
+
+SIMD_TARGET_AVX512 inline __m512d nextUniformAvx512(__m512i s[4]) {
+    const __m512i result = _mm512_add_epi64(s[0], s[3]);
+    const __m512i t = _mm512_slli_epi64(s[1], 17);
+    s[2] = _mm512_xor_si512(s[2], s[0]);
+    s[3] = _mm512_xor_si512(s[3], s[1]);
+    s[1] = _mm512_xor_si512(s[1], s[2]);
+    s[0] = _mm512_xor_si512(s[0], s[3]);
+    s[2] = _mm512_xor_si512(s[2], t);
+    s[3] = _mm512_rol_epi64(s[3], 45);
+    const __m512i bits = _mm512_or_si512(_mm512_srli_epi64(result, 12),
+        _mm512_set1_epi64(0x3FF0000000000000LL));
+    return _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(1.0));
+}
+
+SIMD_TARGET_AVX512 void uniformFillAvx512(LaneRandom& rng, double* out, size_t count) {
+    __m512i s[4];
+    for (int k = 0; k < 4; ++k) s[k] = _mm512_loadu_si512(rng.state[k]);
+    for (size_t i = 0; i < count; i += RANDOM_LANES) {
+        _mm512_mask_storeu_pd(out + i, tailMask(count - i), nextUniformAvx512(s));
+    }
+    for (int k = 0; k < 4; ++k) _mm512_storeu_si512(rng.state[k], s[k]);
+}
+
+SIMD_TARGET_AVX512 void swarmUpdateAvx512(double* x, double* v, const double* pbest, double gbest, size_t count,
+    const SwarmStep& step, LaneRandom& rng) {
+    const __m512d w = _mm512_set1_pd(step.inertia);
+    const __m512d c1 = _mm512_set1_pd(step.cognitive);
+    const __m512d c2 = _mm512_set1_pd(step.social);
+    const __m512d vmax = _mm512_set1_pd(step.vmax);
+    const __m512d vmin = _mm512_set1_pd(-step.vmax);
+    const __m512d lo = _mm512_set1_pd(step.lower);
+    const __m512d hi = _mm512_set1_pd(step.upper);
+    const __m512d g = _mm512_set1_pd(gbest);
+    const __m512d zero = _mm512_setzero_pd();
+    __m512i s[4];
+    for (int k = 0; k < 4; ++k) s[k] = _mm512_loadu_si512(rng.state[k]);
+    for (size_t i = 0; i < count; i += RANDOM_LANES) {
+        const __mmask8 m = tailMask(count - i);
+        const __m512d r1 = nextUniformAvx512(s);
+        const __m512d r2 = nextUniformAvx512(s);
+        const __m512d xv = _mm512_maskz_loadu_pd(m, x + i);
+        const __m512d pv = _mm512_maskz_loadu_pd(m, pbest + i);
+        __m512d vel = _mm512_add_pd(
+            _mm512_add_pd(_mm512_mul_pd(w, _mm512_maskz_loadu_pd(m, v + i)),
+                _mm512_mul_pd(_mm512_mul_pd(c1, r1), _mm512_sub_pd(pv, xv))),
+            _mm512_mul_pd(_mm512_mul_pd(c2, r2), _mm512_sub_pd(g, xv)));
+        vel = _mm512_max_pd(_mm512_min_pd(vel, vmax), vmin);
+        __m512d nx = _mm512_add_pd(xv, vel);
+        const __mmask8 below = _mm512_cmp_pd_mask(nx, lo, _CMP_LT_OQ);
+        const __mmask8 above = _mm512_cmp_pd_mask(nx, hi, _CMP_GT_OQ);
+        nx = _mm512_mask_blend_pd(above, _mm512_mask_blend_pd(below, nx, lo), hi);
+        vel = _mm512_mask_blend_pd(static_cast<__mmask8>(below | above), vel, zero);
+        _mm512_mask_storeu_pd(x + i, m, nx);
+        _mm512_mask_storeu_pd(v + i, m, vel);
+    }
+    for (int k = 0; k < 4; ++k) _mm512_storeu_si512(rng.state[k], s[k]);
+}
+
+Level queryCpu() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    if (maxLeaf < 7) return Level::Scalar;
+
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osxsave || !avx || !fma) return Level::Scalar;
+
+    const unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6) return Level::Scalar;      // XMM и YMM сохраняются ОС
+
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0;
+    const bool avx512f = (info[1] & (1 << 16)) != 0;
+    if (avx512f && (xcr0 & 0xE6) == 0xE6) return Level::AVX512;
+    return avx2 ? Level::AVX2 : Level::Scalar;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Level::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Level::AVX2;
+    return Level::Scalar;
+#endif
+}
+
+#else
+
+Level queryCpu() {
+    return Level::Scalar;
+}
+
+#endif // SIMD_X86
+
+std::atomic<int>& activeLevelStorage() {
+    static std::atomic<int> level(static_cast<int>(detectedLevel()));
+    return level;
+}
+
+} // namespace
+
+Level detectedLevel() {
+    static const Level level = queryCpu();
+    return level;
+}
+
+Level activeLevel() {
+    return static_cast<Level>(activeLevelStorage().load(std::memory_order_relaxed));
+}
+
+void setActiveLevel(Level level) {
+    if (static_cast<int>(level) > static_cast<int>(detectedLevel())) {
+        level = detectedLevel();
+    }
+    activeLevelStorage().store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+const char* levelName(Level level) {
+    switch (level) {
+    case Level::AVX512: return "AVX-512";
+    case Level::AVX2: return "AVX2";
+    default: return "Scalar";
+    }
+}
+
+void sincos2pi(const double* x, size_t n, double* s, double* c) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: sincos2piAvx512Loop(x, n, s, c); return;
+    case Level::AVX2: sincos2piAvx2Loop(x, n, s, c); return;
+    default: break;
+    }
+#endif
+    sincos2piScalarLoop(x, n, s, c);
+}
+
+void sumOfSquaresBatch(const double* points, size_t count, int dim, const double* center, double* values) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: sumOfSquaresAvx512(points, count, dim, center, values); return;
+    case Level::AVX2: sumOfSquaresAvx2(points, count, dim, center, values); return;
+    default: break;
+    }
+#endif
+    sumOfSquaresScalar(points, count, dim, center, values);
+}
+
+void sumOfSquaresGradientBatch(const double* points, size_t count, int dim, const double* center, double* grads) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: sumOfSquaresGradientAvx512(points, count, dim, center, grads); return;
+    case Level::AVX2: sumOfSquaresGradientAvx2(points, count, dim, center, grads); return;
+    default: break;
+    }
+#endif
+    sumOfSquaresGradientScalar(points, count, dim, center, grads);
+}
+
+void rastriginBatch(const double* points, size_t count, int dim, double A, double* values) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: rastriginAvx512(points, count, dim, A, values); return;
+    case Level::AVX2: rastriginAvx2(points, count, dim, A, values); return;
+    default: break;
+    }
+#endif
+    rastriginScalar(points, count, dim, A, values);
+}
+
+void rastriginGradientBatch(const double* points, size_t count, int dim, double A, double* grads) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: rastriginGradientAvx512(points, count, dim, A, grads); return;
+    case Level::AVX2: rastriginGradientAvx2(points, count, dim, A, grads); return;
+    default: break;
+    }
+#endif
+    rastriginGradientScalar(points, count, dim, A, grads);
+}
+
+void rosenbrockBatch(const double* points, size_t count, int dim, double* values) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: rosenbrockAvx512(points, count, dim, values); return;
+    case Level::AVX2: rosenbrockAvx2(points, count, dim, values); return;
+    default: break;
+    }
+#endif
+    rosenbrockScalar(points, count, dim, values);
+}
+
+void rosenbrockGradientBatch(const double* points, size_t count, int dim, double* grads) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: rosenbrockGradientAvx512(points, count, dim, grads); return;
+    case Level::AVX2: rosenbrockGradientAvx2(points, count, dim, grads); return;
+    default: break;
+    }
+#endif
+    rosenbrockGradientScalar(points, count, dim, grads);
+}
+
+void styblinskiTangBatch(const double* points, size_t count, int dim, double* values) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: styblinskiTangAvx512(points, count, dim, values); return;
+    case Level::AVX2: styblinskiTangAvx2(points, count, dim, values); return;
+    default: break;
+    }
+#endif
+    styblinskiTangScalar(points, count, dim, values);
+}
+
+void styblinskiTangGradientBatch(const double* points, size_t count, int dim, double* grads) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: styblinskiTangGradientAvx512(points, count, dim, grads); return;
+    case Level::AVX2: styblinskiTangGradientAvx2(points, count, dim, grads); return;
+    default: break;
+    }
+#endif
+    styblinskiTangGradientScalar(points, count, dim, grads);
+}
+
+void LaneRandom::seed(uint64_t seed) {
+    // splitmix64: соседние seed дают несвязанные состояния
+    for (int lane = 0; lane < RANDOM_LANES; ++lane) {
+        for (int k = 0; k < 4; ++k) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            state[k][lane] = z ^ (z >> 31);
+        }
+    }
+}
+
+void uniformFill(LaneRandom& rng, double* out, size_t count) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: uniformFillAvx512(rng, out, count); return;
+    case Level::AVX2: uniformFillAvx2(rng, out, count); return;
+    default: break;
+    }
+#endif
+    uniformFillScalar(rng, out, count);
+}
+
+void swarmUpdate(double* x, double* v, const double* pbest, double gbest, size_t count,
+    const SwarmStep& step, LaneRandom& rng) {
+#ifdef SIMD_X86
+    switch (activeLevel()) {
+    case Level::AVX512: swarmUpdateAvx512(x, v, pbest, gbest, count, step, rng); return;
+    case Level::AVX2: swarmUpdateAvx2(x, v, pbest, gbest, count, step, rng); return;
+    default: break;
+    }
+#endif
+    swarmUpdateScalar(x, v, pbest, gbest, count, step, rng);
+}
+
+} // namespace simd
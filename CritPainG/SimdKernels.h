@@ -0,0 +1,93 @@
+﻿#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Векторные ядра для встроенных тестовых функций и роя частиц (ParticleSwarm).
+// Все пакеты хранятся по координатам (SoA), как в AbstrFunc::evaluateBatch:
+// j-я координата i-й точки лежит в points[j * count + i].
+// Реализация выбирается при первом вызове по возможностям процессора:
+// AVX-512 (8 точек за инструкцию), AVX2 + FMA (4 точки) или скалярный код.
+namespace simd {
+
+enum class Level { Scalar = 0, AVX2 = 1, AVX512 = 2 };
+
+// Максимальный уровень, поддерживаемый процессором и ОС
+Level detectedLevel();
+// Уровень, который используют ядра (по умолчанию detectedLevel())
+Level activeLevel();
+// Принудительный выбор уровня (например, скалярного для сравнения); не выше detectedLevel()
+void setActiveLevel(Level level);
+const char* levelName(Level level);
+
+// Точность уровней (проверяется тестами Tests/CritPainGTests на всех уровнях,
+// включая хвосты пакетов):
+// - sincos2pi отличается от std::sin/std::cos того же точно сведённого
+//   аргумента не более чем на SINCOS_MAX_ULP;
+// - ядра функций и градиентов и swarmUpdate на AVX2/AVX-512 отличаются от
+//   скалярного кода только округлением (FMA), не более чем на KERNEL_MAX_ULP
+//   в ULP суммы модулей слагаемых при dim <= 8 (результат с сокращением, например
+//   Розенброк у минимума, в собственных ULP может отличаться сильнее); ошибка
+//   растёт с числом слагаемых;
+// - uniformFill совпадает побитно.
+const double SINCOS_MAX_ULP = 2.0;
+const double KERNEL_MAX_ULP = 8.0;
+
+// sin(2*pi*x) и cos(2*pi*x) для n значений.
+// Аргумент сводится точно (x - round(x)), поэтому ошибка не растёт с |x|:
+// не более 2 ULP относительно точного значения для всех конечных x.
+void sincos2pi(const double* x, size_t n, double* s, double* c);
+
+// f = sum_j (x_j - center_j)^2; center == nullptr означает начало координат
+void sumOfSquaresBatch(const double* points, size_t count, int dim, const double* center, double* values);
+void sumOfSquaresGradientBatch(const double* points, size_t count, int dim, const double* center, double* grads);
+
+// f = A*dim + sum_j (x_j^2 - A*cos(2*pi*x_j))
+void rastriginBatch(const double* points, size_t count, int dim, double A, double* values);
+void rastriginGradientBatch(const double* points, size_t count, int dim, double A, double* grads);
+
+// f = sum_{j<dim-1} 100*(x_{j+1} - x_j^2)^2 + (1 - x_j)^2
+void rosenbrockBatch(const double* points, size_t count, int dim, double* values);
+void rosenbrockGradientBatch(const double* points, size_t count, int dim, double* grads);
+
+// f = 0.5 * sum_j (x_j^4 - 16*x_j^2 + 5*x_j)
+void styblinskiTangBatch(const double* points, size_t count, int dim, double* values);
+void styblinskiTangGradientBatch(const double* points, size_t count, int dim, double* grads);
+
+// Генератор xoshiro256+ с независимым состоянием в каждой из RANDOM_LANES
+// дорожек: i-е число пакета берёт дорожка i % RANDOM_LANES, и за каждые
+// RANDOM_LANES элементов (включая неполный хвост) шагают все дорожки. Поэтому
+// последовательность не зависит от уровня: AVX-512 шагает 8 дорожек одной
+// инструкцией, AVX2 - двумя по 4, скалярный код - по одной.
+const int RANDOM_LANES = 8;
+
+struct LaneRandom {
+    uint64_t state[4][RANDOM_LANES];  // state[k][lane]
+    // Состояния дорожек из seed через splitmix64
+    void seed(uint64_t seed);
+};
+
+// out[i] - равномерное в [0, 1) с 52 случайными битами
+void uniformFill(LaneRandom& rng, double* out, size_t count);
+
+// Шаг роя по одной координате для count частиц:
+//   v = inertia v + cognitive r1 (pbest - x) + social r2 (gbest - x),
+//   v обрезается до [-vmax, vmax], x += v; при выходе за [lower, upper]
+//   x ставится на границу, а v обнуляется. r1, r2 - из rng.
+// Случайные числа одинаковы на всех уровнях; положения могут отличаться в
+// последнем бите, если компилятор объединит умножение и сложение в FMA.
+struct SwarmStep {
+    double inertia;
+    double cognitive;
+    double social;
+    double vmax;
+    double lower;
+    double upper;
+};
+void swarmUpdate(double* x, double* v, const double* pbest, double gbest, size_t count,
+    const SwarmStep& step, LaneRandom& rng);
+
+} // namespace simd
+
+#endif
@@ -0,0 +1,779 @@
+﻿#include "pch.h"
+#include "TestFunctions.h"
+#include "SimdKernels.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#ifndef M_E
+#define M_E 2.71828182845904523536
+#endif
+
+namespace {
+
+const double INV_TWO_PI = 1.0 / (2.0 * M_PI);
+
+// Одна строка SoA-пакета: j-я координата всех count точек
+inline const double* row(const double* points, size_t count, int j) {
+    return points + static_cast<size_t>(j) * count;
+}
+
+inline double* row(double* points, size_t count, int j) {
+    return points + static_cast<size_t>(j) * count;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// FunctionND
+// ---------------------------------------------------------------------------
+
+FunctionND::FunctionND(int dim, const char* name, int minDim)
+    : dimension(dim), className(name) {
+    if (dim < minDim) {
+        throw std::invalid_argument(std::string(name) + " requires at least " + std::to_string(minDim) + " dimensions");
+    }
+}
+
+void FunctionND::checkSize(const std::vector<double>& x) const {
+    if (static_cast<int>(x.size()) != dimension) {
+        throw std::invalid_argument(std::string(className) + " requires exactly " + std::to_string(dimension) + " dimensions");
+    }
+}
+
+std::string FunctionND::dimensionPrefix(const char* title) const {
+    return std::string(title) + " " + std::to_string(dimension) + "D: ";
+}
+
+std::vector<double> FunctionND::getGradient(const std::vector<double>& x) const {
+    std::vector<double> grad;
+    valueAndGradient(x, grad);
+    return grad;
+}
+
+int FunctionND::getDimension() const {
+    return dimension;
+}
+
+// ---------------------------------------------------------------------------
+// Sphere
+// ---------------------------------------------------------------------------
+
+SphereFuncND::SphereFuncND(int dim) : FunctionND(dim, "SphereFuncND") {}
+
+double SphereFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    double sum = 0.0;
+    for (double xi : x) sum += xi * xi;
+    return sum;
+}
+
+std::string SphereFuncND::getName() const {
+    return dimensionPrefix("Sphere") + "f(x) = sum x_i^2";
+}
+
+double SphereFuncND::coordinateTerm(int, double xj) const {
+    return xj * xj;
+}
+
+double SphereFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    grad.resize(dimension);
+    double sum = 0.0;
+    for (int i = 0; i < dimension; ++i) {
+        sum += x[i] * x[i];
+        grad[i] = 2.0 * x[i];
+    }
+    return sum;
+}
+
+std::vector<double> SphereFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    std::vector<double> hv(dimension);
+    for (int i = 0; i < dimension; ++i) hv[i] = 2.0 * v[i];
+    return hv;
+}
+
+void SphereFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    simd::sumOfSquaresBatch(points, count, dimension, nullptr, values);
+}
+
+void SphereFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    simd::sumOfSquaresGradientBatch(points, count, dimension, nullptr, grads);
+}
+
+// ---------------------------------------------------------------------------
+// Rastrigin
+// ---------------------------------------------------------------------------
+
+RastriginFuncND::RastriginFuncND(int dim) : FunctionND(dim, "RastriginFuncND") {}
+
+double RastriginFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    double sum = A * dimension;
+    for (double xi : x) sum += xi * xi - A * cos(2.0 * M_PI * xi);
+    return sum;
+}
+
+std::string RastriginFuncND::getName() const {
+    return dimensionPrefix("Rastrigin") + "f(x) = 10n + sum (x_i^2 - 10cos(2pix_i))";
+}
+
+double RastriginFuncND::coordinateTerm(int, double xj) const {
+    return A + xj * xj - A * cos(2.0 * M_PI * xj);
+}
+
+double RastriginFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    std::vector<double> s(dimension), c(dimension);
+    simd::sincos2pi(x.data(), dimension, s.data(), c.data());
+
+    grad.resize(dimension);
+    double sum = A * dimension;
+    for (int i = 0; i < dimension; ++i) {
+        sum += x[i] * x[i] - A * c[i];
+        grad[i] = 2.0 * x[i] + 2.0 * M_PI * A * s[i];
+    }
+    return sum;
+}
+
+std::vector<double> RastriginFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    std::vector<double> s(dimension), c(dimension);
+    simd::sincos2pi(x.data(), dimension, s.data(), c.data());
+
+    // Гессиан диагональный: 2 + 4pi^2 A cos(2pi x_i)
+    const double k = 4.0 * M_PI * M_PI * A;
+    std::vector<double> hv(dimension);
+    for (int i = 0; i < dimension; ++i) hv[i] = (2.0 + k * c[i]) * v[i];
+    return hv;
+}
+
+void RastriginFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    simd::rastriginBatch(points, count, dimension, A, values);
+}
+
+void RastriginFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    simd::rastriginGradientBatch(points, count, dimension, A, grads);
+}
+
+// ---------------------------------------------------------------------------
+// Rosenbrock
+// ---------------------------------------------------------------------------
+
+RosenbrockFuncND::RosenbrockFuncND(int dim) : FunctionND(dim, "RosenbrockFuncND", 2) {}
+
+double RosenbrockFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    double sum = 0.0;
+    for (int i = 0; i + 1 < dimension; ++i) {
+        double t = x[i + 1] - x[i] * x[i];
+        double u = 1.0 - x[i];
+        sum += 100.0 * t * t + u * u;
+    }
+    return sum;
+}
+
+std::string RosenbrockFuncND::getName() const {
+    return dimensionPrefix("Rosenbrock") + "f(x) = sum 100(x_{i+1} - x_i^2)^2 + (1 - x_i)^2";
+}
+
+double RosenbrockFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    grad.assign(dimension, 0.0);
+    double sum = 0.0;
+    for (int i = 0; i + 1 < dimension; ++i) {
+        double t = x[i + 1] - x[i] * x[i];
+        double u = 1.0 - x[i];
+        sum += 100.0 * t * t + u * u;
+        grad[i] += -400.0 * x[i] * t - 2.0 * u;
+        grad[i + 1] += 200.0 * t;
+    }
+    return sum;
+}
+
+std::vector<double> RosenbrockFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    // Гессиан трёхдиагональный; вклад слагаемого i в строки i и i+1
+    std::vector<double> hv(dimension, 0.0);
+    for (int i = 0; i + 1 < dimension; ++i) {
+        const double dii = 1200.0 * x[i] * x[i] - 400.0 * x[i + 1] + 2.0;
+        const double dij = -400.0 * x[i];
+        hv[i] += dii * v[i] + dij * v[i + 1];
+        hv[i + 1] += dij * v[i] + 200.0 * v[i + 1];
+    }
+    return hv;
+}
+
+void RosenbrockFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    simd::rosenbrockBatch(points, count, dimension, values);
+}
+
+void RosenbrockFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    simd::rosenbrockGradientBatch(points, count, dimension, grads);
+}
+
+// ---------------------------------------------------------------------------
+// Ackley
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const double ACKLEY_A = 20.0;
+const double ACKLEY_B = 0.2;
+
+} // namespace
+
+AckleyFuncND::AckleyFuncND(int dim) : FunctionND(dim, "AckleyFuncND") {}
+
+double AckleyFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    double sumSq = 0.0;
+    double sumCos = 0.0;
+    for (double xi : x) {
+        sumSq += xi * xi;
+        sumCos += cos(2.0 * M_PI * xi);
+    }
+    const double n = dimension;
+    return -ACKLEY_A * exp(-ACKLEY_B * sqrt(sumSq / n)) - exp(sumCos / n) + ACKLEY_A + M_E;
+}
+
+std::string AckleyFuncND::getName() const {
+    return dimensionPrefix("Ackley") + "f(x) = -20exp(-0.2sqrt(sum x_i^2/n)) - exp(sum cos(2pix_i)/n) + 20 + e";
+}
+
+double AckleyFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    std::vector<double> s(dimension), c(dimension);
+    simd::sincos2pi(x.data(), dimension, s.data(), c.data());
+
+    double sumSq = 0.0;
+    double sumCos = 0.0;
+    for (int i = 0; i < dimension; ++i) {
+        sumSq += x[i] * x[i];
+        sumCos += c[i];
+    }
+    const double n = dimension;
+    const double r = sqrt(sumSq / n);
+    const double e1 = exp(-ACKLEY_B * r);
+    const double e2 = exp(sumCos / n);
+
+    // d/dx_i: 20*0.2*e1 * x_i / (n*r) + e2 * 2pi*sin(2pix_i) / n
+    const double k1 = r > 0.0 ? ACKLEY_A * ACKLEY_B * e1 / (n * r) : 0.0;
+    const double k2 = 2.0 * M_PI * e2 / n;
+    grad.resize(dimension);
+    for (int i = 0; i < dimension; ++i) {
+        grad[i] = k1 * x[i] + k2 * s[i];
+    }
+    return -ACKLEY_A * e1 - e2 + ACKLEY_A + M_E;
+}
+
+std::vector<double> AckleyFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    std::vector<double> s(dimension), c(dimension);
+    simd::sincos2pi(x.data(), dimension, s.data(), c.data());
+
+    const double n = dimension;
+    double sumSq = 0.0, sumCos = 0.0, xv = 0.0, sv = 0.0;
+    for (int i = 0; i < dimension; ++i) {
+        sumSq += x[i] * x[i];
+        sumCos += c[i];
+        xv += x[i] * v[i];
+        sv += s[i] * v[i];
+    }
+
+    // Первое слагаемое зависит от r = sqrt(sum x_i^2 / n): градиент a(r) x,
+    // гессиан a I + a'(r) x x^T / (n r). В начале координат берётся 0.
+    const double r = sqrt(sumSq / n);
+    double a = 0.0, b = 0.0;
+    if (r > 0.0) {
+        const double e = exp(-ACKLEY_B * r);
+        a = ACKLEY_A * ACKLEY_B * e / (n * r);
+        const double da = ACKLEY_A * ACKLEY_B * e * (-ACKLEY_B / r - 1.0 / (r * r)) / n;
+        b = da / (n * r);
+    }
+    // Второе слагаемое: (4pi^2/n) E (diag(c) - s s^T / n), E = exp(sum cos / n)
+    const double k = 4.0 * M_PI * M_PI * exp(sumCos / n) / n;
+
+    std::vector<double> hv(dimension);
+    for (int i = 0; i < dimension; ++i) {
+        hv[i] = a * v[i] + b * x[i] * xv + k * (c[i] * v[i] - s[i] * sv / n);
+    }
+    return hv;
+}
+
+void AckleyFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    std::vector<double> sumSq(count, 0.0), sumCos(count, 0.0), s(count), c(count);
+    for (int j = 0; j < dimension; ++j) {
+        const double* xs = row(points, count, j);
+        simd::sincos2pi(xs, count, s.data(), c.data());
+        for (size_t i = 0; i < count; ++i) {
+            sumSq[i] += xs[i] * xs[i];
+            sumCos[i] += c[i];
+        }
+    }
+    const double n = dimension;
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = -ACKLEY_A * exp(-ACKLEY_B * sqrt(sumSq[i] / n)) - exp(sumCos[i] / n) + ACKLEY_A + M_E;
+    }
+}
+
+void AckleyFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    std::vector<double> k1(count, 0.0), k2(count, 0.0), s(count), c(count);
+    for (int j = 0; j < dimension; ++j) {
+        const double* xs = row(points, count, j);
+        simd::sincos2pi(xs, count, s.data(), c.data());
+        for (size_t i = 0; i < count; ++i) {
+            k1[i] += xs[i] * xs[i];
+            k2[i] += c[i];
+        }
+    }
+    const double n = dimension;
+    for (size_t i = 0; i < count; ++i) {
+        const double r = sqrt(k1[i] / n);
+        k1[i] = r > 0.0 ? ACKLEY_A * ACKLEY_B * exp(-ACKLEY_B * r) / (n * r) : 0.0;
+        k2[i] = 2.0 * M_PI * exp(k2[i] / n) / n;
+    }
+    for (int j = 0; j < dimension; ++j) {
+        const double* xs = row(points, count, j);
+        double* gs = row(grads, count, j);
+        simd::sincos2pi(xs, count, s.data(), c.data());
+        for (size_t i = 0; i < count; ++i) {
+            gs[i] = k1[i] * xs[i] + k2[i] * s[i];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Griewank
+// ---------------------------------------------------------------------------
+
+GriewankFuncND::GriewankFuncND(int dim) : FunctionND(dim, "GriewankFuncND") {}
+
+double GriewankFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    double sum = 0.0;
+    double prod = 1.0;
+    for (int i = 0; i < dimension; ++i) {
+        sum += x[i] * x[i];
+        prod *= cos(x[i] / sqrt(i + 1.0));
+    }
+    return 1.0 + sum / 4000.0 - prod;
+}
+
+std::string GriewankFuncND::getName() const {
+    return dimensionPrefix("Griewank") + "f(x) = 1 + sum x_i^2/4000 - prod cos(x_i/sqrt(i))";
+}
+
+double GriewankFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    std::vector<double> c(dimension), s(dimension);
+    double sum = 0.0;
+    for (int i = 0; i < dimension; ++i) {
+        const double scale = 1.0 / sqrt(i + 1.0);
+        c[i] = cos(x[i] * scale);
+        s[i] = sin(x[i] * scale) * scale;
+        sum += x[i] * x[i];
+    }
+
+    // Произведение без i-го множителя: префикс слева направо, затем суффикс справа налево.
+    // Деления на cos нет, поэтому нули косинуса не мешают.
+    grad.resize(dimension);
+    double prefix = 1.0;
+    for (int i = 0; i < dimension; ++i) {
+        grad[i] = prefix;
+        prefix *= c[i];
+    }
+    double suffix = 1.0;
+    for (int i = dimension - 1; i >= 0; --i) {
+        grad[i] = x[i] / 2000.0 + s[i] * grad[i] * suffix;
+        suffix *= c[i];
+    }
+    return 1.0 + sum / 4000.0 - prefix;
+}
+
+std::vector<double> GriewankFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    const int n = dimension;
+    std::vector<double> c(n), s(n), scale2(n);
+    for (int i = 0; i < n; ++i) {
+        const double scale = 1.0 / sqrt(i + 1.0);
+        c[i] = cos(x[i] * scale);
+        s[i] = sin(x[i] * scale) * scale;
+        scale2[i] = scale * scale;
+    }
+
+    // P = prod c_k. Нужны суммы sum_{j != i} s_j v_j prod_{k != i, j} c_k; они
+    // собираются без деления накоплением слева (left) и справа (right).
+    std::vector<double> prefix(n + 1), left(n + 1);
+    prefix[0] = 1.0;
+    left[0] = 0.0;
+    for (int i = 0; i < n; ++i) {
+        prefix[i + 1] = prefix[i] * c[i];
+        left[i + 1] = left[i] * c[i] + s[i] * v[i] * prefix[i];
+    }
+    const double product = prefix[n];
+
+    std::vector<double> hv(n);
+    double suffix = 1.0;
+    double right = 0.0;
+    for (int i = n - 1; i >= 0; --i) {
+        const double mixed = left[i] * suffix + prefix[i] * right;
+        hv[i] = v[i] / 2000.0 - s[i] * mixed + scale2[i] * product * v[i];
+        right = right * c[i] + s[i] * v[i] * suffix;
+        suffix *= c[i];
+    }
+    return hv;
+}
+
+void GriewankFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    std::vector<double> sum(count, 0.0), prod(count, 1.0), arg(count), s(count), c(count);
+    for (int j = 0; j < dimension; ++j) {
+        const double* xs = row(points, count, j);
+        // cos(x / sqrt(j+1)) = cos(2pi * t), t = x / (2pi*sqrt(j+1))
+        const double scale = INV_TWO_PI / sqrt(j + 1.0);
+        for (size_t i = 0; i < count; ++i) arg[i] = xs[i] * scale;
+        simd::sincos2pi(arg.data(), count, s.data(), c.data());
+        for (size_t i = 0; i < count; ++i) {
+            sum[i] += xs[i] * xs[i];
+            prod[i] *= c[i];
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = 1.0 + sum[i] / 4000.0 - prod[i];
+    }
+}
+
+void GriewankFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    // Косинусы и синусы всех строк нужны дважды (префиксный и суффиксный проход)
+    const size_t total = static_cast<size_t>(dimension) * count;
+    std::vector<double> arg(total), s(total), c(total), running(count, 1.0);
+    for (int j = 0; j < dimension; ++j) {
+        const double scale = INV_TWO_PI / sqrt(j + 1.0);
+        const double* xs = row(points, count, j);
+        double* as = row(arg.data(), count, j);
+        for (size_t i = 0; i < count; ++i) as[i] = xs[i] * scale;
+    }
+    simd::sincos2pi(arg.data(), total, s.data(), c.data());
+
+    for (int j = 0; j < dimension; ++j) {
+        const double* cs = row(c.data(), count, j);
+        double* gs = row(grads, count, j);
+        for (size_t i = 0; i < count; ++i) {
+            gs[i] = running[i];
+            running[i] *= cs[i];
+        }
+    }
+    for (size_t i = 0; i < count; ++i) running[i] = 1.0;
+    for (int j = dimension - 1; j >= 0; --j) {
+        const double scale = 1.0 / sqrt(j + 1.0);
+        const double* xs = row(points, count, j);
+        const double* ss = row(s.data(), count, j);
+        const double* cs = row(c.data(), count, j);
+        double* gs = row(grads, count, j);
+        for (size_t i = 0; i < count; ++i) {
+            gs[i] = xs[i] / 2000.0 + ss[i] * scale * gs[i] * running[i];
+            running[i] *= cs[i];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Schwefel
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const double SCHWEFEL_C = 418.9828872724338;
+
+} // namespace
+
+SchwefelFuncND::SchwefelFuncND(int dim) : FunctionND(dim, "SchwefelFuncND") {}
+
+double SchwefelFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    double sum = SCHWEFEL_C * dimension;
+    for (double xi : x) sum -= xi * sin(sqrt(fabs(xi)));
+    return sum;
+}
+
+std::string SchwefelFuncND::getName() const {
+    return dimensionPrefix("Schwefel") + "f(x) = 418.9829n - sum x_i sin(sqrt|x_i|)";
+}
+
+double SchwefelFuncND::coordinateTerm(int, double xj) const {
+    return SCHWEFEL_C - xj * sin(sqrt(fabs(xj)));
+}
+
+double SchwefelFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    grad.resize(dimension);
+    double sum = SCHWEFEL_C * dimension;
+    for (int i = 0; i < dimension; ++i) {
+        // d/dx [x sin(sqrt|x|)] = sin(r) + r cos(r) / 2, r = sqrt|x|
+        const double r = sqrt(fabs(x[i]));
+        const double sr = sin(r);
+        sum -= x[i] * sr;
+        grad[i] = -sr - 0.5 * r * cos(r);
+    }
+    return sum;
+}
+
+std::vector<double> SchwefelFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    // Гессиан диагональный: (-1.5 cos(r) + 0.5 r sin(r)) sign(x) / (2r), r = sqrt|x|;
+    // в x = 0 вторая производная не определена, берётся 0
+    std::vector<double> hv(dimension);
+    for (int i = 0; i < dimension; ++i) {
+        const double r = sqrt(fabs(x[i]));
+        if (r == 0.0) {
+            hv[i] = 0.0;
+            continue;
+        }
+        const double d2 = (-1.5 * cos(r) + 0.5 * r * sin(r)) / (2.0 * r);
+        hv[i] = (x[i] > 0.0 ? d2 : -d2) * v[i];
+    }
+    return hv;
+}
+
+void SchwefelFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    std::vector<double> arg(count), s(count), c(count);
+    for (size_t i = 0; i < count; ++i) values[i] = SCHWEFEL_C * dimension;
+    for (int j = 0; j < dimension; ++j) {
+        const double* xs = row(points, count, j);
+        for (size_t i = 0; i < count; ++i) arg[i] = sqrt(fabs(xs[i])) * INV_TWO_PI;
+        simd::sincos2pi(arg.data(), count, s.data(), c.data());
+        for (size_t i = 0; i < count; ++i) values[i] -= xs[i] * s[i];
+    }
+}
+
+void SchwefelFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    const size_t total = static_cast<size_t>(dimension) * count;
+    std::vector<double> s(total), c(total);
+    // Строки обрабатываются одним вызовом; аргумент временно хранится в grads
+    for (size_t k = 0; k < total; ++k) grads[k] = sqrt(fabs(points[k])) * INV_TWO_PI;
+    simd::sincos2pi(grads, total, s.data(), c.data());
+    for (size_t k = 0; k < total; ++k) {
+        const double r = sqrt(fabs(points[k]));
+        grads[k] = -s[k] - 0.5 * r * c[k];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Levy
+// ---------------------------------------------------------------------------
+
+LevyFuncND::LevyFuncND(int dim) : FunctionND(dim, "LevyFuncND") {}
+
+double LevyFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    const int n = dimension;
+    const double w1 = 1.0 + (x[0] - 1.0) / 4.0;
+    const double wn = 1.0 + (x[n - 1] - 1.0) / 4.0;
+
+    const double s1 = sin(M_PI * w1);
+    double sum = s1 * s1;
+    for (int i = 0; i + 1 < n; ++i) {
+        const double w = 1.0 + (x[i] - 1.0) / 4.0;
+        const double g = sin(M_PI * w + 1.0);
+        sum += (w - 1.0) * (w - 1.0) * (1.0 + 10.0 * g * g);
+    }
+    const double h = sin(2.0 * M_PI * wn);
+    sum += (wn - 1.0) * (wn - 1.0) * (1.0 + h * h);
+    return sum;
+}
+
+std::string LevyFuncND::getName() const {
+    return dimensionPrefix("Levy") + "f(x) = sin^2(piw_1) + sum (w_i-1)^2(1+10sin^2(piw_i+1)) + (w_n-1)^2(1+sin^2(2piw_n))";
+}
+
+double LevyFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    const int n = dimension;
+    grad.assign(n, 0.0);
+
+    // dw/dx = 1/4
+    const double w1 = 1.0 + (x[0] - 1.0) / 4.0;
+    const double s1 = sin(M_PI * w1);
+    double sum = s1 * s1;
+    grad[0] += 0.25 * M_PI * sin(2.0 * M_PI * w1);
+
+    for (int i = 0; i + 1 < n; ++i) {
+        const double w = 1.0 + (x[i] - 1.0) / 4.0;
+        const double u = w - 1.0;
+        const double g = sin(M_PI * w + 1.0);
+        const double gc = cos(M_PI * w + 1.0);
+        sum += u * u * (1.0 + 10.0 * g * g);
+        grad[i] += 0.25 * (2.0 * u * (1.0 + 10.0 * g * g) + 20.0 * M_PI * u * u * g * gc);
+    }
+
+    const double wn = 1.0 + (x[n - 1] - 1.0) / 4.0;
+    const double un = wn - 1.0;
+    const double h = sin(2.0 * M_PI * wn);
+    const double hc = cos(2.0 * M_PI * wn);
+    sum += un * un * (1.0 + h * h);
+    grad[n - 1] += 0.25 * (2.0 * un * (1.0 + h * h) + 4.0 * M_PI * un * un * h * hc);
+    return sum;
+}
+
+std::vector<double> LevyFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    const int n = dimension;
+    // Функция сепарабельна по w_i, гессиан диагональный; d^2/dx^2 = (1/16) d^2/dw^2
+    std::vector<double> d2(n, 0.0);
+
+    const double w1 = 1.0 + (x[0] - 1.0) / 4.0;
+    d2[0] += 2.0 * M_PI * M_PI * cos(2.0 * M_PI * w1);
+
+    for (int i = 0; i + 1 < n; ++i) {
+        const double w = 1.0 + (x[i] - 1.0) / 4.0;
+        const double u = w - 1.0;
+        const double g = sin(M_PI * w + 1.0);
+        const double b = 1.0 + 10.0 * g * g;
+        const double db = 10.0 * M_PI * sin(2.0 * (M_PI * w + 1.0));
+        const double d2b = 20.0 * M_PI * M_PI * cos(2.0 * (M_PI * w + 1.0));
+        d2[i] += 2.0 * b + 4.0 * u * db + u * u * d2b;
+    }
+
+    const double wn = 1.0 + (x[n - 1] - 1.0) / 4.0;
+    const double un = wn - 1.0;
+    const double h = sin(2.0 * M_PI * wn);
+    const double b = 1.0 + h * h;
+    const double db = 2.0 * M_PI * sin(4.0 * M_PI * wn);
+    const double d2b = 8.0 * M_PI * M_PI * cos(4.0 * M_PI * wn);
+    d2[n - 1] += 2.0 * b + 4.0 * un * db + un * un * d2b;
+
+    std::vector<double> hv(n);
+    for (int i = 0; i < n; ++i) hv[i] = d2[i] / 16.0 * v[i];
+    return hv;
+}
+
+void LevyFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    const int n = dimension;
+    std::vector<double> arg(count), s(count), c(count);
+
+    // sin(pi*w) = sin(2pi * w/2)
+    const double* x1 = row(points, count, 0);
+    for (size_t i = 0; i < count; ++i) arg[i] = 0.5 * (1.0 + (x1[i] - 1.0) / 4.0);
+    simd::sincos2pi(arg.data(), count, s.data(), c.data());
+    for (size_t i = 0; i < count; ++i) values[i] = s[i] * s[i];
+
+    // sin(pi*w + 1) = sin(2pi * (w/2 + 1/(2pi)))
+    for (int j = 0; j + 1 < n; ++j) {
+        const double* xs = row(points, count, j);
+        for (size_t i = 0; i < count; ++i) arg[i] = 0.5 * (1.0 + (xs[i] - 1.0) / 4.0) + INV_TWO_PI;
+        simd::sincos2pi(arg.data(), count, s.data(), c.data());
+        for (size_t i = 0; i < count; ++i) {
+            const double u = (xs[i] - 1.0) / 4.0;
+            values[i] += u * u * (1.0 + 10.0 * s[i] * s[i]);
+        }
+    }
+
+    const double* xn = row(points, count, n - 1);
+    for (size_t i = 0; i < count; ++i) arg[i] = 1.0 + (xn[i] - 1.0) / 4.0;
+    simd::sincos2pi(arg.data(), count, s.data(), c.data());
+    for (size_t i = 0; i < count; ++i) {
+        const double u = (xn[i] - 1.0) / 4.0;
+        values[i] += u * u * (1.0 + s[i] * s[i]);
+    }
+}
+
+void LevyFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    const int n = dimension;
+    std::vector<double> arg(count), s(count), c(count);
+
+    for (int j = 0; j < n; ++j) {
+        const double* xs = row(points, count, j);
+        double* gs = row(grads, count, j);
+        for (size_t i = 0; i < count; ++i) gs[i] = 0.0;
+        if (j + 1 < n) {
+            for (size_t i = 0; i < count; ++i) arg[i] = 0.5 * (1.0 + (xs[i] - 1.0) / 4.0) + INV_TWO_PI;
+            simd::sincos2pi(arg.data(), count, s.data(), c.data());
+            for (size_t i = 0; i < count; ++i) {
+                const double u = (xs[i] - 1.0) / 4.0;
+                gs[i] += 0.25 * (2.0 * u * (1.0 + 10.0 * s[i] * s[i]) + 20.0 * M_PI * u * u * s[i] * c[i]);
+            }
+        }
+    }
+
+    const double* x1 = row(points, count, 0);
+    for (size_t i = 0; i < count; ++i) arg[i] = 0.5 * (1.0 + (x1[i] - 1.0) / 4.0);
+    simd::sincos2pi(arg.data(), count, s.data(), c.data());
+    for (size_t i = 0; i < count; ++i) {
+        // d/dw sin^2(pi*w) = pi * sin(2pi*w) = 2pi * sin(pi*w) * cos(pi*w)
+        grads[i] += 0.25 * 2.0 * M_PI * s[i] * c[i];
+    }
+
+    const double* xn = row(points, count, n - 1);
+    double* gn = row(grads, count, n - 1);
+    for (size_t i = 0; i < count; ++i) arg[i] = 1.0 + (xn[i] - 1.0) / 4.0;
+    simd::sincos2pi(arg.data(), count, s.data(), c.data());
+    for (size_t i = 0; i < count; ++i) {
+        const double u = (xn[i] - 1.0) / 4.0;
+        gn[i] += 0.25 * (2.0 * u * (1.0 + s[i] * s[i]) + 4.0 * M_PI * u * u * s[i] * c[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Styblinski-Tang
+// ---------------------------------------------------------------------------
+
+StyblinskiTangFuncND::StyblinskiTangFuncND(int dim) : FunctionND(dim, "StyblinskiTangFuncND") {}
+
+double StyblinskiTangFuncND::operator()(const std::vector<double>& x) const {
+    checkSize(x);
+    double sum = 0.0;
+    for (double xi : x) {
+        double x2 = xi * xi;
+        sum += x2 * x2 - 16.0 * x2 + 5.0 * xi;
+    }
+    return 0.5 * sum;
+}
+
+std::string StyblinskiTangFuncND::getName() const {
+    return dimensionPrefix("Styblinski-Tang") + "f(x) = 0.5 sum (x_i^4 - 16x_i^2 + 5x_i)";
+}
+
+double StyblinskiTangFuncND::coordinateTerm(int, double xj) const {
+    const double x2 = xj * xj;
+    return 0.5 * (x2 * x2 - 16.0 * x2 + 5.0 * xj);
+}
+
+double StyblinskiTangFuncND::valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const {
+    checkSize(x);
+    grad.resize(dimension);
+    double sum = 0.0;
+    for (int i = 0; i < dimension; ++i) {
+        double x2 = x[i] * x[i];
+        sum += x2 * x2 - 16.0 * x2 + 5.0 * x[i];
+        grad[i] = 2.0 * x2 * x[i] - 16.0 * x[i] + 2.5;
+    }
+    return 0.5 * sum;
+}
+
+std::vector<double> StyblinskiTangFuncND::hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const {
+    checkSize(x);
+    checkSize(v);
+    std::vector<double> hv(dimension);
+    for (int i = 0; i < dimension; ++i) hv[i] = (6.0 * x[i] * x[i] - 16.0) * v[i];
+    return hv;
+}
+
+void StyblinskiTangFuncND::evaluateBatch(const double* points, size_t count, double* values) const {
+    simd::styblinskiTangBatch(points, count, dimension, values);
+}
+
+void StyblinskiTangFuncND::gradientBatch(const double* points, size_t count, double* grads) const {
+    simd::styblinskiTangGradientBatch(points, count, dimension, grads);
+}
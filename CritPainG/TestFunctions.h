@@ -0,0 +1,155 @@
+﻿#ifndef TESTFUNCTIONS_H
+#define TESTFUNCTIONS_H
+
+#include "AbstrFunc.h"
+#include <string>
+#include <vector>
+
+// Тестовые функции произвольной размерности (размерность задаётся в конструкторе).
+// У каждой функции аналитический градиент, точное произведение гессиана на
+// вектор и пакетные методы: пакет обрабатывается
+// по строкам координат SoA, многочлены считаются ядрами SimdKernels, а синусы и
+// косинусы - векторным simd::sincos2pi.
+
+// Общая часть: размерность и проверка длины аргумента
+class FunctionND : public AbstrFunc {
+protected:
+    int dimension;
+    const char* className;
+
+    FunctionND(int dim, const char* name, int minDim = 1);
+    void checkSize(const std::vector<double>& x) const;
+    std::string dimensionPrefix(const char* title) const;
+
+public:
+    std::vector<double> getGradient(const std::vector<double>& x) const override;
+    int getDimension() const override;
+};
+
+// f = sum x_i^2, минимум 0 в начале координат
+class SphereFuncND : public FunctionND {
+public:
+    explicit SphereFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+    bool isSeparable() const override { return true; }
+    double coordinateTerm(int j, double xj) const override;
+};
+
+// f = A*n + sum (x_i^2 - A*cos(2*pi*x_i)), минимум 0 в начале координат
+class RastriginFuncND : public FunctionND {
+private:
+    static constexpr double A = 10.0;
+public:
+    explicit RastriginFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+    bool isSeparable() const override { return true; }
+    double coordinateTerm(int j, double xj) const override;
+};
+
+// f = sum_{i<n-1} 100*(x_{i+1} - x_i^2)^2 + (1 - x_i)^2, минимум 0 в (1, ..., 1)
+class RosenbrockFuncND : public FunctionND {
+public:
+    explicit RosenbrockFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+};
+
+// f = -20*exp(-0.2*sqrt(sum x_i^2 / n)) - exp(sum cos(2*pi*x_i) / n) + 20 + e,
+// минимум 0 в начале координат (там берётся нулевой субградиент)
+class AckleyFuncND : public FunctionND {
+public:
+    explicit AckleyFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+};
+
+// f = 1 + sum x_i^2 / 4000 - prod cos(x_i / sqrt(i)), минимум 0 в начале координат
+class GriewankFuncND : public FunctionND {
+public:
+    explicit GriewankFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+};
+
+// f = 418.9829*n - sum x_i*sin(sqrt(|x_i|)), минимум ~0 в (420.9687, ..., 420.9687)
+class SchwefelFuncND : public FunctionND {
+public:
+    explicit SchwefelFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+    bool isSeparable() const override { return true; }
+    double coordinateTerm(int j, double xj) const override;
+};
+
+// w_i = 1 + (x_i - 1) / 4;
+// f = sin^2(pi*w_1) + sum_{i<n} (w_i - 1)^2 * (1 + 10*sin^2(pi*w_i + 1))
+//     + (w_n - 1)^2 * (1 + sin^2(2*pi*w_n)), минимум 0 в (1, ..., 1)
+class LevyFuncND : public FunctionND {
+public:
+    explicit LevyFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+};
+
+// f = 0.5 * sum (x_i^4 - 16*x_i^2 + 5*x_i), минимум ~-39.166*n в (-2.9035, ..., -2.9035)
+class StyblinskiTangFuncND : public FunctionND {
+public:
+    explicit StyblinskiTangFuncND(int dim);
+    double operator()(const std::vector<double>& x) const override;
+    std::string getName() const override;
+    double valueAndGradient(const std::vector<double>& x, std::vector<double>& grad) const override;
+    void evaluateBatch(const double* points, size_t count, double* values) const override;
+    void gradientBatch(const double* points, size_t count, double* grads) const override;
+    std::vector<double> hessianVectorProduct(const std::vector<double>& x, const std::vector<double>& v) const override;
+    bool isSeparable() const override { return true; }
+    double coordinateTerm(int j, double xj) const override;
+};
+
+// Фиксированные размерности для консольного меню
+class SphereFunc3D : public SphereFuncND {
+public:
+    SphereFunc3D() : SphereFuncND(3) {}
+
+    // Невиртуальное вычисление для FixedOptim.h (T = double или Dual<3>)
+    template <class T>
+    T evaluate(const T* x) const {
+        return x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+    }
+};
+
+class RastriginFunc4D : public RastriginFuncND {
+public:
+    RastriginFunc4D() : RastriginFuncND(4) {}
+};
+
+#endif
@@ -0,0 +1,221 @@
+﻿#include "pch.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+// Пул и номер рабочего потока, выполняющего код; у посторонних потоков pool == nullptr
+struct WorkerSlot {
+    const ThreadPool* pool;
+    int index;
+};
+thread_local WorkerSlot currentSlot = { nullptr, -1 };
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads) : pending(0), pendingLocal(0), stopping(false) {
+    if (threads == 0) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        threads = cores > 1 ? cores - 1 : 0;
+    }
+    local.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        local.emplace_back(new Queue());
+    }
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, static_cast<size_t>(i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+int ThreadPool::currentWorker() const {
+    return currentSlot.pool == this ? currentSlot.index : -1;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentSlot.pool = this;
+    currentSlot.index = static_cast<int>(index);
+    std::function<void()> task;
+    for (;;) {
+        if (takeTask(task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeup.wait(lock, [this] { return stopping || pending.load() > 0; });
+        if (stopping && pending.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::push(std::vector<std::function<void()>>& batch) {
+    const int me = currentWorker();
+    Queue& queue = me >= 0 ? *local[me] : injected;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (std::function<void()>& task : batch) {
+            queue.tasks.push_back(std::move(task));
+        }
+        // Счётчики растут после вставки и до того, как задачу можно снять:
+        // pending > 0 означает, что задачу можно взять
+        if (me >= 0) {
+            pendingLocal.fetch_add(batch.size());
+        }
+        pending.fetch_add(batch.size());
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    wakeup.notify_all();
+}
+
+bool ThreadPool::takeTask(std::function<void()>& task, bool withInjected) {
+    const int me = currentWorker();
+    auto take = [this, &task](Queue& queue, bool back) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        if (back) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        if (&queue != &injected) {
+            pendingLocal.fetch_sub(1);
+        }
+        pending.fetch_sub(1);
+        return true;
+    };
+    // Своя очередь - с конца, общая и чужие - с начала (самые крупные задачи)
+    if (me >= 0 && take(*local[me], true)) {
+        return true;
+    }
+    if (withInjected && take(injected, false)) {
+        return true;
+    }
+    const size_t n = local.size();
+    const size_t first = me >= 0 ? static_cast<size_t>(me) + 1 : 0;
+    for (size_t k = 0; k < n; ++k) {
+        const size_t victim = (first + k) % n;
+        if (static_cast<int>(victim) != me && take(*local[victim], false)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runGroup(size_t parts, const std::function<void(size_t)>& part) {
+    struct Group {
+        std::atomic<size_t> next;       // следующая невзятая часть
+        std::atomic<size_t> remaining;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+    auto group = std::make_shared<Group>();
+    group->next = 0;
+    group->remaining = parts;
+
+    auto runPart = [this, group, &part](size_t k) {
+        try {
+            part(k);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(group->errorMutex);
+            if (!group->error) {
+                group->error = std::current_exception();
+            }
+        }
+        if (group->remaining.fetch_sub(1) == 1) {
+            // Блокировка исключает потерю пробуждения между проверкой и ожиданием
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeup.notify_all();
+        }
+    };
+
+    if (workers.empty()) {
+        for (size_t k = 0; k < parts; ++k) {
+            runPart(k);
+        }
+    }
+    else {
+        // Задача в очереди берёт очередную невзятую часть группы; если все части
+        // уже взяты (их выполнил сам вызывающий), задача пустая
+        const std::function<void()> claim = [runPart, group, parts] {
+            const size_t k = group->next.fetch_add(1);
+            if (k < parts) {
+                runPart(k);
+            }
+        };
+        std::vector<std::function<void()>> batch(parts - 1, claim);
+        push(batch);
+
+        for (size_t k; (k = group->next.fetch_add(1)) < parts;) {
+            runPart(k);
+        }
+
+        // Пока доделываются взятые другими части, помогаем с частями вложенных
+        // групп из очередей рабочих потоков. Общая очередь не просматривается:
+        // там независимая работа верхнего уровня (например, целый запуск
+        // мультистарта), которая задержала бы эту группу до своего конца
+        std::function<void()> task;
+        while (group->remaining.load() > 0) {
+            if (takeTask(task, false)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this, &group] {
+                return group->remaining.load() == 0 || pendingLocal.load() > 0;
+            });
+        }
+    }
+
+    if (group->error) {
+        std::rethrow_exception(group->error);
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    grain = (std::max)(grain, static_cast<size_t>(1));
+    // Несколько частей на поток сглаживают неравную стоимость частей
+    const size_t parts = (std::min)((count + grain - 1) / grain, static_cast<size_t>(size()) * 4);
+    if (parts <= 1 || workers.empty()) {
+        body(0, count);
+        return;
+    }
+    runGroup(parts, [&body, count, parts](size_t part) {
+        body(count * part / parts, count * (part + 1) / parts);
+    });
+}
+
+void ThreadPool::forEachTask(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    runGroup(count, task);
+}
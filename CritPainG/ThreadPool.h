@@ -0,0 +1,78 @@
+﻿#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing).
+//
+// У каждого рабочего потока своя очередь: задачи, порождённые в рабочем потоке
+// (вложенный parallelFor, например из функции, которая сама использует пул),
+// кладутся в его очередь, и он берёт их с конца - свежие части в кэше. Задачи
+// из посторонних потоков идут в общую очередь. Поток без работы берёт задачу
+// из общей очереди, а если она пуста - перехватывает самую старую задачу из
+// чужой очереди. Поэтому задачи очень разной длины (например, целые запуски
+// оптимизаторов в MultiStart) не оставляют ядра без дела.
+//
+// Вызывающий поток тоже выполняет части своей группы: он берёт их сам, пока
+// есть невзятые, а затем, ожидая чужие, помогает с частями вложенных групп из
+// очередей рабочих потоков. Задачи общей очереди он не берёт, поэтому поток,
+// занятый запуском мультистарта, не начинает внутри него другой запуск.
+class ThreadPool {
+public:
+    // threads - число рабочих потоков; 0 - по числу ядер минус вызывающий поток
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Число потоков, выполняющих parallelFor (рабочие + вызывающий)
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // body(begin, end) для частей [0, count) длиной не меньше grain.
+    // Возвращает управление после завершения всех частей; исключение из части
+    // пробрасывается вызывающему (первое, если их несколько).
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    // task(i) для i в [0, count) - каждая задача отдельно, без объединения в
+    // части; для немногих долгих задач неизвестной длины. Ошибки - как у parallelFor.
+    void forEachTask(size_t count, const std::function<void(size_t)>& task);
+
+    // Общий пул процесса
+    static ThreadPool& shared();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> local;  // очередь рабочего потока i
+    Queue injected;                             // задачи посторонних потоков
+    std::atomic<size_t> pending;                // задач во всех очередях
+    std::atomic<size_t> pendingLocal;           // из них в очередях рабочих потоков
+    std::mutex mutex;
+    std::condition_variable wakeup;   // новая задача, завершение группы или остановка
+    bool stopping;
+
+    void workerLoop(size_t index);
+    // Номер рабочего потока этого пула для текущего потока; -1 - посторонний
+    int currentWorker() const;
+    void push(std::vector<std::function<void()>>& batch);
+    // Без withInjected общая очередь не просматривается
+    bool takeTask(std::function<void()>& task, bool withInjected = true);
+    // part(k) для k в [0, parts); вызывающий берёт невзятые части сам и помогает
+    // до конца группы
+    void runGroup(size_t parts, const std::function<void(size_t)>& part);
+};
+
+#endif
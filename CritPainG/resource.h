@@ -98,6 +98,10 @@
 #define MAXIT                           1012
 #define FCHANGE                         1013
 #define XCHANGE                         1014
+#define FORMULA                         1015
+#define LBFGSB_RADIO                    1016
+#define PLUGINPATH                      1017
+#define PLUGINBROWSE                    1018
 #define ID_SETTINGS                     32771
 #define ID_START                        32772
 
@@ -107,7 +111,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        312
 #define _APS_NEXT_COMMAND_VALUE         32773
-#define _APS_NEXT_CONTROL_VALUE         1015
+#define _APS_NEXT_CONTROL_VALUE         1019
 #define _APS_NEXT_SYMED_VALUE           310
 #endif
 #endif
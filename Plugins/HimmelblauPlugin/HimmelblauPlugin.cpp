@@ -0,0 +1,60 @@
+﻿// Пример подключаемой целевой функции для CritPainG (C ABI из CritPainGPlugin.h).
+//
+// Функция Химмельблау: f(x, y) = (x^2 + y - 11)^2 + (x + y^2 - 7)^2, четыре
+// минимума со значением 0, один из них в (3, 2). Собранная библиотека
+// выбирается в диалоге настроек, поле "Plugin library".
+//
+// Библиотека задаёт все точки входа таблицы, включая градиенты; функции не
+// хранят состояния и допускают вызовы из нескольких потоков.
+
+#include "CritPainGPlugin.h"
+
+namespace {
+
+double value(double x, double y) {
+    const double a = x * x + y - 11.0;
+    const double b = x + y * y - 7.0;
+    return a * a + b * b;
+}
+
+void gradientAt(double x, double y, double& gx, double& gy) {
+    const double a = x * x + y - 11.0;
+    const double b = x + y * y - 7.0;
+    gx = 4.0 * x * a + 2.0 * b;
+    gy = 2.0 * a + 4.0 * y * b;
+}
+
+double evaluate(const double* x) {
+    return value(x[0], x[1]);
+}
+
+// Пакеты в раскладке SoA: x - points[0..count), y - points[count..2 count)
+void evaluateBatch(const double* points, size_t count, double* values) {
+    const double* x = points;
+    const double* y = points + count;
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = value(x[i], y[i]);
+    }
+}
+
+void gradient(const double* x, double* grad) {
+    gradientAt(x[0], x[1], grad[0], grad[1]);
+}
+
+void gradientBatch(const double* points, size_t count, double* grads) {
+    const double* x = points;
+    const double* y = points + count;
+    for (size_t i = 0; i < count; ++i) {
+        gradientAt(x[i], y[i], grads[i], grads[count + i]);
+    }
+}
+
+} // namespace
+
+CRITPAIN_PLUGIN_EXPORT const CritPainPlugin* critpain_plugin(void) {
+    static const CritPainPlugin plugin = {
+        CRITPAIN_PLUGIN_ABI_VERSION, 2, "Himmelblau: (x^2 + y - 11)^2 + (x + y^2 - 7)^2",
+        evaluate, evaluateBatch, gradient, gradientBatch
+    };
+    return &plugin;
+}
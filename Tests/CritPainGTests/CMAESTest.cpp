@@ -0,0 +1,175 @@
+﻿// Тесты CMAES с фиксированным seed: воспроизводимость, размеры популяций при
+// перезапусках IPOP и BIPOP, проекция поколений на параллелепипед
+
+#include "TestSupport.h"
+#include "CMAES.h"
+#include "TestFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Обёртка: получает поколение целым пакетом, запоминает размеры пакетов и
+// считает точки вне [lower, upper]
+class GenerationRecorder : public AbstrFunc {
+public:
+    GenerationRecorder(const AbstrFunc& f_, std::vector<double> lower_, std::vector<double> upper_)
+        : f(f_), lower(std::move(lower_)), upper(std::move(upper_)), outside(0) {}
+
+    double operator()(const std::vector<double>& x) const override { return f(x); }
+    std::vector<double> getGradient(const std::vector<double>& x) const override { return f.getGradient(x); }
+    std::string getName() const override { return f.getName(); }
+    int getDimension() const override { return f.getDimension(); }
+    void evaluateBatch(const double* points, size_t count, double* values) const override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sizes.push_back(static_cast<int>(count));
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t j = 0; j < lower.size(); ++j) {
+                    const double x = points[j * count + i];
+                    if (!(x >= lower[j] && x <= upper[j])) {
+                        ++outside;
+                        break;
+                    }
+                }
+            }
+        }
+        f.evaluateBatch(points, count, values);
+    }
+    bool prefersWholeBatch() const override { return true; }
+
+    // Размеры популяций запусков подряд (соседние поколения одного размера склеены)
+    std::vector<int> runSizes() const {
+        std::vector<int> runs;
+        for (int s : sizes) {
+            if (runs.empty() || runs.back() != s) runs.push_back(s);
+        }
+        return runs;
+    }
+
+    const AbstrFunc& f;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    mutable std::vector<int> sizes;
+    mutable long long outside;
+    mutable std::mutex mutex;
+};
+
+std::unique_ptr<const AbstrCriterial> maxIterations(int count) {
+    return std::make_unique<CriterialMaxIter>(nullptr, count);
+}
+
+// Сфера с минимумом в center
+class ShiftedSphere : public AbstrFunc {
+public:
+    explicit ShiftedSphere(std::vector<double> center_) : center(std::move(center_)) {}
+    double operator()(const std::vector<double>& x) const override {
+        double sum = 0.0;
+        for (size_t j = 0; j < x.size(); ++j) sum += (x[j] - center[j]) * (x[j] - center[j]);
+        return sum;
+    }
+    std::vector<double> getGradient(const std::vector<double>& x) const override {
+        std::vector<double> grad(x.size());
+        for (size_t j = 0; j < x.size(); ++j) grad[j] = 2.0 * (x[j] - center[j]);
+        return grad;
+    }
+    std::string getName() const override { return "shifted sphere"; }
+    int getDimension() const override { return static_cast<int>(center.size()); }
+
+private:
+    std::vector<double> center;
+};
+
+const int N = 4;
+const int DEFAULT_LAMBDA = 8;  // 4 + floor(3 ln 4)
+
+} // namespace
+
+TEST_CASE(CMAESFixedSeedIsReproducible) {
+    const RastriginFuncND f(N);
+    const std::vector<double> x0(N, 3.0), lower(N, -5.12), upper(N, 5.12);
+
+    auto runWith = [&](bool parallel) {
+        CMAES optimizer(&f, maxIterations(400), x0, lower, upper, 0.3, CMAESRestart::BIPOP, 2024u, 4);
+        PopulationOptions options;
+        options.parallel = parallel;
+        options.minParallelPoints = 1;
+        optimizer.setPopulationOptions(options);
+        AbstrOptim::Result result = optimizer.optimize();
+        return std::make_pair(result, optimizer.getRestartCount());
+    };
+    const auto a = runWith(true);
+    const auto b = runWith(true);
+    const auto c = runWith(false);
+
+    CHECK(a.first.point == b.first.point && a.first.value == b.first.value);
+    CHECK(a.first.iterations == b.first.iterations && a.second == b.second);
+    // Деление поколения по потокам не меняет ни выборку, ни значения
+    CHECK(a.first.point == c.first.point && a.first.value == c.first.value && a.second == c.second);
+}
+
+TEST_CASE(CMAESIPOPDoublesPopulation) {
+    const RastriginFuncND rastrigin(N);
+    const std::vector<double> x0(N, 3.0), lower(N, -5.12), upper(N, 5.12);
+    const GenerationRecorder f(rastrigin, lower, upper);
+
+    CMAES optimizer(&f, maxIterations(1000000), x0, lower, upper, 0.3, CMAESRestart::IPOP, 7u, 3);
+    const AbstrOptim::Result result = optimizer.optimize();
+
+    CHECK_MSG(result.stop_reason == "Restart limit reached", "stop reason: " << result.stop_reason);
+    CHECK(optimizer.getRestartCount() == 3);
+    CHECK(optimizer.getLastPopulationSize() == DEFAULT_LAMBDA << 3);
+    const std::vector<int> expected = { DEFAULT_LAMBDA, DEFAULT_LAMBDA << 1, DEFAULT_LAMBDA << 2, DEFAULT_LAMBDA << 3 };
+    CHECK(f.runSizes() == expected);
+    CHECK(f.outside == 0);
+}
+
+TEST_CASE(CMAESBIPOPInterleavesSmallRuns) {
+    const RastriginFuncND rastrigin(N);
+    const std::vector<double> x0(N, 3.0), lower(N, -5.12), upper(N, 5.12);
+    const GenerationRecorder f(rastrigin, lower, upper);
+
+    const int maxRestarts = 3;
+    CMAES optimizer(&f, maxIterations(1000000), x0, lower, upper, 0.3, CMAESRestart::BIPOP, 7u, maxRestarts);
+    const AbstrOptim::Result result = optimizer.optimize();
+
+    CHECK_MSG(result.stop_reason == "Restart limit reached", "stop reason: " << result.stop_reason);
+    // Малые запуски вставлены между большими
+    CHECK_MSG(optimizer.getRestartCount() > maxRestarts, "restarts " << optimizer.getRestartCount());
+
+    // Большие запуски идут по порядку 8, 16, 32, 64; малый запуск после k-го
+    // большого - не больше половины его популяции и не меньше lambda по умолчанию
+    int large = 0;
+    for (int size : f.sizes) {
+        CHECK_MSG(size >= DEFAULT_LAMBDA, "population " << size);
+        if (size == DEFAULT_LAMBDA << (large + 1)) {
+            ++large;
+        }
+        else {
+            CHECK_MSG(size == DEFAULT_LAMBDA << large || size <= (DEFAULT_LAMBDA << large) / 2,
+                "population " << size << " after large run " << large);
+        }
+    }
+    CHECK_MSG(large == maxRestarts, "large runs " << large);
+    CHECK(f.outside == 0);
+}
+
+TEST_CASE(CMAESProjectsOntoBox) {
+    // Минимум снаружи: решение в углу (1, 1, 1, 1)
+    const ShiftedSphere sphere({ 2.0, 3.0, 1.5, 4.0 });
+    const std::vector<double> x0(N, 0.0), lower(N, -1.0), upper(N, 1.0);
+    const GenerationRecorder f(sphere, lower, upper);
+
+    CMAES optimizer(&f, maxIterations(2000), x0, lower, upper, 0.3, CMAESRestart::None, 3u);
+    const AbstrOptim::Result result = optimizer.optimize();
+
+    CHECK(f.outside == 0);
+    CHECK_MSG(result.stop_reason == "Search distribution converged", "stop reason: " << result.stop_reason);
+    for (int j = 0; j < N; ++j) {
+        CHECK_MSG(std::fabs(result.point[j] - 1.0) < 1e-8, "j=" << j << ": " << result.point[j]);
+    }
+    CHECK(std::fabs(result.value - sphere(std::vector<double>(N, 1.0))) < 1e-8);
+}
@@ -0,0 +1,164 @@
+﻿// Тесты CachedFunc: попадания и промахи, вытеснение, раздельное хранение
+// значений и градиентов, предел памяти и одновременный доступ
+
+#include "TestSupport.h"
+#include "CachedFunc.h"
+#include "CountingFunc.h"
+#include "TestFunctions.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<double> point(double a, double b, double c) {
+    return std::vector<double>{ a, b, c };
+}
+
+// Значение из пакета (векторное ядро) может отличаться от скалярного в последних битах
+bool sameValue(double actual, double expected) {
+    return std::fabs(actual - expected) <= 1e-13 * (std::max)(1.0, std::fabs(expected));
+}
+
+bool sameGradient(const std::vector<double>& actual, const std::vector<double>& expected) {
+    if (actual.size() != expected.size()) return false;
+    for (size_t j = 0; j < actual.size(); ++j) {
+        if (!sameValue(actual[j], expected[j])) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(CachedFuncHitsAndMisses) {
+    const RosenbrockFuncND rosenbrock(3);
+    CountingFunc inner(&rosenbrock);
+    CachedFunc cached(&inner);
+
+    const std::vector<double> x = point(0.5, -1.0, 2.0);
+    CHECK(cached(x) == rosenbrock(x));
+    CHECK(cached(x) == rosenbrock(x));
+    CHECK(cached.hits() == 1 && cached.misses() == 1);
+    CHECK(inner.counts().values == 1);
+
+    // 0.0 и -0.0 - разные точки
+    cached(point(0.0, 1.0, 1.0));
+    cached(point(-0.0, 1.0, 1.0));
+    CHECK(inner.counts().values == 3);
+
+    // Пакет: известные точки из кэша, промахи - одним вызовом обёрнутой функции
+    const std::vector<double> points = { 0.5, 0.0, 3.0, -1.0, 1.0, 3.0, 2.0, 1.0, 3.0 };  // SoA, 3 точки
+    std::vector<double> values(3);
+    inner.reset();
+    cached.evaluateBatch(points.data(), 3, values.data());
+    CHECK(values[0] == rosenbrock(x));
+    CHECK(values[2] == rosenbrock(point(3.0, 3.0, 3.0)));
+    CHECK(inner.counts().values == 1 && inner.counts().batchCalls == 1);
+    cached.evaluateBatch(points.data(), 3, values.data());
+    CHECK(inner.counts().values == 1 && inner.counts().batchCalls == 1);
+
+    cached.clear();
+    CHECK(cached.hits() == 0 && cached.misses() == 0);
+    cached(x);
+    CHECK(cached.misses() == 1);
+}
+
+TEST_CASE(CachedFuncGradientOnlyMissSkipsValue) {
+    const RosenbrockFuncND rosenbrock(3);
+    const CountingFunc inner(&rosenbrock);
+    const CachedFunc cached(&inner);
+    const std::vector<double> x = point(-1.2, 1.0, 0.3);
+
+    CHECK(cached.getGradient(x) == rosenbrock.getGradient(x));
+    CHECK(inner.counts().gradients == 1 && inner.counts().values == 0);
+    CHECK(cached.getGradient(x) == rosenbrock.getGradient(x));
+    CHECK(inner.counts().gradients == 1);
+
+    // Значения ещё нет: valueAndGradient вычисляет оба, дальше всё из кэша
+    std::vector<double> grad;
+    CHECK(cached.valueAndGradient(x, grad) == rosenbrock(x));
+    CHECK(inner.counts().values == 1 && inner.counts().gradients == 2);
+    CHECK(cached(x) == rosenbrock(x));
+    CHECK(cached.valueAndGradient(x, grad) == rosenbrock(x));
+    CHECK(grad == rosenbrock.getGradient(x));
+    CHECK(inner.counts().values == 1 && inner.counts().gradients == 2);
+
+    // Градиенты пакета тоже сохраняются
+    const std::vector<double> points = { 0.5, 2.0, -1.0, 1.0, 1.0, 0.0 };  // SoA, 2 точки
+    std::vector<double> grads(6);
+    cached.gradientBatch(points.data(), 2, grads.data());
+    CHECK(cached.getGradient(point(0.5, -1.0, 1.0)) == rosenbrock.getGradient(point(0.5, -1.0, 1.0)));
+    CHECK(inner.counts().gradients == 2 + 2);
+}
+
+TEST_CASE(CachedFuncEvictsWithinBucket) {
+    const SphereFuncND sphere(3);
+    const CountingFunc inner(&sphere);
+    const CachedFunc cached(&inner, CachedFunc::WAYS, 1);  // одна корзина
+    CHECK(cached.capacity() == static_cast<size_t>(CachedFunc::WAYS));
+
+    for (int k = 0; k <= CachedFunc::WAYS; ++k) {
+        cached(point(k, 0.0, 0.0));
+    }
+    CHECK(inner.counts().values == CachedFunc::WAYS + 1);
+    // Вытеснена самая старая точка, остальные на месте
+    for (int k = 1; k <= CachedFunc::WAYS; ++k) {
+        cached(point(k, 0.0, 0.0));
+    }
+    CHECK(inner.counts().values == CachedFunc::WAYS + 1);
+    CHECK(cached(point(0.0, 0.0, 0.0)) == 0.0);
+    CHECK(inner.counts().values == CachedFunc::WAYS + 2);
+}
+
+TEST_CASE(CachedFuncRespectsMemoryLimit) {
+    const int dimension = 100000;
+    const SphereFuncND sphere(dimension);
+    const CachedFunc cached(&sphere);
+    const size_t slotBytes = 2 * sizeof(double) * dimension;
+    CHECK(cached.capacity() >= static_cast<size_t>(CachedFunc::WAYS));
+    CHECK(cached.capacity() * slotBytes <= CachedFunc::DEFAULT_MAX_BYTES);
+
+    const std::vector<double> x(dimension, 0.5);
+    CHECK(cached(x) == sphere(x));
+    CHECK(cached(x) == sphere(x));
+    CHECK(cached.hits() == 1);
+}
+
+TEST_CASE(CachedFuncConcurrentAccess) {
+    const RosenbrockFuncND rosenbrock(3);
+    const CachedFunc cached(&rosenbrock, 64, 4);  // мало места: вытеснение во время работы
+    const int threads = 4;
+    const int rounds = 2000;
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::vector<double> points(3 * 5), values(5);
+            for (int r = 0; r < rounds; ++r) {
+                // Точки потоков пересекаются: k зависит от r, а не от t
+                const std::vector<double> x = point((r + t) % 97 * 0.1, r % 13 * 0.2, -0.5);
+                if (!sameValue(cached(x), rosenbrock(x))) ++wrong;
+                if (r % 3 == 0 && !sameGradient(cached.getGradient(x), rosenbrock.getGradient(x))) ++wrong;
+                for (int i = 0; i < 5; ++i) {
+                    points[i] = (r + i) % 97 * 0.1;
+                    points[5 + i] = i * 0.2;
+                    points[10 + i] = -0.5;
+                }
+                cached.evaluateBatch(points.data(), 5, values.data());
+                for (int i = 0; i < 5; ++i) {
+                    if (!sameValue(values[i], rosenbrock(point(points[i], points[5 + i], points[10 + i])))) ++wrong;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    CHECK(wrong.load() == 0);
+    // Каждый поиск - ровно одно попадание или промах
+    const size_t lookups = threads * (rounds + (rounds + 2) / 3 + 5 * rounds);
+    CHECK(cached.hits() + cached.misses() == lookups);
+    CHECK(cached.hits() > 0);
+}
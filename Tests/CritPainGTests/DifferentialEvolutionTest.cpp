@@ -0,0 +1,89 @@
+﻿// Тесты DifferentialEvolution с фиксированным seed: адаптация F и CR в JADE и
+// независимость результата от деления поколения по потокам
+
+#include "TestSupport.h"
+#include "DifferentialEvolution.h"
+#include "TestFunctions.h"
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const int N = 10;
+
+// Задача Швефеля 1.2: sum_i (sum_{j <= i} x_j)^2, координаты сильно связаны
+class Schwefel12 : public AbstrFunc {
+public:
+    double operator()(const std::vector<double>& x) const override {
+        double sum = 0.0, partial = 0.0;
+        for (double xj : x) {
+            partial += xj;
+            sum += partial * partial;
+        }
+        return sum;
+    }
+    std::vector<double> getGradient(const std::vector<double>&) const override {
+        throw std::logic_error("no gradient");
+    }
+    std::string getName() const override { return "Schwefel 1.2"; }
+    int getDimension() const override { return N; }
+};
+
+AbstrOptim::Result runDE(const AbstrFunc& f, DEStrategy strategy, unsigned int seed, int generations,
+    bool parallel, double F, double CR, double* meanF = nullptr, double* meanCR = nullptr) {
+    DifferentialEvolution optimizer(&f, std::make_unique<CriterialMaxIter>(nullptr, generations),
+        std::vector<double>(N, 2.0), std::vector<double>(N, -5.0), std::vector<double>(N, 5.0),
+        strategy, 0, F, CR, seed);
+    PopulationOptions options;
+    options.parallel = parallel;
+    options.minParallelPoints = 1;
+    optimizer.setPopulationOptions(options);
+    AbstrOptim::Result result = optimizer.optimize();
+    if (meanF) *meanF = optimizer.getMeanF();
+    if (meanCR) *meanCR = optimizer.getMeanCR();
+    return result;
+}
+
+} // namespace
+
+TEST_CASE(DEResultIndependentOfThreads) {
+    const RastriginFuncND f(N);
+    for (DEStrategy strategy : { DEStrategy::Rand1, DEStrategy::CurrentToBest1, DEStrategy::JADE }) {
+        double fSerial = 0.0, crSerial = 0.0, fParallel = 0.0, crParallel = 0.0;
+        const AbstrOptim::Result serial = runDE(f, strategy, 42u, 150, false, 0.5, 0.9, &fSerial, &crSerial);
+        const AbstrOptim::Result parallel = runDE(f, strategy, 42u, 150, true, 0.5, 0.9, &fParallel, &crParallel);
+        const AbstrOptim::Result again = runDE(f, strategy, 42u, 150, true, 0.5, 0.9);
+
+        const int s = static_cast<int>(strategy);
+        CHECK_MSG(serial.point == parallel.point && serial.value == parallel.value,
+            "strategy " << s << ": serial " << serial.value << " parallel " << parallel.value);
+        CHECK(serial.iterations == parallel.iterations && serial.stop_reason == parallel.stop_reason);
+        CHECK_MSG(fSerial == fParallel && crSerial == crParallel, "strategy " << s);
+        CHECK_MSG(parallel.point == again.point && parallel.value == again.value, "strategy " << s);
+    }
+}
+
+TEST_CASE(DEJADEAdaptsToSeparability) {
+    // Из mu_CR = 0.5: на сепарабельной функции удачны малые CR (меняется
+    // одна-две координаты), на связанной - большие
+    const RastriginFuncND separable(N);
+    const Schwefel12 coupled;
+    for (unsigned int seed : { 1u, 2u, 3u }) {
+        double fSeparable = 0.0, crSeparable = 0.0, fCoupled = 0.0, crCoupled = 0.0;
+        const AbstrOptim::Result a = runDE(separable, DEStrategy::JADE, seed, 300, true, 0.5, 0.5, &fSeparable, &crSeparable);
+        const AbstrOptim::Result b = runDE(coupled, DEStrategy::JADE, seed, 300, true, 0.5, 0.5, &fCoupled, &crCoupled);
+
+        CHECK_MSG(crSeparable < 0.3, "seed " << seed << ": separable mu_CR " << crSeparable);
+        CHECK_MSG(crCoupled > 0.7, "seed " << seed << ": coupled mu_CR " << crCoupled);
+        CHECK_MSG(fSeparable > 0.0 && fSeparable <= 1.0 && fCoupled > 0.0 && fCoupled <= 1.0,
+            "seed " << seed << ": mu_F " << fSeparable << ", " << fCoupled);
+        CHECK_MSG(a.value < 0.1, "seed " << seed << ": separable value " << a.value);
+        CHECK_MSG(b.value < 1e-8, "seed " << seed << ": coupled value " << b.value);
+    }
+
+    // Для Rand1 и CurrentToBest1 параметры не меняются
+    double meanF = 0.0, meanCR = 0.0;
+    runDE(separable, DEStrategy::Rand1, 1u, 50, true, 0.6, 0.7, &meanF, &meanCR);
+    CHECK(meanF == 0.6 && meanCR == 0.7);
+}
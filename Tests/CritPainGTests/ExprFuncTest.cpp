@@ -0,0 +1,131 @@
+﻿// Тесты ExprFunc: символьный градиент и произведение гессиана на вектор против
+// конечных разностей, пакет против отдельных точек (несколько блоков
+// expr::Program::BLOCK и неполный последний) и ошибки разбора
+
+#include "TestSupport.h"
+#include "ExprFunc.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Все функции и операции языка; общие подвыражения (x-z, y*z) встречаются дважды
+const char* const FORMULA =
+    "(x-3)^2 + sin(y)*y + cos(2*pi*z)*x + exp(0.1*x*y) + log(1+z^2) + sqrt(2+x^2)"
+    " + abs(y) + sign(x)*x + atan(x-z) + tanh(y*z) + tan(0.2*x) + 2^-x^2"
+    " + (1+z^2)^(0.5+0.1*x) - x/(3+y^2) + e*(x-z)*y*z";
+
+const std::vector<double> POINT = { 0.7, -1.3, 0.4 };
+
+bool close(double a, double b, double tolerance) {
+    return std::fabs(a - b) <= tolerance * (std::max)(1.0, std::fabs(b));
+}
+
+std::vector<double> centralDifference(const AbstrFunc& f, std::vector<double> x, double h) {
+    std::vector<double> grad(x.size());
+    for (size_t j = 0; j < x.size(); ++j) {
+        const double xj = x[j];
+        x[j] = xj + h;
+        const double fp = f(x);
+        x[j] = xj - h;
+        const double fm = f(x);
+        x[j] = xj;
+        grad[j] = (fp - fm) / (2.0 * h);
+    }
+    return grad;
+}
+
+} // namespace
+
+TEST_CASE(ExprGradientMatchesFiniteDifference) {
+    const ExprFunc f(FORMULA);
+    CHECK(f.getDimension() == 3);
+
+    std::vector<double> grad;
+    const double value = f.valueAndGradient(POINT, grad);
+    CHECK_MSG(value == f(POINT), "value " << value << " vs " << f(POINT));
+    CHECK(grad == f.getGradient(POINT));
+
+    const std::vector<double> fd = centralDifference(f, POINT, 1e-6);
+    for (size_t j = 0; j < POINT.size(); ++j) {
+        CHECK_MSG(close(grad[j], fd[j], 1e-6), "j=" << j << ": symbolic " << grad[j] << " fd " << fd[j]);
+    }
+}
+
+TEST_CASE(ExprHessianVectorProductMatchesFiniteDifference) {
+    const ExprFunc f(FORMULA);
+    const std::vector<double> v = { 0.3, -1.1, 0.8 };
+    const std::vector<double> hv = f.hessianVectorProduct(POINT, v);
+
+    // (H v)_j ~ (grad(x + h v) - grad(x - h v))_j / 2h
+    const double h = 1e-5;
+    std::vector<double> plus = POINT, minus = POINT;
+    for (size_t j = 0; j < v.size(); ++j) {
+        plus[j] += h * v[j];
+        minus[j] -= h * v[j];
+    }
+    const std::vector<double> gp = f.getGradient(plus);
+    const std::vector<double> gm = f.getGradient(minus);
+    for (size_t j = 0; j < v.size(); ++j) {
+        const double fd = (gp[j] - gm[j]) / (2.0 * h);
+        CHECK_MSG(close(hv[j], fd, 1e-6), "j=" << j << ": symbolic " << hv[j] << " fd " << fd);
+    }
+}
+
+TEST_CASE(ExprBatchMatchesScalar) {
+    const ExprFunc f(FORMULA);
+    const int n = f.getDimension();
+    // Два полных блока и неполный третий
+    const size_t count = 2 * expr::Program::BLOCK + 37;
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+    std::vector<double> points(static_cast<size_t>(n) * count);
+    for (double& p : points) p = dist(gen);
+
+    std::vector<double> values(count), grads(points.size());
+    f.evaluateBatch(points.data(), count, values.data());
+    f.gradientBatch(points.data(), count, grads.data());
+
+    // sin и cos пакета идут через simd::sincos2pi, отсюда допуск в несколько ulp
+    std::vector<double> x(n);
+    for (size_t i = 0; i < count; ++i) {
+        for (int j = 0; j < n; ++j) x[j] = points[j * count + i];
+        std::vector<double> grad;
+        const double value = f.valueAndGradient(x, grad);
+        CHECK_MSG(close(values[i], value, 1e-13), "point " << i << ": batch " << values[i] << " scalar " << value);
+        for (int j = 0; j < n; ++j) {
+            CHECK_MSG(close(grads[j * count + i], grad[j], 1e-13),
+                "point " << i << " j=" << j << ": batch " << grads[j * count + i] << " scalar " << grad[j]);
+        }
+    }
+}
+
+TEST_CASE(ExprParseErrors) {
+    CHECK_THROWS(ExprFunc(""), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("x +"), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("(x - 1"), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("x $ 2"), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("foo(x)"), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("x0 + 1"), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("q * x"), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("x) + 1"), std::invalid_argument);
+    // Переменная за пределами заданной размерности
+    CHECK_THROWS(ExprFunc("x1 + x3", 2), std::invalid_argument);
+    CHECK_THROWS(ExprFunc("x + y")(std::vector<double>(3, 0.0)), std::invalid_argument);
+
+    // Сообщение указывает позицию ошибки
+    std::string message;
+    try {
+        ExprFunc("x + sinh(y)");
+    }
+    catch (const std::invalid_argument& e) {
+        message = e.what();
+    }
+    CHECK_MSG(message.find("position 5") != std::string::npos && message.find("sinh") != std::string::npos,
+        "message: " << message);
+}
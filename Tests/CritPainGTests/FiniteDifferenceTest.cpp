@@ -0,0 +1,169 @@
+﻿// Тесты численного градиента: точность схем, число вычислений, точное
+// округление шагов и совпадение последовательного и параллельного расчёта
+
+#include "TestSupport.h"
+#include "FiniteDifference.h"
+#include "CountingFunc.h"
+#include "TestFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const double EPS = std::numeric_limits<double>::epsilon();
+
+// f(x) = sum_j exp(0.1 (j + 1) x_j) + sin(x_j) x_{j+1}; градиент только для
+// сравнения (getGradient бросает, как у функции без аналитического градиента)
+class ValueOnly : public AbstrFunc {
+public:
+    explicit ValueOnly(int dimension_) : dimension(dimension_) {}
+
+    double operator()(const std::vector<double>& x) const override {
+        double sum = 0.0;
+        for (int j = 0; j < dimension; ++j) {
+            sum += std::exp(0.1 * (j + 1) * x[j]) + std::sin(x[j]) * x[(j + 1) % dimension];
+        }
+        return sum;
+    }
+    std::vector<double> getGradient(const std::vector<double>&) const override {
+        throw std::logic_error("no gradient");
+    }
+    std::string getName() const override { return "value only"; }
+    int getDimension() const override { return dimension; }
+
+    std::vector<double> exactGradient(const std::vector<double>& x) const {
+        std::vector<double> grad(dimension);
+        for (int j = 0; j < dimension; ++j) {
+            const int prev = (j + dimension - 1) % dimension;
+            grad[j] = 0.1 * (j + 1) * std::exp(0.1 * (j + 1) * x[j])
+                + std::cos(x[j]) * x[(j + 1) % dimension] + std::sin(x[prev]);
+        }
+        return grad;
+    }
+
+private:
+    int dimension;
+};
+
+std::vector<double> testPoint(int dimension) {
+    std::vector<double> x(dimension);
+    for (int j = 0; j < dimension; ++j) x[j] = 1.7 * std::sin(0.9 * j + 0.3);
+    return x;
+}
+
+double maxError(const std::vector<double>& a, const std::vector<double>& b) {
+    double error = 0.0;
+    for (size_t j = 0; j < a.size(); ++j) {
+        error = (std::max)(error, std::fabs(a[j] - b[j]) / (std::max)(1.0, std::fabs(b[j])));
+    }
+    return error;
+}
+
+FiniteDifferenceOptions options(DifferenceScheme scheme, bool parallel) {
+    FiniteDifferenceOptions o;
+    o.scheme = scheme;
+    o.parallel = parallel;
+    o.minParallelPoints = 1;
+    return o;
+}
+
+} // namespace
+
+TEST_CASE(CentralDifferenceMoreAccurateThanForward) {
+    const ValueOnly f(6);
+    const std::vector<double> x = testPoint(6);
+    const std::vector<double> exact = f.exactGradient(x);
+
+    const double forward = maxError(finiteDifferenceGradient(f, x, options(DifferenceScheme::Forward, false)), exact);
+    const double central = maxError(finiteDifferenceGradient(f, x, options(DifferenceScheme::Central, false)), exact);
+
+    // O(h) с h ~ sqrt(eps) и O(h^2) с h ~ cbrt(eps)
+    CHECK_MSG(forward < 1e-6, "forward error " << forward);
+    CHECK_MSG(central < 1e-9, "central error " << central);
+    CHECK_MSG(central < forward, "central " << central << " forward " << forward);
+}
+
+TEST_CASE(FiniteDifferenceEvaluationCounts) {
+    const int n = 7;
+    const ValueOnly inner(n);
+    const std::vector<double> x = testPoint(n);
+    const double fx = inner(x);
+
+    struct Case { DifferenceScheme scheme; int kind; long long expected; };
+    // kind: 0 - градиент, 1 - градиент при известном f(x), 2 - значение и градиент
+    const Case cases[] = {
+        { DifferenceScheme::Forward, 0, n + 1 },
+        { DifferenceScheme::Forward, 1, n },
+        { DifferenceScheme::Forward, 2, n + 1 },
+        { DifferenceScheme::Central, 0, 2 * n },
+        { DifferenceScheme::Central, 1, 2 * n },
+        { DifferenceScheme::Central, 2, 2 * n + 1 },
+    };
+    for (const Case& c : cases) {
+        const CountingFunc f(&inner);
+        const FiniteDifferenceOptions o = options(c.scheme, false);
+        std::vector<double> grad;
+        if (c.kind == 0) grad = finiteDifferenceGradient(f, x, o);
+        else if (c.kind == 1) grad = finiteDifferenceGradient(f, x, fx, o);
+        else CHECK(finiteDifferenceValueAndGradient(f, x, grad, o) == fx);
+
+        const EvaluationCounts counts = f.counts();
+        CHECK_MSG(counts.values == c.expected && counts.finiteDifference == c.expected && counts.batchCalls == 1,
+            "scheme " << static_cast<int>(c.scheme) << " kind " << c.kind << ": values " << counts.values
+            << " fd " << counts.finiteDifference << " batches " << counts.batchCalls << ", expected " << c.expected);
+        CHECK(grad.size() == static_cast<size_t>(n));
+    }
+
+    // Аналитический градиент численный путь не трогает
+    const SphereFuncND sphere(n);
+    const CountingFunc counted(&sphere);
+    std::vector<double> grad;
+    evaluateWithGradient(counted, x, grad);
+    CHECK(counted.counts().finiteDifference == 0);
+    CHECK(grad == sphere.getGradient(x));
+}
+
+TEST_CASE(FiniteDifferenceStepsRoundExactly) {
+    const std::vector<double> x = { 0.0, 0.1, -3.7, 1.0 / 3.0, 1e8 + 0.3, -2.5e-7, 123456.789, 1e-300 };
+    for (DifferenceScheme scheme : { DifferenceScheme::Forward, DifferenceScheme::Central }) {
+        for (double step : { 0.0, 1e-5, 3e-9 }) {
+            const std::vector<double> steps = finiteDifferenceSteps(x, scheme, step);
+            for (size_t j = 0; j < x.size(); ++j) {
+                const double h = steps[j];
+                CHECK_MSG(h > 0.0 && (x[j] + h) - x[j] == h,
+                    "x=" << x[j] << " step " << step << ": h " << h << ", (x + h) - x = " << (x[j] + h) - x[j]);
+                // Не дальше одного ulp x_j от заказанного шага
+                const double relative = step > 0.0 ? step
+                    : scheme == DifferenceScheme::Forward ? std::sqrt(EPS) : std::cbrt(EPS);
+                const double wanted = relative * (std::max)(std::fabs(x[j]), 1.0);
+                CHECK_MSG(std::fabs(h - wanted) <= std::fabs(x[j] + wanted) * EPS,
+                    "x=" << x[j] << ": h " << h << " wanted " << wanted);
+            }
+        }
+    }
+}
+
+TEST_CASE(FiniteDifferenceSerialMatchesParallel) {
+    // Функция по точкам: деление пакета не меняет ни одного значения
+    const int n = 50;
+    const ValueOnly f(n);
+    const std::vector<double> x = testPoint(n);
+    for (DifferenceScheme scheme : { DifferenceScheme::Forward, DifferenceScheme::Central }) {
+        std::vector<double> serialGrad, parallelGrad;
+        const double serial = finiteDifferenceValueAndGradient(f, x, serialGrad, options(scheme, false));
+        const double parallel = finiteDifferenceValueAndGradient(f, x, parallelGrad, options(scheme, true));
+        CHECK(serial == parallel);
+        CHECK_MSG(serialGrad == parallelGrad, "scheme " << static_cast<int>(scheme) << ": max difference "
+            << maxError(serialGrad, parallelGrad));
+    }
+
+    // Векторная функция: хвосты частей пакета могут идти другим путём ядра
+    const RastriginFuncND rastrigin(n);
+    const std::vector<double> serialGrad = finiteDifferenceGradient(rastrigin, x, options(DifferenceScheme::Central, false));
+    const std::vector<double> parallelGrad = finiteDifferenceGradient(rastrigin, x, options(DifferenceScheme::Central, true));
+    CHECK_MSG(maxError(serialGrad, parallelGrad) < 1e-8, "max difference " << maxError(serialGrad, parallelGrad));
+    CHECK_MSG(maxError(serialGrad, rastrigin.getGradient(x)) < 1e-6, "error " << maxError(serialGrad, rastrigin.getGradient(x)));
+}
@@ -0,0 +1,69 @@
+﻿// Тесты FixedOptim.h на SphereFunc3D: градиент Dual<3>, сходимость и совпадение
+// с оптимизаторами общего вида, которые консольное меню использует для прочих функций
+
+#include "TestSupport.h"
+#include "FixedOptim.h"
+#include "TestFunctions.h"
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const std::vector<double> START = { 1.5, -2.0, 0.7 };
+const std::vector<double> LOWER = { -3.0, -3.0, -3.0 };
+const std::vector<double> UPPER = { 3.0, 3.0, 3.0 };
+
+std::unique_ptr<const AbstrCriterial> maxIterations(int count) {
+    return std::make_unique<CriterialMaxIter>(nullptr, count);
+}
+
+} // namespace
+
+TEST_CASE(FixedSphere3DGradientMatchesAnalytic) {
+    const SphereFunc3D f;
+    const FixedPoint<3> x = toFixedPoint<3>(START);
+    FixedPoint<3> grad;
+    const double value = fixedValueAndGradient<3>(f, x, grad);
+
+    CHECK_MSG(std::fabs(value - f(START)) < 1e-14, "value " << value << " vs " << f(START));
+    const std::vector<double> expected = f.getGradient(START);
+    for (int j = 0; j < 3; ++j) {
+        CHECK_MSG(std::fabs(grad[j] - expected[j]) < 1e-14,
+            "j=" << j << " dual " << grad[j] << " analytic " << expected[j]);
+    }
+}
+
+TEST_CASE(FixedConjugateGradientMatchesGeneric) {
+    const SphereFunc3D f;
+    ConjugateGradientFRConstrainedFixed<3, SphereFunc3D> fixed(&f, maxIterations(200), START, LOWER, UPPER, 1e-8);
+    ConjugateGradientFRConstrained generic(&f, maxIterations(200), START, LOWER, UPPER, 1e-6, 100, 1e-8);
+
+    const AbstrOptim::Result a = fixed.optimize();
+    const AbstrOptim::Result b = generic.optimize();
+
+    CHECK_MSG(a.value < 1e-14, "fixed value " << a.value);
+    CHECK_MSG(b.value < 1e-14, "generic value " << b.value);
+    CHECK_MSG(a.stop_reason == b.stop_reason, a.stop_reason << " vs " << b.stop_reason);
+    for (int j = 0; j < 3; ++j) {
+        CHECK_MSG(std::fabs(a.point[j] - b.point[j]) < 1e-7, "j=" << j << ": " << a.point[j] << " vs " << b.point[j]);
+    }
+    // Вычисления в обход counter всё равно учтены
+    CHECK(a.function_evaluations > 0);
+    CHECK(a.gradient_evaluations > 0);
+}
+
+TEST_CASE(FixedRandomSearchStaysInBoxAndConverges) {
+    const SphereFunc3D f;
+    RandomSearchOptimFixed<3, SphereFunc3D> optimizer(&f, maxIterations(3000), START, LOWER, UPPER, 0.5, 7u);
+    const AbstrOptim::Result result = optimizer.optimize();
+
+    CHECK_MSG(result.value < 1e-2, "value " << result.value);
+    CHECK_MSG(std::fabs(result.value - f(result.point)) < 1e-14, "reported " << result.value << " actual " << f(result.point));
+    for (const std::vector<double>& point : result.trajectory) {
+        for (int j = 0; j < 3; ++j) {
+            CHECK_MSG(point[j] >= LOWER[j] && point[j] <= UPPER[j], "coordinate " << j << " = " << point[j]);
+        }
+    }
+    CHECK(result.function_evaluations > 0);
+}
@@ -0,0 +1,94 @@
+﻿// Тесты ForwardAD.h: градиент FunctionFromTemplate против конечных разностей,
+// в том числе степени с отрицательным основанием
+
+#include "TestSupport.h"
+#include "ForwardAD.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Все элементарные функции Dual; pow с показателем того же типа T, как его
+// пишут в шаблонных функторах
+struct Mixed {
+    template <class T>
+    T operator()(const T* x, int n) const {
+        using std::sin; using std::cos; using std::tan; using std::exp; using std::log;
+        using std::sqrt; using std::atan; using std::tanh; using std::pow; using std::fabs;
+        T sum = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const T y = x[i];
+            const T z = x[(i + 1) % n];
+            sum += sin(y) * cos(z) + tan(0.3 * y) + exp(0.1 * y) / (2.0 + z * z)
+                + log(1.5 + y * y) + sqrt(3.0 + z) + atan(y - z) + tanh(y * z) + fabs(y)
+                + pow(y, T(3)) + pow(z, 2) + pow(2.0 + y * y, 1.5)
+                + pow(1.5 + z * z, 0.5 + 0.1 * y * y) + pow(2.0, z) - 4.0 / (3.0 + y * y);
+        }
+        return sum;
+    }
+};
+
+std::vector<double> centralDifference(const AbstrFunc& f, std::vector<double> x, double h) {
+    std::vector<double> grad(x.size());
+    for (size_t j = 0; j < x.size(); ++j) {
+        const double xj = x[j];
+        x[j] = xj + h;
+        const double fp = f(x);
+        x[j] = xj - h;
+        const double fm = f(x);
+        x[j] = xj;
+        grad[j] = (fp - fm) / (2.0 * h);
+    }
+    return grad;
+}
+
+template <int W>
+void checkAgainstFiniteDifference(const std::vector<double>& x) {
+    const auto f = makeFunctionFromTemplate<W>(Mixed(), static_cast<int>(x.size()), "Mixed");
+    std::vector<double> grad;
+    const double value = f.valueAndGradient(x, grad);
+    CHECK_MSG(value == f(x), "W=" << W << ": dual value " << value << " vs " << f(x));
+
+    const std::vector<double> fd = centralDifference(f, x, 1e-6);
+    for (size_t j = 0; j < x.size(); ++j) {
+        CHECK_MSG(std::isfinite(grad[j]) && std::fabs(grad[j] - fd[j]) <= 1e-6 * (std::max)(1.0, std::fabs(fd[j])),
+            "W=" << W << " j=" << j << " x=" << x[j] << ": dual " << grad[j] << " fd " << fd[j]);
+    }
+}
+
+} // namespace
+
+TEST_CASE(DualGradientMatchesFiniteDifference) {
+    // Половина координат отрицательна; 11 не делится на W, последний проход неполный
+    std::vector<double> x(11);
+    for (size_t j = 0; j < x.size(); ++j) x[j] = (j % 2 == 0 ? -1.0 : 1.0) * (0.4 + 0.13 * j);
+
+    checkAgainstFiniteDifference<1>(x);
+    checkAgainstFiniteDifference<4>(x);
+    checkAgainstFiniteDifference<8>(x);
+}
+
+TEST_CASE(DualPowerOfNegativeBase) {
+    Dual<2> a(-2.0);
+    a.d[0] = 1.0;
+    Dual<2> b(3.0);
+    b.d[1] = 1.0;
+
+    // Постоянный показатель: d(a^3)/da = 3 a^2
+    const Dual<2> cube = pow(a, Dual<2>(3.0));
+    CHECK(cube.v == -8.0);
+    CHECK(cube.d[0] == 12.0);
+    CHECK(cube.d[1] == 0.0);
+
+    // Производная по показателю при отрицательном основании не определена
+    // и опускается вместо NaN
+    const Dual<2> both = pow(a, b);
+    CHECK(both.v == -8.0);
+    CHECK(both.d[0] == 12.0);
+    CHECK(both.d[1] == 0.0);
+
+    const Dual<2> zeroBase = pow(0.0, b);
+    CHECK(zeroBase.v == 0.0);
+    CHECK(zeroBase.d[1] == 0.0);
+}
@@ -0,0 +1,71 @@
+﻿// Тесты StrongWolfeLineSearch: когда поиск останавливается на лучшей точке с
+// условием Армихо, её состояние восстанавливается без повторного вычисления
+
+#include "TestSupport.h"
+#include "LineSearch.h"
+#include "CountingFunc.h"
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// f(x) = (x - 1)^2; вдоль p = 1 из x = 0 минимум при шаге 1
+class ShiftedSquare : public AbstrFunc {
+public:
+    double operator()(const std::vector<double>& x) const override { return (x[0] - 1.0) * (x[0] - 1.0); }
+    std::vector<double> getGradient(const std::vector<double>& x) const override { return { 2.0 * (x[0] - 1.0) }; }
+    std::string getName() const override { return "shifted square"; }
+    int getDimension() const override { return 1; }
+};
+
+// f(x) = -x: условие Армихо выполняется всегда, условие кривизны - никогда
+class Linear : public AbstrFunc {
+public:
+    double operator()(const std::vector<double>& x) const override { return -x[0]; }
+    std::vector<double> getGradient(const std::vector<double>&) const override { return { -1.0 }; }
+    std::string getName() const override { return "linear"; }
+    int getDimension() const override { return 1; }
+};
+
+} // namespace
+
+TEST_CASE(StrongWolfeZoomKeepsBestArmijoPoint) {
+    const ShiftedSquare square;
+    const CountingFunc f(&square);
+    const std::vector<double> x = { 0.0 };
+    const std::vector<double> p = { 1.0 };
+    VectorLineFunction phi(f, FiniteDifferenceOptions(), x, p);
+
+    // Шаг 0.5 проходит Армихо, расширение до 2 - нет; интервал [0.5, 2] уже
+    // не шире tolerance, и zoom сразу возвращает 0.5
+    const StrongWolfeLineSearch search(1e-4, 0.1, 50, 1.0);
+    const LineSearchResult result = search.search(phi, f(x), phi.initialSlope(f.getGradient(x)), 0.5);
+
+    CHECK(result.accepted);
+    CHECK(result.step == 0.5);
+    CHECK(result.value == 0.25);
+    CHECK_MSG(result.evaluations == 2, "evaluations " << result.evaluations);
+    CHECK_MSG(f.counts().values == 3, "values " << f.counts().values);
+    CHECK(phi.point[0] == 0.5);
+    CHECK(phi.gradient[0] == -1.0);
+}
+
+TEST_CASE(StrongWolfeBudgetKeepsLastExpansionPoint) {
+    const Linear linear;
+    const CountingFunc f(&linear);
+    const std::vector<double> x = { 0.0 };
+    const std::vector<double> p = { 1.0 };
+    VectorLineFunction phi(f, FiniteDifferenceOptions(), x, p);
+
+    // Шаги 1, 4, 16, 64; на пятый бюджета нет
+    const StrongWolfeLineSearch search(1e-4, 0.1, 4);
+    const LineSearchResult result = search.search(phi, 0.0, -1.0, 1.0);
+
+    CHECK(result.accepted);
+    CHECK_MSG(result.step == 64.0, "step " << result.step);
+    CHECK(result.value == -64.0);
+    CHECK_MSG(result.evaluations == 4, "evaluations " << result.evaluations);
+    CHECK_MSG(f.counts().values == 4, "values " << f.counts().values);
+    CHECK(phi.point[0] == 64.0);
+    CHECK(phi.gradient[0] == -1.0);
+}
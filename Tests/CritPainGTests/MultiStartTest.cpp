@@ -0,0 +1,193 @@
+﻿// Тесты мультистарта: неудачные запуски, выбор лучшего запуска (порядок NaN)
+// и вложенные вычисления поколения внутри задач forEachTask
+
+#include "TestSupport.h"
+#include "MultiStart.h"
+#include "DifferentialEvolution.h"
+#include "TestFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+const double Inf = std::numeric_limits<double>::infinity();
+
+// Оптимизатор без вычислений: сразу возвращает заданное значение в x0
+class FixedValueOptim : public AbstrOptim {
+    double value;
+public:
+    FixedValueOptim(const AbstrFunc* f, const std::vector<double>& x0, double v)
+        : AbstrOptim(f, std::make_unique<CriterialMaxIter>(nullptr, 1), x0), value(v) {}
+protected:
+    Result run() override { return Result(initialPoint, value, 0, "fixed", {}); }
+};
+
+std::vector<std::vector<double>> startsFor(size_t count) {
+    std::vector<std::vector<double>> starts;
+    for (size_t i = 0; i < count; ++i) {
+        starts.push_back({ static_cast<double>(i), -static_cast<double>(i) });
+    }
+    return starts;
+}
+
+// Мультистарт запусков с заранее заданными значениями
+MultiStartResult runFixed(const AbstrFunc& f, const std::vector<double>& values, ThreadPool& pool) {
+    const OptimizerFactory factory = [&](const std::vector<double>& x0, size_t run) {
+        return std::unique_ptr<AbstrOptim>(new FixedValueOptim(&f, x0, values[run]));
+    };
+    return runMultiStart(factory, startsFor(values.size()), pool);
+}
+
+// Делит пакет на части в том же пуле, что выполняет запуски мультистарта
+class PoolSplittingFunc : public AbstrFunc {
+    const AbstrFunc& inner;
+    ThreadPool& pool;
+public:
+    PoolSplittingFunc(const AbstrFunc& f, ThreadPool& p) : inner(f), pool(p) {}
+    double operator()(const std::vector<double>& x) const override { return inner(x); }
+    std::vector<double> getGradient(const std::vector<double>& x) const override { return inner.getGradient(x); }
+    std::string getName() const override { return inner.getName(); }
+    int getDimension() const override { return inner.getDimension(); }
+    void evaluateBatch(const double* points, size_t count, double* values) const override {
+        // Точки пакета хранятся по координатам: points[j * count + i]
+        const size_t n = static_cast<size_t>(getDimension());
+        pool.parallelFor(count, 1, [&](size_t begin, size_t end) {
+            const size_t m = end - begin;
+            std::vector<double> part(n * m);
+            for (size_t j = 0; j < n; ++j) {
+                std::copy(points + j * count + begin, points + j * count + end, part.begin() + j * m);
+            }
+            inner.evaluateBatch(part.data(), m, values + begin);
+        });
+    }
+};
+
+std::unique_ptr<AbstrOptim> makeDE(const AbstrFunc& f, const std::vector<double>& x0, size_t run, bool parallel) {
+    const size_t n = x0.size();
+    std::unique_ptr<DifferentialEvolution> optimizer(new DifferentialEvolution(&f,
+        std::make_unique<CriterialMaxIter>(nullptr, 60), x0,
+        std::vector<double>(n, -5.0), std::vector<double>(n, 5.0),
+        DEStrategy::JADE, 0, 0.5, 0.9, 1000u + static_cast<unsigned int>(run)));
+    PopulationOptions options;
+    options.parallel = parallel;
+    options.minParallelPoints = 1;
+    optimizer->setPopulationOptions(options);
+    return optimizer;
+}
+
+bool sameRuns(const MultiStartResult& multi, const std::vector<AbstrOptim::Result>& expected) {
+    if (multi.runs.size() != expected.size()) return false;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (multi.runs[i].point != expected[i].point || multi.runs[i].value != expected[i].value
+            || multi.runs[i].iterations != expected[i].iterations) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(MultiStartFailedRunsAreRecorded) {
+    const SphereFuncND f(2);
+    ThreadPool pool(3);
+    const std::vector<std::vector<double>> starts = startsFor(4);
+    const OptimizerFactory factory = [&](const std::vector<double>& x0, size_t run) -> std::unique_ptr<AbstrOptim> {
+        if (run == 0) throw std::runtime_error("bad start");
+        if (run == 2) return nullptr;
+        return std::unique_ptr<AbstrOptim>(new FixedValueOptim(&f, x0, 10.0 - static_cast<double>(run)));
+    };
+    const MultiStartResult result = runMultiStart(factory, starts, pool);
+
+    CHECK(result.runs.size() == 4);
+    for (size_t run : { size_t(0), size_t(2) }) {
+        const AbstrOptim::Result& failed = result.runs[run];
+        CHECK_MSG(failed.value == Inf, "run " << run << " value " << failed.value);
+        CHECK_MSG(failed.stop_reason.compare(0, 11, "Run failed:") == 0, "run " << run << ": " << failed.stop_reason);
+        CHECK(failed.point == starts[run]);
+    }
+    CHECK(result.runs[0].stop_reason.find("bad start") != std::string::npos);
+    CHECK(result.runs[2].stop_reason.find("null") != std::string::npos);
+    CHECK(result.runs[1].value == 9.0 && result.runs[3].value == 7.0);
+    CHECK(result.bestRun == 3);
+    CHECK(result.best.value == 7.0 && result.best.point == starts[3]);
+
+    const OptimizerFactory failing = [](const std::vector<double>&, size_t) -> std::unique_ptr<AbstrOptim> {
+        throw std::runtime_error("always");
+    };
+    CHECK_THROWS(runMultiStart(failing, starts, pool), std::runtime_error);
+    CHECK_THROWS(runMultiStart(factory, { starts[0] }, pool), std::runtime_error);
+}
+
+TEST_CASE(MultiStartPicksBestRun) {
+    const SphereFuncND f(2);
+    ThreadPool pool(3);
+
+    // NaN хуже любого числа, при равенстве - меньший номер
+    MultiStartResult result = runFixed(f, { NaN, 3.0, 1.0, 1.0, NaN, 2.0 }, pool);
+    CHECK_MSG(result.bestRun == 2, "bestRun " << result.bestRun);
+    CHECK(result.best.value == 1.0 && result.best.point == result.runs[2].point);
+
+    result = runFixed(f, { 5.0, NaN, -Inf, NaN }, pool);
+    CHECK(result.bestRun == 2);
+
+    result = runFixed(f, { Inf, NaN, Inf }, pool);
+    CHECK_MSG(result.bestRun == 0, "bestRun " << result.bestRun);
+
+    // Все значения NaN - первый запуск
+    result = runFixed(f, { NaN, NaN, NaN }, pool);
+    CHECK(result.bestRun == 0 && std::isnan(result.best.value));
+
+    // Неудачный запуск не выбирается, даже если остальные дали NaN
+    const OptimizerFactory factory = [&](const std::vector<double>& x0, size_t run) {
+        if (run == 0) throw std::runtime_error("bad start");
+        return std::unique_ptr<AbstrOptim>(new FixedValueOptim(&f, x0, NaN));
+    };
+    result = runMultiStart(factory, startsFor(3), pool);
+    CHECK_MSG(result.bestRun == 1, "bestRun " << result.bestRun);
+}
+
+TEST_CASE(MultiStartNestedPopulationMatchesSequential) {
+    const int n = 6;
+    const RastriginFuncND rastrigin(n);
+    ThreadPool pool(3);
+    const std::vector<std::vector<double>> starts =
+        multiStartPoints(std::vector<double>(n, 2.0), std::vector<double>(n, -5.0), std::vector<double>(n, 5.0), 5, 7u);
+
+    std::vector<AbstrOptim::Result> expected;
+    for (size_t run = 0; run < starts.size(); ++run) {
+        expected.push_back(makeDE(rastrigin, starts[run], run, false)->optimize());
+    }
+
+    // evaluatePopulation в ThreadPool::shared() внутри задач другого пула
+    const MultiStartResult nestedShared = runMultiStart([&](const std::vector<double>& x0, size_t run) {
+        return makeDE(rastrigin, x0, run, true);
+    }, starts, pool);
+    CHECK(sameRuns(nestedShared, expected));
+
+    // Пакеты делятся в том же пуле, что выполняет запуски
+    const PoolSplittingFunc splitting(rastrigin, pool);
+    const MultiStartResult nestedSame = runMultiStart([&](const std::vector<double>& x0, size_t run) {
+        return makeDE(splitting, x0, run, false);
+    }, starts, pool);
+    CHECK(sameRuns(nestedSame, expected));
+
+    // И то и другое в общем пуле
+    const PoolSplittingFunc splittingShared(rastrigin, ThreadPool::shared());
+    const MultiStartResult nestedBoth = runMultiStart([&](const std::vector<double>& x0, size_t run) {
+        return makeDE(splittingShared, x0, run, true);
+    }, starts);
+    CHECK(sameRuns(nestedBoth, expected));
+
+    size_t best = 0;
+    for (size_t run = 1; run < expected.size(); ++run) {
+        if (expected[run].value < expected[best].value) best = run;
+    }
+    CHECK(nestedBoth.bestRun == best && nestedBoth.best.value == expected[best].value);
+}
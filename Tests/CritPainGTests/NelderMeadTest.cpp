@@ -0,0 +1,132 @@
+﻿// Тесты NelderMead: все вычисляемые точки внутри параллелепипеда (в том числе
+// начальный симплекс с большим шагом и точки сжатия у границы), редукция и
+// сходимость, Розенброк с ограничениями
+
+#include "TestSupport.h"
+#include "NelderMead.h"
+#include "TestFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Обёртка, проверяющая, что каждая вычисляемая точка лежит в [lower, upper]
+class BoxCheckingFunc : public AbstrFunc {
+public:
+    BoxCheckingFunc(const AbstrFunc& f_, std::vector<double> lower_, std::vector<double> upper_)
+        : f(f_), lower(std::move(lower_)), upper(std::move(upper_)), evaluations(0), outside(0) {}
+
+    double operator()(const std::vector<double>& x) const override {
+        check(x);
+        return f(x);
+    }
+    std::vector<double> getGradient(const std::vector<double>& x) const override { return f.getGradient(x); }
+    std::string getName() const override { return f.getName(); }
+    int getDimension() const override { return f.getDimension(); }
+    void evaluateBatch(const double* points, size_t count, double* values) const override {
+        std::vector<double> x(lower.size());
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < x.size(); ++j) x[j] = points[j * count + i];
+            check(x);
+        }
+        f.evaluateBatch(points, count, values);
+    }
+
+    const AbstrFunc& f;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    mutable long long evaluations;
+    mutable long long outside;
+
+private:
+    void check(const std::vector<double>& x) const {
+        ++evaluations;
+        for (size_t j = 0; j < x.size(); ++j) {
+            if (!(x[j] >= lower[j] && x[j] <= upper[j])) {
+                ++outside;
+                return;
+            }
+        }
+    }
+};
+
+// Функция типа Маккиннона: разная кривизна по обе стороны x = 0, на которой
+// сжатия не помогают и симплекс редуцируется. Минимум -1/4 в (0, -1/2)
+class McKinnonLike : public AbstrFunc {
+public:
+    double operator()(const std::vector<double>& x) const override {
+        const double a = x[0];
+        return (a <= 0.0 ? 360.0 * a * a : 6.0 * a * a) + x[1] + x[1] * x[1];
+    }
+    std::vector<double> getGradient(const std::vector<double>&) const override {
+        throw std::logic_error("no gradient");
+    }
+    std::string getName() const override { return "McKinnon-like"; }
+    int getDimension() const override { return 2; }
+};
+
+std::unique_ptr<const AbstrCriterial> maxIterations(int count) {
+    return std::make_unique<CriterialMaxIter>(nullptr, count);
+}
+
+} // namespace
+
+TEST_CASE(NelderMeadEvaluatesOnlyInsideBox) {
+    // Минимум сферы снаружи, и шаг 0.8 ширины из середины по x_1 выходит за обе
+    // границы; до исправления начальная вершина попадала ниже lb
+    const SphereFuncND sphere(3);
+    const std::vector<double> lower = { 0.0, 0.0, 0.0 };
+    const std::vector<double> upper = { 1.0, 1.0, 1.0 };
+    const std::vector<double> x0 = { 0.5, 0.9, 0.1 };
+    const BoxCheckingFunc f(sphere, lower, upper);
+
+    for (double step : { 0.1, 0.5, 0.8, 1.0 }) {
+        NelderMead optimizer(&f, maxIterations(500), x0, lower, upper, step);
+        const AbstrOptim::Result result = optimizer.optimize();
+        CHECK_MSG(f.outside == 0, "step " << step << ": " << f.outside << " of " << f.evaluations << " points outside");
+        CHECK_MSG(result.value < 1e-10, "step " << step << ": value " << result.value);
+    }
+}
+
+TEST_CASE(NelderMeadShrinksAndConverges) {
+    const McKinnonLike f;
+    for (bool adaptive : { true, false }) {
+        NelderMead optimizer(&f, maxIterations(20000), { 1.0, 1.0 }, 0.1, adaptive);
+        optimizer.setTolerances(1e-9, 1e-12);
+        const AbstrOptim::Result result = optimizer.optimize();
+
+        CHECK_MSG(optimizer.getShrinkCount() > 0, "adaptive " << adaptive << ": shrinks " << optimizer.getShrinkCount());
+        CHECK_MSG(result.stop_reason == "Simplex converged", "adaptive " << adaptive << ": " << result.stop_reason);
+        CHECK_MSG(std::fabs(result.value + 0.25) < 1e-9 && std::fabs(result.point[0]) < 1e-4
+            && std::fabs(result.point[1] + 0.5) < 1e-4,
+            "adaptive " << adaptive << ": value " << result.value << " at (" << result.point[0] << ", " << result.point[1] << ")");
+        CHECK(result.value == f(result.point));
+    }
+}
+
+TEST_CASE(NelderMeadRosenbrockWithBounds) {
+    const RosenbrockFuncND rosenbrock(2);
+
+    // Минимум (1, 1) внутри параллелепипеда
+    {
+        NelderMead optimizer(&rosenbrock, maxIterations(5000), { -1.2, 1.0 }, { -2.0, -2.0 }, { 2.0, 2.0 });
+        const AbstrOptim::Result result = optimizer.optimize();
+        CHECK_MSG(std::fabs(result.point[0] - 1.0) < 1e-5 && std::fabs(result.point[1] - 1.0) < 1e-5,
+            "point (" << result.point[0] << ", " << result.point[1] << "), " << result.stop_reason);
+    }
+
+    // x_1 <= 0.5 отсекает минимум: решение на границе, (0.5, 0.25)
+    {
+        const std::vector<double> lower = { -2.0, -2.0 };
+        const std::vector<double> upper = { 0.5, 2.0 };
+        const BoxCheckingFunc f(rosenbrock, lower, upper);
+        NelderMead optimizer(&f, maxIterations(5000), { -1.2, 1.0 }, lower, upper);
+        const AbstrOptim::Result result = optimizer.optimize();
+        CHECK(f.outside == 0);
+        CHECK_MSG(std::fabs(result.point[0] - 0.5) < 1e-5 && std::fabs(result.point[1] - 0.25) < 1e-5,
+            "point (" << result.point[0] << ", " << result.point[1] << "), " << result.stop_reason);
+    }
+}
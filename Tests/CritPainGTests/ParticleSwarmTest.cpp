@@ -0,0 +1,88 @@
+﻿// Тесты ParticleSwarm с фиксированным seed: одна и та же траектория на каждом
+// уровне SIMD (случайные числа побитно совпадают, положения - до округления FMA)
+
+#include "TestSupport.h"
+#include "ParticleSwarm.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Значения по точкам без векторных ядер, чтобы от уровня зависело только
+// обновление роя. Минимум 0 в (1, -2, 0.5, 3, -1, 2)
+class ShiftedQuadratic : public AbstrFunc {
+public:
+    double operator()(const std::vector<double>& x) const override {
+        static const double center[] = { 1.0, -2.0, 0.5, 3.0, -1.0, 2.0 };
+        double sum = 0.0;
+        for (size_t j = 0; j < x.size(); ++j) sum += (j + 1) * (x[j] - center[j]) * (x[j] - center[j]);
+        return sum;
+    }
+    std::vector<double> getGradient(const std::vector<double>&) const override {
+        throw std::logic_error("no gradient");
+    }
+    std::string getName() const override { return "shifted quadratic"; }
+    int getDimension() const override { return 6; }
+};
+
+AbstrOptim::Result runSwarm(const AbstrFunc& f, simd::Level level, int iterations) {
+    const simd::Level previous = simd::activeLevel();
+    simd::setActiveLevel(level);
+    const int n = f.getDimension();
+    // 37 частиц: полные векторы AVX2 и AVX-512 и хвост
+    ParticleSwarm optimizer(&f, std::make_unique<CriterialMaxIter>(nullptr, iterations),
+        std::vector<double>(n, 0.0), std::vector<double>(n, -5.0), std::vector<double>(n, 5.0),
+        37, 0.7298, 1.49618, 1.49618, 99u);
+    AbstrOptim::Result result = optimizer.optimize();
+    simd::setActiveLevel(previous);
+    return result;
+}
+
+double relativeDistance(const std::vector<double>& a, const std::vector<double>& b) {
+    double d = 0.0;
+    for (size_t j = 0; j < a.size(); ++j) {
+        d = (std::max)(d, std::fabs(a[j] - b[j]) / (std::max)(1.0, std::fabs(b[j])));
+    }
+    return d;
+}
+
+} // namespace
+
+TEST_CASE(ParticleSwarmSameTrajectoryAtEveryLevel) {
+    const ShiftedQuadratic f;
+    const int iterations = 40;
+    const AbstrOptim::Result reference = runSwarm(f, simd::Level::Scalar, iterations);
+
+    for (int l = 0; l <= static_cast<int>(simd::detectedLevel()); ++l) {
+        const simd::Level level = static_cast<simd::Level>(l);
+        const AbstrOptim::Result result = runSwarm(f, level, iterations);
+        const char* name = simd::levelName(level);
+
+        // Одни и те же улучшения глобально лучшей точки в том же порядке
+        CHECK_MSG(result.trajectory.size() == reference.trajectory.size(),
+            name << ": " << result.trajectory.size() << " trajectory points vs " << reference.trajectory.size());
+        CHECK_MSG(result.iterations == reference.iterations, name);
+        // Начальное поколение строит uniformFill, побитно одинаковый на всех уровнях
+        CHECK_MSG(result.trajectory.front() == reference.trajectory.front(), name);
+        const size_t common = (std::min)(result.trajectory.size(), reference.trajectory.size());
+        for (size_t k = 0; k < common; ++k) {
+            const double d = relativeDistance(result.trajectory[k], reference.trajectory[k]);
+            CHECK_MSG(d < 1e-9, name << ", trajectory point " << k << ": distance " << d);
+        }
+        CHECK_MSG(std::fabs(result.value - reference.value) <= 1e-9 * (std::max)(1.0, reference.value),
+            name << ": value " << result.value << " vs " << reference.value);
+    }
+}
+
+TEST_CASE(ParticleSwarmConvergesAtEveryLevel) {
+    const ShiftedQuadratic f;
+    for (int l = 0; l <= static_cast<int>(simd::detectedLevel()); ++l) {
+        const simd::Level level = static_cast<simd::Level>(l);
+        const AbstrOptim::Result result = runSwarm(f, level, 600);
+        CHECK_MSG(result.value < 1e-8, simd::levelName(level) << ": value " << result.value);
+    }
+}
@@ -0,0 +1,87 @@
+﻿// Тесты evaluatePopulation: деление поколения по потокам и целые пакеты для
+// функций с prefersWholeBatch()
+
+#include "TestSupport.h"
+#include "Population.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// f(x) = sum_j (j + 1) x_j; запоминает число пакетов и наибольший пакет
+class RecordingFunc : public AbstrFunc {
+public:
+    RecordingFunc(int dimension_, bool wholeBatch_)
+        : dimension(dimension_), wholeBatch(wholeBatch_), calls(0), largest(0) {}
+
+    double operator()(const std::vector<double>& x) const override {
+        double sum = 0.0;
+        for (int j = 0; j < dimension; ++j) sum += (j + 1) * x[j];
+        return sum;
+    }
+    std::vector<double> getGradient(const std::vector<double>&) const override {
+        throw std::logic_error("no gradient");
+    }
+    std::string getName() const override { return "recording"; }
+    int getDimension() const override { return dimension; }
+    void evaluateBatch(const double* points, size_t count, double* values) const override {
+        calls.fetch_add(1);
+        size_t seen = largest.load();
+        while (count > seen && !largest.compare_exchange_weak(seen, count)) {}
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = 0.0;
+            for (int j = 0; j < dimension; ++j) values[i] += (j + 1) * points[j * count + i];
+        }
+    }
+    bool prefersWholeBatch() const override { return wholeBatch; }
+
+    int dimension;
+    bool wholeBatch;
+    mutable std::atomic<int> calls;
+    mutable std::atomic<size_t> largest;
+};
+
+std::vector<double> generation(size_t dim, size_t count) {
+    std::vector<double> points(dim * count);
+    for (size_t k = 0; k < points.size(); ++k) {
+        points[k] = static_cast<double>(k % 13) - 6.0;
+    }
+    return points;
+}
+
+} // namespace
+
+TEST_CASE(PopulationSplitsAcrossThreads) {
+    const size_t dim = 3;
+    const size_t count = 100;
+    const std::vector<double> points = generation(dim, count);
+    const RecordingFunc f(static_cast<int>(dim), false);
+    std::vector<double> values(count);
+    evaluatePopulation(f, points.data(), dim, count, values.data());
+
+    const RecordingFunc serial(static_cast<int>(dim), false);
+    std::vector<double> expected(count);
+    serial.evaluateBatch(points.data(), count, expected.data());
+    CHECK(values == expected);
+    if (ThreadPool::shared().size() > 1) {
+        CHECK(f.calls.load() > 1);
+        CHECK(f.largest.load() < count);
+    }
+    else {
+        CHECK(f.calls.load() == 1);
+    }
+}
+
+TEST_CASE(PopulationPassesWholeBatchWhenPreferred) {
+    const size_t dim = 3;
+    const size_t count = 100;
+    const std::vector<double> points = generation(dim, count);
+    const RecordingFunc f(static_cast<int>(dim), true);
+    std::vector<double> values(count);
+    evaluatePopulation(f, points.data(), dim, count, values.data());
+    CHECK(f.calls.load() == 1);
+    CHECK(f.largest.load() == count);
+    CHECK(values[7] == f(std::vector<double>{ points[7], points[count + 7], points[2 * count + 7] }));
+}
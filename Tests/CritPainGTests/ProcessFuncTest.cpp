@@ -0,0 +1,150 @@
+﻿// Тесты ProcessFunc на вычислителе-заглушке RosenbrockWorker, который лежит
+// рядом с исполняемым файлом тестов
+
+#include "TestSupport.h"
+#include "../RosenbrockWorker/RosenbrockWorker.h"
+#include "ProcessFunc.h"
+#include "CountingFunc.h"
+#include "FiniteDifference.h"
+#include "TestFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const int DIMENSION = 4;
+
+std::string workerCommand(int dimension = DIMENSION) {
+#ifdef _WIN32
+    return "\"" + testDirectory() + "RosenbrockWorker.exe\" " + std::to_string(dimension);
+#else
+    return "'" + testDirectory() + "RosenbrockWorker' " + std::to_string(dimension);
+#endif
+}
+
+ProcessPoolOptions poolOptions(int workers) {
+    ProcessPoolOptions options;
+    options.workers = workers;
+    options.depth = 2;
+    options.maxPointsPerRequest = 8;  // пакеты ниже делятся на много запросов
+    return options;
+}
+
+// Случайные точки SoA: count точек, координата j - в строке j
+std::vector<double> randomPoints(size_t count, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> coordinate(-2.0, 2.0);
+    std::vector<double> points(count * DIMENSION);
+    for (double& value : points) {
+        value = coordinate(generator);
+    }
+    return points;
+}
+
+bool nearlyEqual(double actual, double expected, double tolerance) {
+    return std::fabs(actual - expected) <= tolerance * (std::max)(1.0, std::fabs(expected));
+}
+
+// Пакет в пуле совпадает с вычислением в процессе тестов
+void checkBatch(const ProcessFunc& f, size_t count, unsigned seed) {
+    const RosenbrockFuncND local(DIMENSION);
+    const std::vector<double> points = randomPoints(count, seed);
+    std::vector<double> values(count);
+    std::vector<double> expected(count);
+    f.evaluateBatch(points.data(), count, values.data());
+    local.evaluateBatch(points.data(), count, expected.data());
+    for (size_t i = 0; i < count; ++i) {
+        CHECK_MSG(nearlyEqual(values[i], expected[i], 1e-14), "point " << i << ": " << values[i] << " vs " << expected[i]);
+    }
+}
+
+} // namespace
+
+TEST_CASE(ProcessFuncBatchMatchesInProcess) {
+    const ProcessFunc f(workerCommand(), poolOptions(2));
+    CHECK(f.getDimension() == DIMENSION);
+    CHECK(f.workerCount() == 2);
+    checkBatch(f, 203, 1);  // 25 полных запросов и хвост из 3 точек
+    checkBatch(f, 1, 2);
+    f.evaluateBatch(nullptr, 0, nullptr);
+}
+
+TEST_CASE(ProcessFuncScalarAndFiniteDifferenceGradient) {
+    const ProcessFunc f(workerCommand(), poolOptions(2));
+    const RosenbrockFuncND local(DIMENSION);
+    const std::vector<double> x = { -1.2, 1.0, 0.5, -0.3 };
+    CHECK(nearlyEqual(f(x), local(x), 1e-14));
+    CHECK_THROWS(f.getGradient(x), std::logic_error);
+    CHECK_THROWS(f(std::vector<double>(DIMENSION + 1, 0.0)), std::invalid_argument);
+
+    std::vector<double> expected;
+    local.valueAndGradient(x, expected);
+    FiniteDifferenceOptions options;
+    options.minParallelPoints = 1;  // точки уходят в пул из нескольких потоков
+    const std::vector<double> gradient = finiteDifferenceGradient(f, x, options);
+    CHECK(gradient.size() == expected.size());
+    for (size_t j = 0; j < expected.size(); ++j) {
+        CHECK_MSG(nearlyEqual(gradient[j], expected[j], 1e-7), "coordinate " << j << ": " << gradient[j] << " vs " << expected[j]);
+    }
+}
+
+TEST_CASE(ProcessFuncFiniteDifferenceUsesWholePool) {
+    const int dimension = 40;  // 80 точек центральной схемы - больше minParallelPoints
+    const ProcessFunc f(workerCommand(dimension), poolOptions(3));
+    const CountingFunc counted(&f);
+    CHECK(counted.prefersWholeBatch());
+
+    std::vector<double> x(dimension);
+    for (int j = 0; j < dimension; ++j) {
+        x[j] = 0.1 * (j % 7) - 0.3;
+    }
+    const std::vector<double> gradient = finiteDifferenceGradient(counted, x);
+    // Шаблон не делится по потокам, а целиком уходит в пул из трёх процессов
+    CHECK(counted.counts().batchCalls == 1);
+    CHECK(counted.counts().finiteDifference == 2 * dimension);
+
+    const RosenbrockFuncND local(dimension);
+    std::vector<double> expected;
+    local.valueAndGradient(x, expected);
+    for (int j = 0; j < dimension; ++j) {
+        CHECK_MSG(nearlyEqual(gradient[j], expected[j], 1e-7), "coordinate " << j << ": " << gradient[j] << " vs " << expected[j]);
+    }
+    CHECK(f.workerCount() == 3);
+}
+
+TEST_CASE(ProcessFuncReportsWorkerError) {
+    const ProcessFunc f(workerCommand(), poolOptions(2));
+    std::vector<double> x(DIMENSION, 0.5);
+    x[0] = STUB_FAIL_VALUE;
+    CHECK_THROWS(f(x), std::runtime_error);
+
+    std::vector<double> points = randomPoints(40, 3);
+    points[17] = STUB_FAIL_VALUE;
+    std::vector<double> values(40);
+    CHECK_THROWS(f.evaluateBatch(points.data(), 40, values.data()), std::runtime_error);
+
+    // Ошибка вычисления не ломает процесс: пул цел и работает
+    CHECK(f.workerCount() == 2);
+    checkBatch(f, 40, 4);
+}
+
+TEST_CASE(ProcessFuncDropsDeadWorker) {
+    const ProcessFunc f(workerCommand(), poolOptions(3));
+    CHECK(f.workerCount() == 3);
+
+    std::vector<double> points = randomPoints(64, 5);
+    points[30] = STUB_EXIT_VALUE;
+    std::vector<double> values(64);
+    CHECK_THROWS(f.evaluateBatch(points.data(), 64, values.data()), std::runtime_error);
+    CHECK(f.workerCount() == 2);
+
+    // Следующие пакеты и скалярные вызовы идут в оставшиеся процессы
+    checkBatch(f, 64, 6);
+    const RosenbrockFuncND local(DIMENSION);
+    const std::vector<double> x(DIMENSION, 1.5);
+    CHECK(nearlyEqual(f(x), local(x), 1e-14));
+    CHECK(f.workerCount() == 2);
+}
@@ -0,0 +1,140 @@
+﻿// Тесты ReverseAD.h: градиент против конечных разностей, вложенная запись на
+// ленту и сопряжённые градиенты на Розенброке с 10^5 переменных
+
+#include "TestSupport.h"
+#include "ReverseAD.h"
+#include "AbstrOptim.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Обобщённая функция Розенброка, шаблон для TapedFunction
+struct Rosenbrock {
+    template <class T>
+    T operator()(const T* x, int n) const {
+        T sum = 0.0;
+        for (int i = 0; i + 1 < n; ++i) {
+            const T a = x[i + 1] - x[i] * x[i];
+            const T b = 1.0 - x[i];
+            sum += 100.0 * a * a + b * b;
+        }
+        return sum;
+    }
+};
+
+// Нелинейная смесь операций, покрывающая все частные производные Var
+struct Mixed {
+    template <class T>
+    T operator()(const T* x, int n) const {
+        using std::sin; using std::cos; using std::exp; using std::log;
+        using std::sqrt; using std::atan; using std::tanh; using std::pow;
+        T sum = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const T y = x[i];
+            const T z = x[(i + 1) % n];
+            sum += sin(y) * cos(z) + exp(0.1 * y) / (2.0 + z * z)
+                + log(1.5 + y * y) + sqrt(3.0 + z) + atan(y - z) + tanh(y * z)
+                + pow(2.0 + y * y, 1.5) + pow(1.5 + z * z, 0.5 + 0.1 * y * y);
+        }
+        return sum;
+    }
+};
+
+// sum x_j^2 + inner(p) * x_0: посреди записи вызывает градиент другой
+// TapedFunction того же типа (inner == nullptr на последнем уровне)
+struct Nested {
+    const AbstrFunc* inner;
+    std::vector<double> innerPoint;
+
+    template <class T>
+    T operator()(const T* x, int n) const {
+        T sum = 0.0;
+        for (int j = 0; j < n; ++j) sum += x[j] * x[j];
+        if (inner) {
+            std::vector<double> g;
+            sum += inner->valueAndGradient(innerPoint, g) * x[0];
+        }
+        return sum;
+    }
+};
+
+std::vector<double> centralDifference(const AbstrFunc& f, std::vector<double> x, double h) {
+    std::vector<double> grad(x.size());
+    for (size_t j = 0; j < x.size(); ++j) {
+        const double xj = x[j];
+        x[j] = xj + h;
+        const double fp = f(x);
+        x[j] = xj - h;
+        const double fm = f(x);
+        x[j] = xj;
+        grad[j] = (fp - fm) / (2.0 * h);
+    }
+    return grad;
+}
+
+void checkAgainstFiniteDifference(const AbstrFunc& f, const std::vector<double>& x, double tolerance) {
+    std::vector<double> grad;
+    const double value = f.valueAndGradient(x, grad);
+    CHECK_MSG(std::fabs(value - f(x)) <= 1e-12 * (std::max)(1.0, std::fabs(value)),
+        f.getName() << ": taped value " << value << " vs " << f(x));
+    const std::vector<double> fd = centralDifference(f, x, 1e-6);
+    for (size_t j = 0; j < x.size(); ++j) {
+        CHECK_MSG(std::fabs(grad[j] - fd[j]) <= tolerance * (std::max)(1.0, std::fabs(fd[j])),
+            f.getName() << " j=" << j << ": taped " << grad[j] << " fd " << fd[j]);
+    }
+}
+
+} // namespace
+
+TEST_CASE(TapedGradientMatchesFiniteDifference) {
+    const int n = 25;
+    std::vector<double> x(n);
+    for (int j = 0; j < n; ++j) x[j] = 0.3 * std::sin(1.7 * j) + 0.1 * j / n;
+
+    checkAgainstFiniteDifference(makeTapedFunction(Rosenbrock(), n, "Rosenbrock"), x, 1e-6);
+    checkAgainstFiniteDifference(makeTapedFunction(Mixed(), n, "Mixed"), x, 1e-6);
+}
+
+TEST_CASE(NestedTapedEvaluationKeepsOuterTape) {
+    // Вложенная запись длиннее внешней и ей нужен больший буфер аргументов
+    const std::vector<double> p = { 0.5, -1.0, 1.5, 2.0, -0.5, 1.0, 0.25, -2.0 };
+    const auto inner = makeTapedFunction(Nested{ nullptr, {} }, static_cast<int>(p.size()), "Inner");
+    const auto outer = makeTapedFunction(Nested{ &inner, p }, 3, "Outer");
+    const std::vector<double> x = { 1.0, -2.0, 0.5 };
+    const double c = inner(p);
+
+    std::vector<double> grad;
+    const double value = outer.valueAndGradient(x, grad);
+    CHECK_MSG(std::fabs(value - outer(x)) < 1e-12, "value " << value << " vs " << outer(x));
+    for (size_t j = 0; j < x.size(); ++j) {
+        const double expected = 2.0 * x[j] + (j == 0 ? c : 0.0);
+        CHECK_MSG(std::fabs(grad[j] - expected) < 1e-12, "j=" << j << ": " << grad[j] << ", expected " << expected);
+    }
+}
+
+TEST_CASE(TapedConjugateGradientHighDimension) {
+    const int n = 100000;
+    const auto f = makeTapedFunction(Rosenbrock(), n, "Rosenbrock");
+    std::vector<double> x0(n);
+    for (int j = 0; j < n; ++j) x0[j] = (j % 2 == 0) ? -1.2 : 1.0;
+    const std::vector<double> lower(n, -5.0), upper(n, 5.0);
+
+    ConjugateGradientFRConstrained optimizer(&f, std::make_unique<CriterialMaxIter>(nullptr, 40),
+        x0, lower, upper, 1e-6, 100, 1e-8);
+    const AbstrOptim::Result result = optimizer.optimize();
+
+    const double start = f(x0);
+    CHECK_MSG(result.value < 1e-2 * start, "start " << start << " result " << result.value);
+    CHECK(result.gradient_evaluations > 0);
+    CHECK(result.fd_evaluations == 0);
+
+    // Лента доросла до размера одной записи и больше не растёт
+    const size_t capacity = rad::Tape::threadLocal(0).capacity();
+    std::vector<double> grad;
+    f.valueAndGradient(x0, grad);
+    CHECK(rad::Tape::threadLocal(0).capacity() == capacity);
+    CHECK(capacity < 16 * static_cast<size_t>(n));
+}
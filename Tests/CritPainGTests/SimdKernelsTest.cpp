@@ -0,0 +1,396 @@
+﻿// Тесты векторных ядер: каждое ядро запускается на всех уровнях, доступных
+// процессору, на случайных и граничных пакетах с длинами, не кратными 4 и 8,
+// и сравнивается со скалярным кодом (sincos2pi - с std::sin/std::cos).
+// Границы ошибок - из SimdKernels.h.
+
+#include "TestSupport.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using simd::Level;
+
+const double TWO_PI = 6.28318530717958647693;
+
+// Длины пакетов: пустой, короче вектора, хвосты по 1..7 после 4 и 8 точек
+const size_t COUNTS[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 11, 13, 15, 16, 17, 23, 31, 33, 100 };
+const int DIMS[] = { 1, 2, 3, 7 };
+
+// Граничные значения координат для ядер функций
+const double EDGE_VALUES[] = {
+    0.0, -0.0, 1.0, -1.0, 0.5, -0.5, 0.25, -0.25, 2.0, 4.0, -3.0, 1e-300, -1e-300,
+    std::numeric_limits<double>::denorm_min(), 1e-8, 1e8, -1e8, 5.12, -5.12, 1.0 + 1e-15
+};
+
+// Уровни, доступные этому процессору, от скалярного вверх
+std::vector<Level> availableLevels() {
+    std::vector<Level> levels;
+    for (int level = 0; level <= static_cast<int>(simd::detectedLevel()); ++level) {
+        levels.push_back(static_cast<Level>(level));
+    }
+    return levels;
+}
+
+// Выбор уровня на время теста
+class LevelScope {
+public:
+    explicit LevelScope(Level level) : saved(simd::activeLevel()) { simd::setActiveLevel(level); }
+    ~LevelScope() { simd::setActiveLevel(saved); }
+    LevelScope(const LevelScope&) = delete;
+    LevelScope& operator=(const LevelScope&) = delete;
+
+private:
+    Level saved;
+};
+
+int64_t orderedBits(double x) {
+    int64_t bits;
+    std::memcpy(&bits, &x, sizeof bits);
+    return bits < 0 ? -(bits & INT64_MAX) : bits;  // -0 и +0 совпадают
+}
+
+// Расстояние в ULP; NaN совпадает только с NaN
+double ulpDistance(double a, double b) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b) ? 0.0 : std::numeric_limits<double>::infinity();
+    }
+    return std::fabs(static_cast<double>(orderedBits(a) - orderedBits(b)));
+}
+
+// |a - b| в единицах ULP величины scale (для сумм с сокращением, где ULP
+// самого результата ничего не говорит о точности)
+double scaledUlp(double a, double b, double scale) {
+    if (a == b || (std::isnan(a) && std::isnan(b))) {
+        return 0.0;
+    }
+    scale = std::fabs(scale);
+    const double ulp = std::nextafter(scale, std::numeric_limits<double>::infinity()) - scale;
+    return std::fabs(a - b) / ulp;
+}
+
+struct Batch {
+    std::vector<double> points;  // SoA
+    size_t count;
+    int dim;
+};
+
+// Для каждой длины и размерности - случайный пакет и пакет из граничных значений
+void forEachBatch(const std::function<void(const Batch&)>& check) {
+    std::mt19937_64 generator(20240601);
+    std::uniform_real_distribution<double> coordinate(-5.12, 5.12);
+    const size_t edgeCount = sizeof(EDGE_VALUES) / sizeof(EDGE_VALUES[0]);
+    for (size_t count : COUNTS) {
+        for (int dim : DIMS) {
+            Batch batch{ std::vector<double>(count * dim), count, dim };
+            for (double& x : batch.points) {
+                x = coordinate(generator);
+            }
+            check(batch);
+            for (size_t k = 0; k < batch.points.size(); ++k) {
+                batch.points[k] = EDGE_VALUES[(k * 7 + count) % edgeCount];
+            }
+            check(batch);
+        }
+    }
+}
+
+// Ядро kernel(points, count, dim, out) с outputs(batch) результатами на каждом
+// уровне против скалярного: разница не больше maxUlp в ULP от scale(batch, k)
+void checkAgainstScalar(const char* name,
+    const std::function<void(const double*, size_t, int, double*)>& kernel,
+    const std::function<size_t(const Batch&)>& outputs,
+    const std::function<double(const Batch&, size_t)>& scale,
+    double maxUlp) {
+    forEachBatch([&](const Batch& batch) {
+        const size_t n = outputs(batch);
+        std::vector<double> expected(n);
+        {
+            LevelScope scope(Level::Scalar);
+            kernel(batch.points.data(), batch.count, batch.dim, expected.data());
+        }
+        for (Level level : availableLevels()) {
+            LevelScope scope(level);
+            std::vector<double> actual(n + 1, -7.0);  // actual[n] ловит запись за концом
+            kernel(batch.points.data(), batch.count, batch.dim, actual.data());
+            CHECK_MSG(actual[n] == -7.0, name << " at " << simd::levelName(level) << " writes past the end");
+            for (size_t k = 0; k < n; ++k) {
+                const double error = scaledUlp(actual[k], expected[k], scale(batch, k));
+                CHECK_MSG(error <= maxUlp, name << " at " << simd::levelName(level) << ", count " << batch.count
+                    << ", dim " << batch.dim << ", output " << k << ": " << actual[k] << " vs " << expected[k]
+                    << " (" << error << " ULP)");
+            }
+        }
+    });
+}
+
+size_t valueOutputs(const Batch& batch) {
+    return batch.count;
+}
+
+size_t gradientOutputs(const Batch& batch) {
+    return batch.points.size();
+}
+
+double at(const Batch& batch, int j, size_t i) {
+    return batch.points[static_cast<size_t>(j) * batch.count + i];
+}
+
+// Эталон sincos2pi: то же точное сведение к четверти, затем std::sin/std::cos
+void referenceSincos2pi(double x, double& s, double& c) {
+    const double r = x - std::nearbyint(x);
+    const double q = std::nearbyint(4.0 * r);
+    const double t = (r - 0.25 * q) * TWO_PI;
+    const double sv = std::sin(t);
+    const double cv = std::cos(t);
+    switch (static_cast<int>(q) & 3) {
+    case 0: s = sv;  c = cv;  break;
+    case 1: s = cv;  c = -sv; break;
+    case 2: s = -sv; c = -cv; break;
+    default: s = -cv; c = sv; break;
+    }
+}
+
+} // namespace
+
+TEST_CASE(SincosMatchesStdWithinUlpBound) {
+    std::mt19937_64 generator(7);
+    std::vector<double> xs;
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::uniform_real_distribution<double> wide(-1e6, 1e6);
+    for (int k = 0; k < 4000; ++k) {
+        xs.push_back(unit(generator));
+        xs.push_back(wide(generator));
+    }
+    for (int k = -8; k <= 8; ++k) {
+        const double x = k / 8.0;
+        xs.push_back(x);
+        xs.push_back(std::nextafter(x, 1.0));
+        xs.push_back(std::nextafter(x, -1.0));
+    }
+    const double edges[] = { -0.0, 1e-300, std::numeric_limits<double>::denorm_min(), 4503599627370496.0,
+        4503599627370495.5, 9007199254740993.0, 1e300, -1e300, 123456.789, -98765.4321 };
+    xs.insert(xs.end(), std::begin(edges), std::end(edges));
+
+    for (Level level : availableLevels()) {
+        LevelScope scope(level);
+        for (size_t n : COUNTS) {
+            // xs подряд пакетами длины n: граничные значения попадают и в хвосты
+            for (size_t start = 0; n > 0 && start + n <= xs.size(); start += n) {
+                std::vector<double> s(n + 1, -7.0), c(n + 1, -7.0);
+                simd::sincos2pi(xs.data() + start, n, s.data(), c.data());
+                CHECK(s[n] == -7.0 && c[n] == -7.0);
+                for (size_t i = 0; i < n; ++i) {
+                    double rs, rc;
+                    referenceSincos2pi(xs[start + i], rs, rc);
+                    const double error = (std::max)(ulpDistance(s[i], rs), ulpDistance(c[i], rc));
+                    CHECK_MSG(error <= simd::SINCOS_MAX_ULP, simd::levelName(level) << ", x = " << xs[start + i]
+                        << ": sin " << s[i] << " vs " << rs << ", cos " << c[i] << " vs " << rc << " (" << error << " ULP)");
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(SincosExactAtQuarters) {
+    const double xs[] = { 0.0, 0.25, 0.5, 0.75, 1.0, -0.25, -0.5, -0.75, 3.0, -1e9, 1e300 };
+    const double sins[] = { 0.0, 1.0, 0.0, -1.0, 0.0, -1.0, 0.0, 1.0, 0.0, 0.0, 0.0 };
+    const double coss[] = { 1.0, 0.0, -1.0, 0.0, 1.0, 0.0, -1.0, 0.0, 1.0, 1.0, 1.0 };
+    const size_t n = sizeof(xs) / sizeof(xs[0]);
+    for (Level level : availableLevels()) {
+        LevelScope scope(level);
+        double s[n], c[n];
+        simd::sincos2pi(xs, n, s, c);
+        for (size_t i = 0; i < n; ++i) {
+            CHECK_MSG(s[i] == sins[i] && c[i] == coss[i], simd::levelName(level) << ", x = " << xs[i]);
+        }
+    }
+}
+
+TEST_CASE(SumOfSquaresKernelsMatchScalar) {
+    const double center[] = { 0.5, -1.0, 2.0, 0.0, -3.5, 1e-3, 4.0 };
+    checkAgainstScalar("sumOfSquaresBatch",
+        [&](const double* p, size_t n, int d, double* out) { simd::sumOfSquaresBatch(p, n, d, center, out); },
+        valueOutputs,
+        [&](const Batch& b, size_t i) {
+            double sum = 0.0;
+            for (int j = 0; j < b.dim; ++j) sum += (at(b, j, i) - center[j]) * (at(b, j, i) - center[j]);
+            return sum;
+        },
+        simd::KERNEL_MAX_ULP);
+    checkAgainstScalar("sumOfSquaresBatch(origin)",
+        [](const double* p, size_t n, int d, double* out) { simd::sumOfSquaresBatch(p, n, d, nullptr, out); },
+        valueOutputs,
+        [](const Batch& b, size_t i) {
+            double sum = 0.0;
+            for (int j = 0; j < b.dim; ++j) sum += at(b, j, i) * at(b, j, i);
+            return sum;
+        },
+        simd::KERNEL_MAX_ULP);
+    checkAgainstScalar("sumOfSquaresGradientBatch",
+        [&](const double* p, size_t n, int d, double* out) { simd::sumOfSquaresGradientBatch(p, n, d, center, out); },
+        gradientOutputs,
+        [&](const Batch& b, size_t k) { return 2.0 * (std::fabs(b.points[k]) + std::fabs(center[k / (b.count ? b.count : 1)])); },
+        simd::KERNEL_MAX_ULP);
+}
+
+TEST_CASE(RastriginKernelsMatchScalar) {
+    const double A = 10.0;
+    checkAgainstScalar("rastriginBatch",
+        [&](const double* p, size_t n, int d, double* out) { simd::rastriginBatch(p, n, d, A, out); },
+        valueOutputs,
+        [&](const Batch& b, size_t i) {
+            double sum = A * b.dim;
+            for (int j = 0; j < b.dim; ++j) sum += at(b, j, i) * at(b, j, i) + A;
+            return sum;
+        },
+        simd::KERNEL_MAX_ULP);
+    checkAgainstScalar("rastriginGradientBatch",
+        [&](const double* p, size_t n, int d, double* out) { simd::rastriginGradientBatch(p, n, d, A, out); },
+        gradientOutputs,
+        [&](const Batch& b, size_t k) { return 2.0 * std::fabs(b.points[k]) + TWO_PI * A; },
+        simd::KERNEL_MAX_ULP);
+}
+
+TEST_CASE(RosenbrockKernelsMatchScalar) {
+    checkAgainstScalar("rosenbrockBatch",
+        [](const double* p, size_t n, int d, double* out) { simd::rosenbrockBatch(p, n, d, out); },
+        valueOutputs,
+        [](const Batch& b, size_t i) {
+            double sum = 0.0;
+            for (int j = 0; j + 1 < b.dim; ++j) {
+                const double x = at(b, j, i);
+                const double t = std::fabs(at(b, j + 1, i)) + x * x;
+                sum += 100.0 * t * t + (1.0 + std::fabs(x)) * (1.0 + std::fabs(x));
+            }
+            return sum;
+        },
+        simd::KERNEL_MAX_ULP);
+    checkAgainstScalar("rosenbrockGradientBatch",
+        [](const double* p, size_t n, int d, double* out) { simd::rosenbrockGradientBatch(p, n, d, out); },
+        gradientOutputs,
+        [](const Batch& b, size_t k) {
+            const int j = static_cast<int>(k / b.count);
+            const size_t i = k % b.count;
+            const double x = std::fabs(at(b, j, i));
+            double sum = 0.0;
+            if (j + 1 < b.dim) sum += 400.0 * x * (std::fabs(at(b, j + 1, i)) + x * x) + 2.0 * (1.0 + x);
+            if (j > 0) sum += 200.0 * (x + at(b, j - 1, i) * at(b, j - 1, i));
+            return sum;
+        },
+        simd::KERNEL_MAX_ULP);
+}
+
+TEST_CASE(StyblinskiTangKernelsMatchScalar) {
+    checkAgainstScalar("styblinskiTangBatch",
+        [](const double* p, size_t n, int d, double* out) { simd::styblinskiTangBatch(p, n, d, out); },
+        valueOutputs,
+        [](const Batch& b, size_t i) {
+            double sum = 0.0;
+            for (int j = 0; j < b.dim; ++j) {
+                const double x = std::fabs(at(b, j, i));
+                sum += x * x * (x * x + 16.0) + 5.0 * x;
+            }
+            return 0.5 * sum;
+        },
+        simd::KERNEL_MAX_ULP);
+    checkAgainstScalar("styblinskiTangGradientBatch",
+        [](const double* p, size_t n, int d, double* out) { simd::styblinskiTangGradientBatch(p, n, d, out); },
+        gradientOutputs,
+        [](const Batch& b, size_t k) {
+            const double x = std::fabs(b.points[k]);
+            return x * (2.0 * x * x + 16.0) + 2.5;
+        },
+        simd::KERNEL_MAX_ULP);
+}
+
+TEST_CASE(UniformFillIdenticalAcrossLevels) {
+    for (size_t n : COUNTS) {
+        std::vector<double> expected(n);
+        simd::LaneRandom scalarRng;
+        scalarRng.seed(n + 1);
+        {
+            LevelScope scope(Level::Scalar);
+            simd::uniformFill(scalarRng, expected.data(), n);
+            simd::uniformFill(scalarRng, expected.data(), n);  // второй вызов - с продвинутым состоянием
+        }
+        for (Level level : availableLevels()) {
+            LevelScope scope(level);
+            simd::LaneRandom rng;
+            rng.seed(n + 1);
+            std::vector<double> actual(n + 1, -7.0);
+            simd::uniformFill(rng, actual.data(), n);
+            simd::uniformFill(rng, actual.data(), n);
+            CHECK_MSG(actual[n] == -7.0, simd::levelName(level) << " writes past the end");
+            CHECK_MSG(std::equal(expected.begin(), expected.end(), actual.begin()),
+                simd::levelName(level) << ", count " << n);
+            CHECK_MSG(std::memcmp(rng.state, scalarRng.state, sizeof rng.state) == 0,
+                simd::levelName(level) << ", count " << n << ": lane states differ");
+            for (size_t i = 0; i < n; ++i) {
+                CHECK(actual[i] >= 0.0 && actual[i] < 1.0);
+            }
+        }
+    }
+}
+
+TEST_CASE(SwarmUpdateMatchesScalar) {
+    simd::SwarmStep step;
+    step.inertia = 0.72;
+    step.cognitive = 1.49;
+    step.social = 1.49;
+    step.vmax = 2.0;
+    step.lower = -5.0;
+    step.upper = 5.0;
+    const double gbest = 0.75;
+    std::mt19937_64 generator(11);
+    std::uniform_real_distribution<double> position(-5.0, 5.0);
+    std::uniform_real_distribution<double> velocity(-3.0, 3.0);
+    for (size_t n : COUNTS) {
+        std::vector<double> x0(n), v0(n), pbest(n);
+        for (size_t i = 0; i < n; ++i) {
+            x0[i] = position(generator);
+            v0[i] = velocity(generator);
+            pbest[i] = position(generator);
+        }
+        std::vector<double> xs = x0, vs = v0;
+        simd::LaneRandom scalarRng;
+        scalarRng.seed(3);
+        {
+            LevelScope scope(Level::Scalar);
+            simd::swarmUpdate(xs.data(), vs.data(), pbest.data(), gbest, n, step, scalarRng);
+        }
+        for (Level level : availableLevels()) {
+            LevelScope scope(level);
+            std::vector<double> x = x0, v = v0;
+            simd::LaneRandom rng;
+            rng.seed(3);
+            simd::swarmUpdate(x.data(), v.data(), pbest.data(), gbest, n, step, rng);
+            CHECK_MSG(std::memcmp(rng.state, scalarRng.state, sizeof rng.state) == 0,
+                simd::levelName(level) << ", count " << n << ": lane states differ");
+            for (size_t i = 0; i < n; ++i) {
+                const double vscale = step.inertia * std::fabs(v0[i])
+                    + step.cognitive * (std::fabs(pbest[i]) + std::fabs(x0[i]))
+                    + step.social * (std::fabs(gbest) + std::fabs(x0[i]));
+                CHECK_MSG(scaledUlp(v[i], vs[i], vscale) <= simd::KERNEL_MAX_ULP
+                    && scaledUlp(x[i], xs[i], std::fabs(x0[i]) + vscale) <= simd::KERNEL_MAX_ULP,
+                    simd::levelName(level) << ", count " << n << ", particle " << i << ": x " << x[i] << " vs " << xs[i]
+                    << ", v " << v[i] << " vs " << vs[i]);
+                CHECK(x[i] >= step.lower && x[i] <= step.upper && std::fabs(v[i]) <= step.vmax);
+            }
+        }
+    }
+}
+
+TEST_CASE(SimdLevelsReported) {
+    std::cout << "    SIMD levels tested up to " << simd::levelName(simd::detectedLevel()) << std::endl;
+    CHECK(static_cast<int>(simd::activeLevel()) <= static_cast<int>(simd::detectedLevel()));
+}
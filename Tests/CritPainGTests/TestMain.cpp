@@ -0,0 +1,60 @@
+﻿#include "TestSupport.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+std::string directory;
+
+} // namespace
+
+bool registerTest(const char* name, void (*run)()) {
+    registry().push_back({ name, run });
+    return true;
+}
+
+std::string testLocation(const char* file, int line) {
+    return std::string(file) + "(" + std::to_string(line) + "): ";
+}
+
+const std::string& testDirectory() {
+    return directory;
+}
+
+// Без аргументов - все тесты, иначе только названные
+int main(int argc, char** argv) {
+    const std::string self = argc > 0 ? argv[0] : "";
+    const size_t slash = self.find_last_of("/\\");
+    directory = slash == std::string::npos ? "./" : self.substr(0, slash + 1);
+
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& test : registry()) {
+        if (argc > 1 && std::find(argv + 1, argv + argc, std::string(test.name)) == argv + argc) {
+            continue;
+        }
+        ++run;
+        try {
+            test.run();
+            std::cout << "[  OK  ] " << test.name << std::endl;
+        }
+        catch (const std::exception& e) {
+            ++failed;
+            std::cout << "[ FAIL ] " << test.name << ": " << e.what() << std::endl;
+        }
+    }
+    std::cout << (run - failed) << " of " << run << " tests passed" << std::endl;
+    return failed;
+}
@@ -0,0 +1,51 @@
+﻿#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Минимальная обвязка тестов: TEST_CASE регистрирует тест, CHECK и CHECK_THROWS
+// при нарушении бросают TestFailure с местом проверки. TestMain.cpp запускает
+// тесты (все или перечисленные в аргументах) и возвращает число упавших.
+
+struct TestFailure : std::runtime_error {
+    explicit TestFailure(const std::string& message) : std::runtime_error(message) {}
+};
+
+bool registerTest(const char* name, void (*run)());
+std::string testLocation(const char* file, int line);
+// Каталог исполняемого файла тестов, с разделителем в конце
+const std::string& testDirectory();
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const bool name##Registered = registerTest(#name, &name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) \
+            throw TestFailure(testLocation(__FILE__, __LINE__) + "CHECK(" #condition ") failed"); \
+    } while (0)
+
+// details - выражение для потока, например "i = " << i
+#define CHECK_MSG(condition, details) \
+    do { \
+        if (!(condition)) { \
+            std::ostringstream testMessage; \
+            testMessage << testLocation(__FILE__, __LINE__) << "CHECK(" #condition ") failed: " << details; \
+            throw TestFailure(testMessage.str()); \
+        } \
+    } while (0)
+
+#define CHECK_THROWS(expression, exception) \
+    do { \
+        bool testThrown = false; \
+        try { expression; } \
+        catch (const exception&) { testThrown = true; } \
+        if (!testThrown) \
+            throw TestFailure(testLocation(__FILE__, __LINE__) + #expression " did not throw " #exception); \
+    } while (0)
+
+#endif
@@ -0,0 +1,38 @@
+﻿// Вычислитель-заглушка для ProcessFunc: функция Розенброка через
+// serveProcessWorker. Размерность - первый аргумент (по умолчанию 4).
+// Используется тестами ProcessFunc (CritPainGTests) и как образец своего
+// вычислителя.
+
+#include "RosenbrockWorker.h"
+#include "ProcessWorker.h"
+#include "TestFunctions.h"
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+// Точки с особым x_0 (RosenbrockWorker.h) дают ошибку или обрывают процесс
+class StubRosenbrock : public RosenbrockFuncND {
+public:
+    explicit StubRosenbrock(int dim) : RosenbrockFuncND(dim) {}
+
+    void evaluateBatch(const double* points, size_t count, double* values) const override {
+        for (size_t i = 0; i < count; ++i) {
+            if (points[i] == STUB_EXIT_VALUE) {
+                std::_Exit(3);  // как падение процесса: без ответа и без очистки
+            }
+            if (points[i] == STUB_FAIL_VALUE) {
+                throw std::runtime_error("stub worker: requested failure");
+            }
+        }
+        RosenbrockFuncND::evaluateBatch(points, count, values);
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int dimension = argc > 1 ? std::atoi(argv[1]) : 4;
+    StubRosenbrock f(dimension >= 2 ? dimension : 4);
+    return serveProcessWorker(f);
+}
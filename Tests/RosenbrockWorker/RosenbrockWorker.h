@@ -0,0 +1,9 @@
+﻿#ifndef ROSENBROCKWORKER_H
+#define ROSENBROCKWORKER_H
+
+// Особые значения x_0 для вычислителя-заглушки RosenbrockWorker: запрос с такой
+// точкой имитирует отказ вычислителя
+const double STUB_FAIL_VALUE = 1e300;   // ошибка запроса, процесс продолжает работу
+const double STUB_EXIT_VALUE = -1e300;  // аварийный выход процесса
+
+#endif